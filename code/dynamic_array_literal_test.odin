@@ -0,0 +1,20 @@
+// NOTE: Building this used to crash the compiler. The name of the global which backs a
+// dynamic array literal did not fit in the buffer it was formatted into.
+#import "fmt.odin";
+
+sum :: proc(xs: [dynamic]int) -> int {
+	total := 0;
+	for x in xs {
+		total += x;
+	}
+	return total;
+}
+
+main :: proc() {
+	x := [dynamic]int{1, 2, 3};
+	y := [dynamic]f32{0.5, 1.5};
+	names := [dynamic]string{"a", "b", "c", "d"};
+
+	fmt.println(sum(x), len(y), len(names));
+	fmt.println(sum([dynamic]int{4, 5, 6}));
+}
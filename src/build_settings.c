@@ -15,6 +15,13 @@ typedef struct BuildContext {
 	String llc_flags;
 	String link_flags;
 	bool   is_dll;
+
+	isize  thread_count;   // Number of worker threads for the parallel stages
+	bool   parallel_check; // Check procedure bodies on `thread_count` workers
+
+	bool   show_timings;
+	bool   show_memory;
+	bool   emit_llvm_text; // Print the LLVM IR as text for opt rather than writing bitcode
 } BuildContext;
 
 
@@ -141,6 +148,8 @@ String odin_root_dir(void) {
 
 #if defined(GB_SYSTEM_WINDOWS)
 String path_to_fullpath(gbAllocator a, String s) {
+	// NOTE: The parser calls this from multiple threads
+	gb_mutex_lock(&string_buffer_mutex);
 	gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&string_buffer_arena);
 	String16 string16 = string_to_string16(string_buffer_allocator, s);
 	String result = {0};
@@ -153,6 +162,7 @@ String path_to_fullpath(gbAllocator a, String s) {
 		result = string16_to_string(a, make_string16(text, len));
 	}
 	gb_temp_arena_memory_end(tmp);
+	gb_mutex_unlock(&string_buffer_mutex);
 	return result;
 }
 #elif defined(GB_SYSTEM_OSX) || defined(GB_SYSTEM_UNIX)
@@ -235,4 +245,11 @@ void init_build_context(void) {
 		bc->llc_flags = str_lit("-march=x86 ");
 		bc->link_flags = str_lit("/machine:x86 ");
 	}
+
+	{
+		gbAffinity affinity = {0};
+		gb_affinity_init(&affinity);
+		bc->thread_count = gb_max(affinity.thread_count, 1);
+		gb_affinity_destroy(&affinity);
+	}
 }
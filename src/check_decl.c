@@ -142,6 +142,25 @@ void check_type_decl(Checker *c, Entity *e, AstNode *type_expr, Type *def) {
 	if (named->Named.base == t_invalid) {
 		// gb_printf("check_type_decl: %s\n", type_to_string(named));
 	}
+
+	// NOTE: Set here rather than by the `using` statements of procedure bodies, as they may be checked
+	// in parallel. The first declaration of the type is reported for a collision through `using`
+	bt = named->Named.base;
+	if (is_type_union(bt)) {
+		for (isize i = 1; i < bt->Record.variant_count; i++) {
+			Entity *f = bt->Record.variants[i];
+			if (f->using_parent == NULL) {
+				f->using_parent = e;
+			}
+		}
+	} else if (is_type_enum(bt)) {
+		for (isize i = 0; i < bt->Record.field_count; i++) {
+			Entity *f = bt->Record.fields[i];
+			if (f->using_parent == NULL) {
+				f->using_parent = e;
+			}
+		}
+	}
 }
 
 void check_const_decl(Checker *c, Entity *e, AstNode *type_expr, AstNode *init, Type *named_type) {
@@ -284,7 +303,6 @@ void check_proc_lit(Checker *c, Entity *e, DeclInfo *d) {
 	}
 
 	if (is_foreign) {
-		MapEntity *fp = &c->info.foreigns;
 		String name = e->token.string;
 		if (pd->foreign_name.len > 0) {
 			name = pd->foreign_name;
@@ -316,6 +334,8 @@ void check_proc_lit(Checker *c, Entity *e, DeclInfo *d) {
 		e->Procedure.is_foreign = true;
 		e->Procedure.foreign_name = name;
 
+		Checker *sc = lock_shared_checker(c);
+		MapEntity *fp = &sc->info.foreigns;
 		HashKey key = hash_string(name);
 		Entity **found = map_entity_get(fp, key);
 		if (found) {
@@ -327,11 +347,12 @@ void check_proc_lit(Checker *c, Entity *e, DeclInfo *d) {
 				error_node(d->proc_lit,
 				           "Redeclaration of #foreign procedure `%.*s` with different type signatures\n"
 				           "\tat %.*s(%td:%td)",
-				           LIT(name), LIT(pos.file), pos.line, pos.column);
+				           LIT(name), LIT(token_pos_file(pos)), token_pos_line(pos), token_pos_column(pos));
 			}
 		} else {
 			map_entity_set(fp, key, e);
 		}
+		unlock_shared_checker(sc);
 	} else {
 		String name = e->token.string;
 		if (is_link_name) {
@@ -339,10 +360,10 @@ void check_proc_lit(Checker *c, Entity *e, DeclInfo *d) {
 		}
 
 		if (is_link_name || is_export) {
-			MapEntity *fp = &c->info.foreigns;
-
 			e->Procedure.link_name = name;
 
+			Checker *sc = lock_shared_checker(c);
+			MapEntity *fp = &sc->info.foreigns;
 			HashKey key = hash_string(name);
 			Entity **found = map_entity_get(fp, key);
 			if (found) {
@@ -352,10 +373,11 @@ void check_proc_lit(Checker *c, Entity *e, DeclInfo *d) {
 				error_node(d->proc_lit,
 				           "Non unique linking name for procedure `%.*s`\n"
 				           "\tother at %.*s(%td:%td)",
-				           LIT(name), LIT(pos.file), pos.line, pos.column);
+				           LIT(name), LIT(token_pos_file(pos)), token_pos_line(pos), token_pos_column(pos));
 			} else {
 				map_entity_set(fp, key, e);
 			}
+			unlock_shared_checker(sc);
 		}
 	}
 
@@ -459,10 +481,8 @@ void check_entity_decl(Checker *c, Entity *e, DeclInfo *d, Type *named_type) {
 	}
 
 	if (d == NULL) {
-		DeclInfo **found = map_decl_info_get(&c->info.entities, hash_pointer(e));
-		if (found) {
-			d = *found;
-		} else {
+		d = decl_info_of_entity(c, e);
+		if (d == NULL) {
 			// TODO(bill): Err here?
 			e->type = t_invalid;
 			set_base_type(named_type, t_invalid);
@@ -528,10 +548,10 @@ void check_proc_body(Checker *c, Token token, DeclInfo *decl, Type *type, AstNod
 			String name = e->token.string;
 			Type *t = base_type(type_deref(e->type));
 			if (is_type_struct(t) || is_type_raw_union(t)) {
-				Scope **found = map_scope_get(&c->info.scopes, hash_pointer(t->Record.node));
+				Scope *found = scope_of_node(&c->info, t->Record.node);
 				GB_ASSERT(found != NULL);
-				for_array(i, (*found)->elements.entries) {
-					Entity *f = (*found)->elements.entries.e[i].value;
+				for_array(i, found->elements.entries) {
+					Entity *f = found->elements.entries.e[i].value;
 					if (f->kind == Entity_Variable) {
 						Entity *uvar = make_entity_using_variable(c->allocator, e, f->token, f->type);
 						uvar->Variable.is_immutable = is_immutable;
@@ -62,9 +62,8 @@ void check_scope_decls(Checker *c, AstNodeArray nodes, isize reserve_size) {
 		default:
 			continue;
 		}
-		DeclInfo **found = map_decl_info_get(&c->info.entities, hash_pointer(e));
-		if (found != NULL) {
-			DeclInfo *d = *found;
+		DeclInfo *d = decl_info_of_entity(c, e);
+		if (d != NULL) {
 			check_entity_decl(c, e, d, NULL);
 		}
 	}
@@ -440,7 +439,7 @@ isize check_fields(Checker *c, AstNode *node, AstNodeArray decls,
 
 // TODO(bill): Cleanup struct field reordering
 // TODO(bill): Inline sorting procedure?
-gb_global gbAllocator   __checker_allocator = {0};
+gb_global gb_thread_local gbAllocator __checker_allocator = {0};
 
 GB_COMPARE_PROC(cmp_struct_entity_size) {
 	// Rule:
@@ -522,6 +521,7 @@ void check_struct_type(Checker *c, Type *struct_type, AstNode *node) {
 		struct_type->Record.fields = reordered_fields;
 	}
 
+	record_field_index_build(struct_type);
 	type_set_offsets(c->allocator, struct_type);
 
 	if (st->align != NULL) {
@@ -595,6 +595,7 @@ void check_union_type(Checker *c, Type *union_type, AstNode *node) {
 
 	union_type->Record.fields      = fields;
 	union_type->Record.field_count = field_count;
+	record_field_index_build(union_type);
 
 	for_array(i, ut->variants) {
 		AstNode *variant = ut->variants.e[i];
@@ -623,7 +624,11 @@ void check_union_type(Checker *c, Type *union_type, AstNode *node) {
 
 			Token token = name_token;
 			token.kind = Token_struct;
-			AstNode *dummy_struct = ast_struct_type(c->curr_ast_file, token, list, list_count, false, true, NULL);
+			AstNode *dummy_struct = alloc_ast_node(c->allocator, AstNode_StructType);
+			dummy_struct->StructType.token       = token;
+			dummy_struct->StructType.fields      = list;
+			dummy_struct->StructType.field_count = list_count;
+			dummy_struct->StructType.is_ordered  = true;
 
 			check_open_scope(c, dummy_struct);
 			Entity **fields = gb_alloc_array(c->allocator, Entity *, list_count);
@@ -636,6 +641,7 @@ void check_union_type(Checker *c, Type *union_type, AstNode *node) {
 			base_type->Record.names = make_names_field_for_record(c, c->context.scope);
 			base_type->Record.node = dummy_struct;
 
+			record_field_index_build(base_type);
 			type_set_offsets(c->allocator, base_type);
 
 			check_close_scope(c);
@@ -690,6 +696,7 @@ void check_raw_union_type(Checker *c, Type *union_type, AstNode *node) {
 	union_type->Record.fields = fields;
 	union_type->Record.field_count = field_count;
 	union_type->Record.names = make_names_field_for_record(c, c->context.scope);
+	record_field_index_build(union_type);
 }
 
 // GB_COMPARE_PROC(cmp_enum_order) {
@@ -1108,7 +1115,7 @@ Entity *check_ident(Checker *c, Operand *o, AstNode *n, Type *named_type, Type *
 		// return NULL;
 	}
 
-	e->flags |= EntityFlag_Used;
+	add_entity_flag_used(c, e);
 
 	Entity *original_e = e;
 	while (e != NULL && e->kind == Entity_Alias && e->Alias.original != NULL) {
@@ -1130,7 +1137,7 @@ Entity *check_ident(Checker *c, Operand *o, AstNode *n, Type *named_type, Type *
 		break;
 
 	case Entity_Variable:
-		e->flags |= EntityFlag_Used;
+		add_entity_flag_used(c, e);
 		if (type == t_invalid) {
 			o->type = t_invalid;
 			return e;
@@ -1285,8 +1292,7 @@ void check_map_type(Checker *c, Type *type, AstNode *node) {
 			value: Value_Type,
 		}
 		*/
-		AstNode *dummy_node = gb_alloc_item(a, AstNode);
-		dummy_node->kind = AstNode_Invalid;
+		AstNode *dummy_node = alloc_ast_node(a, AstNode_Invalid);
 		check_open_scope(c, dummy_node);
 
 		isize field_count = 3;
@@ -1314,8 +1320,7 @@ void check_map_type(Checker *c, Type *type, AstNode *node) {
 			entries; [dynamic]Entry_Type,
 		}
 		*/
-		AstNode *dummy_node = gb_alloc_item(a, AstNode);
-		dummy_node->kind = AstNode_Invalid;
+		AstNode *dummy_node = alloc_ast_node(a, AstNode_Invalid);
 		check_open_scope(c, dummy_node);
 
 		Type *hashes_type  = make_type_dynamic_array(a, t_int);
@@ -1992,8 +1997,8 @@ void check_comparison(Checker *c, Operand *x, Operand *y, TokenKind op) {
 			if (x->type == err_type && is_operand_nil(*x)) {
 				err_type = y->type;
 			}
-			gb_printf_err("%d %d\n", is_operand_nil(*x), type_has_nil(y->type));
-			gb_printf_err("%d %d\n", is_operand_nil(*y), type_has_nil(x->type));
+			report_error_raw("%d %d\n", is_operand_nil(*x), type_has_nil(y->type));
+			report_error_raw("%d %d\n", is_operand_nil(*y), type_has_nil(x->type));
 			gbString type_string = type_to_string(err_type);
 			err_str = gb_string_make(c->tmp_allocator,
 			                         gb_bprintf("operator `%.*s` not defined for type `%s`", LIT(token_strings[op]), type_string));
@@ -4364,7 +4369,7 @@ CallArgumentError check_call_arguments_internal(Checker *c, AstNode *call, Type
 	ast_node(ce, CallExpr, call);
 	isize param_count = 0;
 	bool variadic = proc_type->Proc.variadic;
-	bool vari_expand = (ce->ellipsis.pos.line != 0);
+	bool vari_expand = token_pos_is_valid(ce->ellipsis.pos);
 	i64 score = 0;
 
 	if (proc_type->Proc.params != NULL) {
@@ -4516,6 +4521,122 @@ bool check_unpack_arguments(Checker *c, isize lhs_count, ArrayOperand *operands,
 	return optional_ok;
 }
 
+
+// NOTE: Returns false if the overload chosen for these arguments cannot be cached
+bool overload_cache_arg_of(Operand *o, OverloadCacheArg *arg) {
+	if (o->mode == Addressing_Invalid || o->type == NULL || o->type == t_invalid) {
+		return false;
+	}
+	gb_zero_item(arg);
+	arg->type = o->type;
+	arg->mode = o->mode;
+	if (o->mode == Addressing_Constant && is_type_untyped(o->type)) {
+		switch (o->value.kind) {
+		case ExactValue_Compound:
+			return false;
+		case ExactValue_Bool:       arg->value.value_bool       = o->value.value_bool;       break;
+		case ExactValue_String:     arg->value.value_string     = o->value.value_string;     break;
+		case ExactValue_Integer:    arg->value.value_integer    = o->value.value_integer;    break;
+		case ExactValue_Float:      arg->value.value_float      = o->value.value_float;      break;
+		case ExactValue_Pointer:    arg->value.value_pointer    = o->value.value_pointer;    break;
+		case ExactValue_Complex:    arg->value.value_complex    = o->value.value_complex;    break;
+		case ExactValue_Quaternion: arg->value.value_quaternion = o->value.value_quaternion; break;
+		default: break;
+		}
+		arg->value.kind = o->value.kind;
+	}
+	return true;
+}
+
+bool overload_cache_arg_eq(OverloadCacheArg *x, OverloadCacheArg *y) {
+	if (x->type != y->type || x->mode != y->mode || x->value.kind != y->value.kind) {
+		return false;
+	}
+	if (x->value.kind == ExactValue_String) {
+		return str_eq(x->value.value_string, y->value.value_string);
+	}
+	// NOTE: The unused bytes of the value were zeroed in `overload_cache_arg_of`
+	return gb_memcompare(&x->value, &y->value, gb_size_of(ExactValue)) == 0;
+}
+
+u64 overload_cache_hash(Entity **procs, isize proc_count, OverloadCacheArg *args, isize arg_count, bool vari_expand) {
+	u64 h = type_hash_combine(0xcbf29ce484222325ull, cast(u64)vari_expand);
+	for (isize i = 0; i < proc_count; i++) {
+		h = type_hash_combine(h, cast(u64)cast(uintptr)procs[i]);
+	}
+	for (isize i = 0; i < arg_count; i++) {
+		OverloadCacheArg *a = &args[i];
+		h = type_hash_combine(h, cast(u64)cast(uintptr)a->type);
+		h = type_hash_combine(h, cast(u64)a->mode);
+		if (a->value.kind == ExactValue_String) {
+			h = type_hash_combine(h, gb_fnv64a(a->value.value_string.text, a->value.value_string.len));
+		} else if (a->value.kind != ExactValue_Invalid) {
+			h = type_hash_combine(h, gb_fnv64a(&a->value, gb_size_of(ExactValue)));
+		}
+	}
+	return h;
+}
+
+HashKey overload_cache_key(u64 hash) {
+	HashKey key = {HashKey_Default};
+	key.key = hash;
+	return key;
+}
+
+// NOTE: Returns the index into `procs` or -1 if it has not been resolved before
+isize overload_cache_get(Checker *c, u64 hash, Entity **procs, isize proc_count, OverloadCacheArg *args, isize arg_count, bool vari_expand) {
+	isize chosen = -1;
+	Checker *sc = lock_shared_checker(c);
+	OverloadCacheEntry **found = map_overload_cache_get(&sc->overload_cache.entries, overload_cache_key(hash));
+	for (OverloadCacheEntry *e = found != NULL ? *found : NULL; e != NULL; e = e->next) {
+		if (e->proc_count != proc_count || e->arg_count != arg_count || e->vari_expand != vari_expand) {
+			continue;
+		}
+		if (gb_memcompare(e->procs, procs, gb_size_of(Entity *)*proc_count) != 0) {
+			continue;
+		}
+		bool same_args = true;
+		for (isize i = 0; i < arg_count; i++) {
+			if (!overload_cache_arg_eq(&e->args[i], &args[i])) {
+				same_args = false;
+				break;
+			}
+		}
+		if (same_args) {
+			chosen = e->chosen;
+			break;
+		}
+	}
+	if (chosen >= 0) {
+		sc->overload_cache.hits++;
+	} else {
+		sc->overload_cache.misses++;
+	}
+	unlock_shared_checker(sc);
+	return chosen;
+}
+
+void overload_cache_set(Checker *c, u64 hash, Entity **procs, isize proc_count, OverloadCacheArg *args, isize arg_count, bool vari_expand, isize chosen) {
+	// NOTE: One allocation for the entry and the keys it is compared with
+	isize size = gb_size_of(OverloadCacheEntry) + gb_size_of(Entity *)*proc_count + gb_size_of(OverloadCacheArg)*arg_count;
+	OverloadCacheEntry *e = cast(OverloadCacheEntry *)gb_alloc(heap_allocator(), size);
+	e->procs       = cast(Entity **)(e+1);
+	e->proc_count  = proc_count;
+	e->args        = cast(OverloadCacheArg *)(e->procs+proc_count);
+	e->arg_count   = arg_count;
+	e->vari_expand = vari_expand;
+	e->chosen      = chosen;
+	gb_memcopy(e->procs, procs, gb_size_of(Entity *)*proc_count);
+	gb_memcopy(e->args,  args,  gb_size_of(OverloadCacheArg)*arg_count);
+
+	Checker *sc = lock_shared_checker(c);
+	HashKey key = overload_cache_key(hash);
+	OverloadCacheEntry **found = map_overload_cache_get(&sc->overload_cache.entries, key);
+	e->next = found != NULL ? *found : NULL;
+	map_overload_cache_set(&sc->overload_cache.entries, key, e);
+	unlock_shared_checker(sc);
+}
+
 Type *check_call_arguments(Checker *c, Operand *operand, Type *proc_type, AstNode *call) {
 	GB_ASSERT(call->kind == AstNode_CallExpr);
 
@@ -4531,20 +4652,56 @@ Type *check_call_arguments(Checker *c, Operand *operand, Type *proc_type, AstNod
 
 		isize              overload_count = operand->overload_count;
 		Entity **          procs          = operand->overload_entities;
-		ValidProcAndScore *valids         = gb_alloc_array(heap_allocator(), ValidProcAndScore, overload_count);
+		ValidProcAndScore  valids_buffer[16];
+		ValidProcAndScore *valids         = valids_buffer;
 		isize              valid_count    = 0;
+		if (overload_count > gb_count_of(valids_buffer)) {
+			valids = gb_alloc_array(heap_allocator(), ValidProcAndScore, overload_count);
+		}
 
 		String name = procs[0]->token.string;
+		bool vari_expand = token_pos_is_valid(ce->ellipsis.pos);
+
+		// NOTE: The same overloads are often called with the same kinds of arguments
+		// (e.g. `fmt.println` or the `math` procedures) so the scoring is only done once for each
+		OverloadCacheArg  cache_args_buffer[8];
+		OverloadCacheArg *cache_args = cache_args_buffer;
+		if (operands.count > gb_count_of(cache_args_buffer)) {
+			cache_args = gb_alloc_array(heap_allocator(), OverloadCacheArg, operands.count);
+		}
+		bool  cacheable  = true;
+		u64   cache_hash = 0;
+		isize cached     = -1;
+		for_array(i, operands) {
+			if (!overload_cache_arg_of(&operands.e[i], &cache_args[i])) {
+				cacheable = false;
+				break;
+			}
+		}
+		if (cacheable) {
+			cache_hash = overload_cache_hash(procs, overload_count, cache_args, operands.count, vari_expand);
+			cached = overload_cache_get(c, cache_hash, procs, overload_count, cache_args, operands.count, vari_expand);
+		} else {
+			Checker *sc = lock_shared_checker(c);
+			sc->overload_cache.misses++;
+			unlock_shared_checker(sc);
+		}
 
-		for (isize i = 0; i < overload_count; i++) {
-			Entity *e = procs[i];
-			DeclInfo **found = map_decl_info_get(&c->info.entities, hash_pointer(e));
-			GB_ASSERT(found != NULL);
-			DeclInfo *d = *found;
-			check_entity_decl(c, e, d, NULL);
+		if (cached >= 0) {
+			// NOTE: Every overload was checked when this was first resolved
+			valids[0].index = cached;
+			valids[0].score = 0;
+			valid_count = 1;
+		} else {
+			for (isize i = 0; i < overload_count; i++) {
+				Entity *e = procs[i];
+				DeclInfo *d = decl_info_of_entity(c, e);
+				GB_ASSERT(d != NULL);
+				check_entity_decl(c, e, d, NULL);
+			}
 		}
 
-		for (isize i = 0; i < overload_count; i++) {
+		for (isize i = 0; cached < 0 && i < overload_count; i++) {
 			Entity *p = procs[i];
 			Type *proc_type = base_type(p->type);
 			if (proc_type != NULL && is_type_proc(proc_type)) {
@@ -4558,7 +4715,7 @@ Type *check_call_arguments(Checker *c, Operand *operand, Type *proc_type, AstNod
 			}
 		}
 
-		if (valid_count > 1) {
+		if (cached < 0 && valid_count > 1) {
 			gb_sort_array(valids, valid_count, valid_proc_and_score_cmp);
 			i64 best_score = valids[0].score;
 			for (isize i = 0; i < valid_count; i++) {
@@ -4580,7 +4737,7 @@ Type *check_call_arguments(Checker *c, Operand *operand, Type *proc_type, AstNod
 				Entity *proc = procs[valids[i].index];
 				TokenPos pos = proc->token.pos;
 				gbString pt = type_to_string(proc->type);
-				gb_printf_err("\t%.*s :: %s at %.*s(%td:%td)\n", LIT(name), pt, LIT(pos.file), pos.line, pos.column);
+				report_error_raw("\t%.*s :: %s at %.*s(%td:%td)\n", LIT(name), pt, LIT(token_pos_file(pos)), token_pos_line(pos), token_pos_column(pos));
 				gb_string_free(pt);
 			}
 			proc_type = t_invalid;
@@ -4595,10 +4752,19 @@ Type *check_call_arguments(Checker *c, Operand *operand, Type *proc_type, AstNod
 			proc_type = e->type;
 			i64 score = 0;
 			CallArgumentError err = check_call_arguments_internal(c, call, proc_type, operands.e, operands.count, true, &score);
+			if (cacheable && cached < 0 && err == CallArgumentError_None) {
+				overload_cache_set(c, cache_hash, procs, overload_count, cache_args, operands.count, vari_expand, valids[0].index);
+			}
 		}
 
-		gb_free(heap_allocator(), valids);
+		if (cache_args != cache_args_buffer) {
+			gb_free(heap_allocator(), cache_args);
+		}
+		if (valids != valids_buffer) {
+			gb_free(heap_allocator(), valids);
+		}
 		gb_free(heap_allocator(), procs);
+		array_free(&operands);
 	} else {
 		i64 score = 0;
 		CallArgumentError err = check_call_arguments_internal(c, call, proc_type, operands.e, operands.count, true, &score);
@@ -4884,10 +5050,10 @@ ExprKind check_expr_base_internal(Checker *c, Operand *o, AstNode *node, Type *t
 	case_ast_node(bd, BasicDirective, node);
 		if (str_eq(bd->name, str_lit("file"))) {
 			o->type = t_untyped_string;
-			o->value = exact_value_string(bd->token.pos.file);
+			o->value = exact_value_string(token_pos_file(bd->token.pos));
 		} else if (str_eq(bd->name, str_lit("line"))) {
 			o->type = t_untyped_integer;
-			o->value = exact_value_integer(bd->token.pos.line);
+			o->value = exact_value_integer(token_pos_line(bd->token.pos));
 		} else if (str_eq(bd->name, str_lit("procedure"))) {
 			if (c->proc_stack.count == 0) {
 				error_node(node, "#procedure may only be used within procedures");
@@ -5000,7 +5166,10 @@ ExprKind check_expr_base_internal(Checker *c, Operand *o, AstNode *node, Type *t
 				AstNode *count = cl->type->ArrayType.count;
 				if (count->kind == AstNode_UnaryExpr &&
 				    count->UnaryExpr.op.kind == Token_Ellipsis) {
-					type = make_type_array(c->allocator, check_type(c, cl->type->ArrayType.elem), -1);
+					// NOTE: Not interned as the count is set once the elements have been checked
+					type = alloc_type(c->allocator, Type_Array);
+					type->Array.elem  = check_type(c, cl->type->ArrayType.elem);
+					type->Array.count = -1;
 					is_to_be_determined_array_count = true;
 				}
 			}
@@ -5067,15 +5236,15 @@ ExprKind check_expr_base_internal(Checker *c, Operand *o, AstNode *node, Type *t
 							continue;
 						}
 
-						Entity *field = t->Record.fields[sel.index.e[0]];
+						Entity *field = t->Record.fields[selection_index(&sel, 0)];
 						add_entity_use(c, fv->field, field);
 
-						if (fields_visited[sel.index.e[0]]) {
+						if (fields_visited[selection_index(&sel, 0)]) {
 							error_node(elem, "Duplicate field `%.*s` in structure literal", LIT(name));
 							continue;
 						}
 
-						fields_visited[sel.index.e[0]] = true;
+						fields_visited[selection_index(&sel, 0)] = true;
 						check_expr(c, o, fv->value);
 
 						if (base_type(field->type) == t_any) {
@@ -5235,7 +5404,7 @@ ExprKind check_expr_base_internal(Checker *c, Operand *o, AstNode *node, Type *t
 							continue;
 						}
 
-						isize index = sel.index.e[0];
+						isize index = selection_index(&sel, 0);
 
 						if (fields_visited[index]) {
 							error_node(elem, "Duplicate field `%.*s` in `any` literal", LIT(name));
@@ -248,7 +248,7 @@ Type *check_assignment_variable(Checker *c, Operand *rhs, AstNode *lhs_node) {
 	}
 
 	if (e != NULL && used) {
-		e->flags |= EntityFlag_Used;
+		add_entity_flag_used(c, e);
 	}
 
 	Type *assignment_type = lhs.type;
@@ -491,14 +491,12 @@ void check_stmt_internal(Checker *c, AstNode *node, u32 flags) {
 			return;
 		}
 		AstNode *left = s->expr;
-		AstNode *right = gb_alloc_item(c->allocator, AstNode);
-		right->kind = AstNode_BasicLit;
+		AstNode *right = alloc_ast_node(c->allocator, AstNode_BasicLit);
 		right->BasicLit.pos = s->op.pos;
 		right->BasicLit.kind = Token_Integer;
 		right->BasicLit.string = str_lit("1");
 
-		AstNode *be = gb_alloc_item(c->allocator, AstNode);
-		be->kind = AstNode_BinaryExpr;
+		AstNode *be = alloc_ast_node(c->allocator, AstNode_BinaryExpr);
 		be->BinaryExpr.op = s->op;
 		be->BinaryExpr.op.kind = op;
 		be->BinaryExpr.left = left;
@@ -559,15 +557,15 @@ void check_stmt_internal(Checker *c, AstNode *node, u32 flags) {
 				return;
 			}
 			Operand operand = {Addressing_Invalid};
-			AstNode binary_expr = {AstNode_BinaryExpr};
-			ast_node(be, BinaryExpr, &binary_expr);
+			AstNode *binary_expr = alloc_ast_node(c->allocator, AstNode_BinaryExpr);
+			ast_node(be, BinaryExpr, binary_expr);
 			be->op = op;
 			be->op.kind = cast(TokenKind)(cast(i32)be->op.kind - (Token_AddEq - Token_Add));
 			 // NOTE(bill): Only use the first one will be used
 			be->left  = as->lhs.e[0];
 			be->right = as->rhs.e[0];
 
-			check_binary_expr(c, &operand, &binary_expr);
+			check_binary_expr(c, &operand, binary_expr);
 			if (operand.mode == Addressing_Invalid) {
 				return;
 			}
@@ -852,7 +850,7 @@ void check_stmt_internal(Checker *c, AstNode *node, u32 flags) {
 					error(token,
 					      "Redeclaration of `%.*s` in this scope\n"
 					      "\tat %.*s(%td:%td)",
-					      LIT(str), LIT(pos.file), pos.line, pos.column);
+					      LIT(str), LIT(token_pos_file(pos)), token_pos_line(pos), token_pos_column(pos));
 					entity = found;
 				}
 			} else {
@@ -901,7 +899,8 @@ void check_stmt_internal(Checker *c, AstNode *node, u32 flags) {
 			Token token  = {0};
 			token.pos    = ast_node_token(ms->body).pos;
 			token.string = str_lit("true");
-			x.expr       = ast_ident(c->curr_ast_file, token);
+			x.expr       = alloc_ast_node(c->allocator, AstNode_Ident);
+			x.expr->Ident = token;
 		}
 
 		// NOTE(bill): Check for multiple defaults
@@ -925,7 +924,7 @@ void check_stmt_internal(Checker *c, AstNode *node, u32 flags) {
 					error_node(stmt,
 					           "multiple `default` clauses\n"
 					           "\tfirst at %.*s(%td:%td)",
-					           LIT(pos.file), pos.line, pos.column);
+					           LIT(token_pos_file(pos)), token_pos_line(pos), token_pos_column(pos));
 				} else {
 					first_default = default_stmt;
 				}
@@ -989,7 +988,7 @@ void check_stmt_internal(Checker *c, AstNode *node, u32 flags) {
 								           "Duplicate case `%s`\n"
 								           "\tprevious case at %.*s(%td:%td)",
 								           expr_str,
-								           LIT(pos.file), pos.line, pos.column);
+								           LIT(token_pos_file(pos)), token_pos_line(pos), token_pos_column(pos));
 								gb_string_free(expr_str);
 								continue_outer = true;
 								break;
@@ -1078,7 +1077,7 @@ void check_stmt_internal(Checker *c, AstNode *node, u32 flags) {
 					TokenPos pos = ast_node_token(first_default).pos;
 					error_node(stmt,
 					           "Multiple `default` clauses\n"
-					           "\tfirst at %.*s(%td:%td)", LIT(pos.file), pos.line, pos.column);
+					           "\tfirst at %.*s(%td:%td)", LIT(token_pos_file(pos)), token_pos_line(pos), token_pos_column(pos));
 				} else {
 					first_default = default_stmt;
 				}
@@ -1145,7 +1144,7 @@ void check_stmt_internal(Checker *c, AstNode *node, u32 flags) {
 						           "Duplicate type case `%s`\n"
 						           "\tprevious type case at %.*s(%td:%td)",
 						           expr_str,
-						           LIT(pos.file), pos.line, pos.column);
+						           LIT(token_pos_file(pos)), token_pos_line(pos), token_pos_column(pos));
 						gb_string_free(expr_str);
 						break;
 					}
@@ -1275,7 +1274,6 @@ void check_stmt_internal(Checker *c, AstNode *node, u32 flags) {
 							gb_string_free(expr_str);
 							return;
 						}
-						f->using_parent = e;
 					}
 				} else if (is_type_enum(t)) {
 					for (isize i = 0; i < t->Record.field_count; i++) {
@@ -1287,7 +1285,6 @@ void check_stmt_internal(Checker *c, AstNode *node, u32 flags) {
 							gb_string_free(expr_str);
 							return;
 						}
-						f->using_parent = e;
 					}
 
 				} else {
@@ -1307,8 +1304,8 @@ void check_stmt_internal(Checker *c, AstNode *node, u32 flags) {
 						      "\tat %.*s(%td:%td)\n"
 						      "\tat %.*s(%td:%td)",
 						      expr_str, LIT(found->token.string),
-						      LIT(found->token.pos.file), found->token.pos.line, found->token.pos.column,
-						      LIT(decl->token.pos.file), decl->token.pos.line, decl->token.pos.column
+						      LIT(token_pos_file(found->token.pos)), token_pos_line(found->token.pos), token_pos_column(found->token.pos),
+						      LIT(token_pos_file(decl->token.pos)), token_pos_line(decl->token.pos), token_pos_column(decl->token.pos)
 						      );
 						gb_string_free(expr_str);
 						return;
@@ -1320,10 +1317,10 @@ void check_stmt_internal(Checker *c, AstNode *node, u32 flags) {
 				Type *t = base_type(type_deref(e->type));
 				if (is_type_struct(t) || is_type_raw_union(t)) {
 					// TODO(bill): Make it work for unions too
-					Scope **found = map_scope_get(&c->info.scopes, hash_pointer(t->Record.node));
+					Scope *found = scope_of_node(&c->info, t->Record.node);
 					GB_ASSERT(found != NULL);
-					for_array(i, (*found)->elements.entries) {
-						Entity *f = (*found)->elements.entries.e[i].value;
+					for_array(i, found->elements.entries) {
+						Entity *f = found->elements.entries.e[i].value;
 						if (f->kind == Entity_Variable) {
 							Entity *uvar = make_entity_using_variable(c->allocator, e, f->token, f->type);
 							if (is_selector) {
@@ -1422,7 +1419,7 @@ void check_stmt_internal(Checker *c, AstNode *node, u32 flags) {
 						error(token,
 						      "Redeclaration of `%.*s` in this scope\n"
 						      "\tat %.*s(%td:%td)",
-						      LIT(str), LIT(pos.file), pos.line, pos.column);
+						      LIT(str), LIT(token_pos_file(pos)), token_pos_line(pos), token_pos_column(pos));
 						entity = found;
 					}
 				}
@@ -1481,10 +1478,10 @@ void check_stmt_internal(Checker *c, AstNode *node, u32 flags) {
 					Type *t = base_type(type_deref(e->type));
 
 					if (is_type_struct(t) || is_type_raw_union(t)) {
-						Scope **found = map_scope_get(&c->info.scopes, hash_pointer(t->Record.node));
+						Scope *found = scope_of_node(&c->info, t->Record.node);
 						GB_ASSERT(found != NULL);
-						for_array(i, (*found)->elements.entries) {
-							Entity *f = (*found)->elements.entries.e[i].value;
+						for_array(i, found->elements.entries) {
+							Entity *f = found->elements.entries.e[i].value;
 							if (f->kind == Entity_Variable) {
 								Entity *uvar = make_entity_using_variable(c->allocator, e, f->token, f->type);
 								uvar->Variable.is_immutable = is_immutable;
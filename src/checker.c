@@ -248,6 +248,7 @@ typedef struct Scope {
 	MapBool          implicit; // Key: Entity *
 
 	Array(Scope *)   shared;
+	MapEntity        shared_index; // Key: String | Only made once `shared` is added to, see `scope_add_shared`
 	Array(Scope *)   imported;
 	bool             is_proc;
 	bool             is_global;
@@ -262,20 +263,15 @@ gb_global Scope *universal_scope = NULL;
 
 
 
-#define MAP_TYPE TypeAndValue
-#define MAP_PROC map_tav_
-#define MAP_NAME MapTypeAndValue
-#include "map.c"
-
 #define MAP_TYPE Scope *
 #define MAP_PROC map_scope_
 #define MAP_NAME MapScope
-#include "map.c"
+#include "open_map.c"
 
 #define MAP_TYPE DeclInfo *
 #define MAP_PROC map_decl_info_
 #define MAP_NAME MapDeclInfo
-#include "map.c"
+#include "open_map.c"
 
 #define MAP_TYPE AstFile *
 #define MAP_PROC map_ast_file_
@@ -285,7 +281,7 @@ gb_global Scope *universal_scope = NULL;
 #define MAP_TYPE ExprInfo
 #define MAP_PROC map_expr_info_
 #define MAP_NAME MapExprInfo
-#include "map.c"
+#include "open_map.c"
 
 typedef struct DelayedDecl {
 	Scope *  parent;
@@ -302,21 +298,124 @@ typedef struct CheckerContext {
 	Type *     type_hint;
 } CheckerContext;
 
+// NOTE: The semantic information of a single AstNode
+typedef struct AstNodeInfo {
+	TypeAndValue tav;        // Expression -> Type (and value), `tav.mode` is Addressing_Invalid if it has none
+	Entity *     definition; // Identifier -> Entity
+	Entity *     use;        // Identifier -> Entity
+	Entity *     implicit;
+	Scope *      scope;
+} AstNodeInfo;
+
+// NOTE: AstNodeInfo indexed by `AstNode.id`. It is split into pages which are allocated
+// when first written to and never move, so the workers of a parallel check share one table.
+#define AST_NODE_INFO_PAGE_SHIFT 12
+#define AST_NODE_INFO_PAGE_SIZE  (1<<AST_NODE_INFO_PAGE_SHIFT)
+#define AST_NODE_INFO_PAGE_COUNT (1<<16)
+
+typedef struct AstNodeInfoTable {
+	gbMutex       mutex; // NOTE: Only needed to add a page
+	gbAtomicPtr * pages; // NOTE: AstNodeInfo *, read without the mutex
+	isize         page_count;
+} AstNodeInfoTable;
+
 // CheckerInfo stores all the symbol information for a type-checked program
 typedef struct CheckerInfo {
-	MapTypeAndValue      types;           // Key: AstNode * | Expression -> Type (and value)
-	MapEntity            definitions;     // Key: AstNode * | Identifier -> Entity
-	MapEntity            uses;            // Key: AstNode * | Identifier -> Entity
-	MapScope             scopes;          // Key: AstNode * | Node       -> Scope
+	AstNodeInfoTable *   nodes;           // Index: AstNode.id | Shared between a checker and its workers
+	Array(Entity *)      definitions;     // NOTE: Every defined entity in the order they were defined
+	MapIsize             definition_map;  // Key: AstNode * | Identifier -> Index into `definitions`
 	MapExprInfo          untyped;         // Key: AstNode * | Expression -> ExprInfo
 	MapDeclInfo          entities;        // Key: Entity *
-	MapEntity            implicits;        // Key: AstNode *
 	MapEntity            foreigns;        // Key: String
 	MapAstFile           files;           // Key: String (full path)
 	MapIsize             type_info_map;   // Key: Type *
+	MapType              type_info_types; // Key: type_hash(Type *) | One Type per Type_Info entry
 	isize                type_info_count;
 } CheckerInfo;
 
+AstNodeInfoTable *make_ast_node_info_table(gbAllocator a) {
+	AstNodeInfoTable *t = gb_alloc_item(a, AstNodeInfoTable);
+	gb_mutex_init(&t->mutex);
+	t->pages = gb_alloc_array(a, gbAtomicPtr, AST_NODE_INFO_PAGE_COUNT);
+	gb_zero_size(t->pages, gb_size_of(gbAtomicPtr)*AST_NODE_INFO_PAGE_COUNT);
+	t->page_count = 0;
+	return t;
+}
+
+void destroy_ast_node_info_table(gbAllocator a, AstNodeInfoTable *t) {
+	for (isize i = 0; i < AST_NODE_INFO_PAGE_COUNT; i++) {
+		void *page = gb_atomic_ptr_load(&t->pages[i]);
+		if (page != NULL) {
+			gb_free(a, page);
+		}
+	}
+	gb_free(a, t->pages);
+	gb_mutex_destroy(&t->mutex);
+	gb_free(a, t);
+}
+
+// NOTE: Returns NULL if nothing has been stored for `node`
+AstNodeInfo *ast_node_info_of(CheckerInfo *i, AstNode *node) {
+	GB_ASSERT(node != NULL);
+	GB_ASSERT_MSG(node->id > 0, "%.*s has no id", LIT(ast_node_strings[node->kind]));
+	AstNodeInfo *page = cast(AstNodeInfo *)gb_atomic_ptr_load(&i->nodes->pages[node->id >> AST_NODE_INFO_PAGE_SHIFT]);
+	if (page == NULL) {
+		return NULL;
+	}
+	return &page[node->id & (AST_NODE_INFO_PAGE_SIZE-1)];
+}
+
+AstNodeInfo *ast_node_info_for_set(CheckerInfo *i, AstNode *node) {
+	AstNodeInfo *info = ast_node_info_of(i, node);
+	if (info == NULL) {
+		AstNodeInfoTable *t = i->nodes;
+		isize index = node->id >> AST_NODE_INFO_PAGE_SHIFT;
+		GB_ASSERT(index < AST_NODE_INFO_PAGE_COUNT);
+		gb_mutex_lock(&t->mutex);
+		AstNodeInfo *page = cast(AstNodeInfo *)gb_atomic_ptr_load(&t->pages[index]);
+		if (page == NULL) {
+			page = gb_alloc_array(heap_allocator(), AstNodeInfo, AST_NODE_INFO_PAGE_SIZE);
+			gb_zero_size(page, gb_size_of(AstNodeInfo)*AST_NODE_INFO_PAGE_SIZE);
+			// NOTE: Only publish the page once it is zeroed
+			gb_atomic_ptr_store(&t->pages[index], page);
+			t->page_count++;
+		}
+		gb_mutex_unlock(&t->mutex);
+		info = &page[node->id & (AST_NODE_INFO_PAGE_SIZE-1)];
+	}
+	return info;
+}
+
+// NOTE: What an argument contributes to overload resolution. The value only matters
+// for untyped constants as they must be representable by the parameter type
+typedef struct OverloadCacheArg {
+	Type *         type;
+	AddressingMode mode;
+	ExactValue     value;
+} OverloadCacheArg;
+
+typedef struct OverloadCacheEntry {
+	struct OverloadCacheEntry *next; // NOTE: Next entry with the same hash
+	Entity **                  procs;
+	isize                      proc_count;
+	OverloadCacheArg *         args;
+	isize                      arg_count;
+	bool                       vari_expand;
+	isize                      chosen; // Index into `procs`
+} OverloadCacheEntry;
+
+#define MAP_TYPE OverloadCacheEntry *
+#define MAP_PROC map_overload_cache_
+#define MAP_NAME MapOverloadCache
+#include "open_map.c"
+
+// NOTE: The overload chosen for a set of procedures and a list of argument types
+typedef struct OverloadCache {
+	MapOverloadCache entries; // Key: overload_cache_hash
+	isize            hits;
+	isize            misses;
+} OverloadCache;
+
 typedef struct Checker {
 	Parser *    parser;
 	CheckerInfo info;
@@ -336,6 +435,16 @@ typedef struct Checker {
 
 	Array(Type *)          proc_stack;
 	bool                   done_preload;
+
+	// NOTE: Only used when procedure bodies are checked in parallel
+	gbMutex                mutex;
+	Checker *              shared;             // The checker a worker was cloned from, NULL if not a worker
+	Array(Type *)          type_info_requests; // Worker only, replayed in a deterministic order afterwards
+	Array(Arena)           worker_arenas;
+	i32                    shared_entity_id_max; // Worker only, entities up to this id are shared between workers
+	Array(Entity *)        used_entities;        // Worker only, shared entities to mark as used afterwards
+
+	OverloadCache          overload_cache; // NOTE: Owner only, use `lock_shared_checker`
 } Checker;
 
 
@@ -419,6 +528,9 @@ void destroy_scope(Scope *scope) {
 
 	map_entity_destroy(&scope->elements);
 	map_bool_destroy(&scope->implicit);
+	if (scope->shared.count > 0) {
+		map_entity_destroy(&scope->shared_index);
+	}
 	array_free(&scope->shared);
 	array_free(&scope->imported);
 
@@ -428,7 +540,7 @@ void destroy_scope(Scope *scope) {
 void add_scope(Checker *c, AstNode *node, Scope *scope) {
 	GB_ASSERT(node != NULL);
 	GB_ASSERT(scope != NULL);
-	map_scope_set(&c->info.scopes, hash_pointer(node), scope);
+	ast_node_info_for_set(&c->info, node)->scope = scope;
 }
 
 
@@ -452,32 +564,69 @@ void check_close_scope(Checker *c) {
 }
 
 
-Entity *current_scope_lookup_entity(Scope *s, String name) {
-	HashKey key = hash_string(name);
-	Entity **found = map_entity_get(&s->elements, key);
-	if (found) {
-		return *found;
-	}
+// NOTE: `shared_index` holds, for each name, the entity which a search of the `shared`
+// scopes in order would find first. This means that finding a name in the shared scopes
+// (e.g. the files @ global scope) is a single lookup rather than one for each of them.
+void scope_update_shared_index(Scope *s, HashKey key) {
 	for_array(i, s->shared) {
 		Scope *shared = s->shared.e[i];
 		Entity **found = map_entity_get(&shared->elements, key);
-		if (found) {
-			Entity *e = *found;
-			if (e->kind == Entity_Variable &&
-			    !e->scope->is_file &&
-			    !e->scope->is_global) {
-				continue;
-			}
+		// NOTE: Do not index imported entities even #include ones
+		if (found != NULL && (*found)->scope == shared) {
+			map_entity_set(&s->shared_index, key, *found);
+			return;
+		}
+	}
+}
 
-			if (e->scope != shared) {
-				// Do not return imported entities even #include ones
-				continue;
-			}
+void scope_add_shared(Scope *s, Scope *shared) {
+	if (s->shared.count == 0) {
+		map_entity_init(&s->shared_index, heap_allocator());
+	}
+	array_add(&s->shared, shared);
+	for_array(i, shared->elements.entries) {
+		scope_update_shared_index(s, shared->elements.entries.e[i].key);
+	}
+}
 
-			return e;
+Entity *scope_lookup_shared(Scope *s, HashKey key, bool gone_thru_file) {
+	if (s->shared.count == 0) {
+		return NULL;
+	}
+	Entity **found = map_entity_get(&s->shared_index, key);
+	if (found == NULL) {
+		return NULL;
+	}
+	Entity *e = *found;
+	if ((e->kind == Entity_ImportName ||
+	     e->kind == Entity_LibraryName)
+	     && gone_thru_file) {
+		// NOTE: Rare, so just search the shared scopes after this one
+		isize i = 0;
+		while (s->shared.e[i] != e->scope) {
+			i++;
 		}
+		for (i = i+1; i < s->shared.count; i++) {
+			Scope *shared = s->shared.e[i];
+			Entity **found = map_entity_get(&shared->elements, key);
+			if (found != NULL && (*found)->scope == shared &&
+			    (*found)->kind != Entity_ImportName &&
+			    (*found)->kind != Entity_LibraryName) {
+				return *found;
+			}
+		}
+		return NULL;
 	}
-	return NULL;
+	return e;
+}
+
+Entity *current_scope_lookup_entity(Scope *s, String name) {
+	HashKey key = hash_string(name);
+	Entity **found = map_entity_get(&s->elements, key);
+	if (found) {
+		return *found;
+	}
+	return scope_lookup_shared(s, key, false);
 }
 
 void scope_lookup_parent_entity(Scope *scope, String name, Scope **scope_, Entity **entity_) {
@@ -508,32 +657,11 @@ void scope_lookup_parent_entity(Scope *scope, String name, Scope **scope_, Entit
 			gone_thru_proc = true;
 		} else {
 			// Check shared scopes - i.e. other files @ global scope
-			for_array(i, s->shared) {
-				Scope *shared = s->shared.e[i];
-				Entity **found = map_entity_get(&shared->elements, key);
-				if (found) {
-					Entity *e = *found;
-					if (e->kind == Entity_Variable &&
-					    !e->scope->is_file &&
-					    !e->scope->is_global) {
-						continue;
-					}
-
-					if (e->scope != shared) {
-						// Do not return imported entities even #include ones
-						continue;
-					}
-
-					if ((e->kind == Entity_ImportName ||
-					     e->kind == Entity_LibraryName)
-					     && gone_thru_file) {
-						continue;
-					}
-
-					if (entity_) *entity_ = e;
-					if (scope_) *scope_ = shared;
-					return;
-				}
+			Entity *e = scope_lookup_shared(s, key, gone_thru_file);
+			if (e != NULL) {
+				if (entity_) *entity_ = e;
+				if (scope_) *scope_ = e->scope;
+				return;
 			}
 		}
 
@@ -589,6 +717,9 @@ Entity *scope_insert_entity(Scope *s, Entity *entity) {
 	if (entity->scope == NULL) {
 		entity->scope = s;
 	}
+	if (s->is_file && s->is_global && s->parent != NULL && s->parent->shared.count > 0) {
+		scope_update_shared_index(s->parent, key);
+	}
 	return NULL;
 }
 
@@ -598,6 +729,41 @@ void check_scope_usage(Checker *c, Scope *scope) {
 }
 
 
+// NOTE: A parallel worker only records into its own maps, so anything it has not
+// recorded itself must come from the checker it was cloned from. That checker is not written
+// to whilst the workers are running.
+DeclInfo *decl_info_of_entity(Checker *c, Entity *e) {
+	DeclInfo **found = map_decl_info_get(&c->info.entities, hash_pointer(e));
+	if (found == NULL && c->shared != NULL) {
+		found = map_decl_info_get(&c->shared->info.entities, hash_pointer(e));
+	}
+	if (found != NULL) {
+		return *found;
+	}
+	return NULL;
+}
+
+Scope *scope_of_node(CheckerInfo *i, AstNode *node) {
+	AstNodeInfo *info = ast_node_info_of(i, node);
+	if (info != NULL) {
+		return info->scope;
+	}
+	return NULL;
+}
+
+
+// NOTE: Returns the checker which owns the state shared between parallel workers, locked
+Checker *lock_shared_checker(Checker *c) {
+	Checker *sc = c->shared != NULL ? c->shared : c;
+	gb_mutex_lock(&sc->mutex);
+	return sc;
+}
+
+void unlock_shared_checker(Checker *sc) {
+	gb_mutex_unlock(&sc->mutex);
+}
+
+
 void add_dependency(DeclInfo *d, Entity *e) {
 	map_bool_set(&d->deps, hash_pointer(e), cast(bool)true);
 }
@@ -607,8 +773,13 @@ void add_declaration_dependency(Checker *c, Entity *e) {
 		return;
 	}
 	if (c->context.decl != NULL) {
-		DeclInfo **found = map_decl_info_get(&c->info.entities, hash_pointer(e));
-		if (found) {
+		bool has_decl = decl_info_of_entity(c, e) != NULL;
+		if (!has_decl && c->shared != NULL && e->kind != Entity_Variable) {
+			// NOTE: A local declaration made by an enclosing procedure may have been
+			// recorded by a different worker, so it cannot be looked up yet
+			has_decl = e->scope != NULL && !e->scope->is_file && !e->scope->is_global && e->scope != universal_scope;
+		}
+		if (has_decl) {
 			add_dependency(c->context.decl, e);
 		}
 	}
@@ -692,30 +863,27 @@ void init_universal_scope(void) {
 
 void init_checker_info(CheckerInfo *i) {
 	gbAllocator a = heap_allocator();
-	map_tav_init(&i->types,            a);
-	map_entity_init(&i->definitions,   a);
-	map_entity_init(&i->uses,          a);
-	map_scope_init(&i->scopes,         a);
+	i->nodes = NULL; // NOTE: Set by the owner, see `init_checker` and `init_checker_worker`
+	array_init(&i->definitions,        a);
+	map_isize_init(&i->definition_map,   a);
 	map_decl_info_init(&i->entities,   a);
 	map_expr_info_init(&i->untyped,    a);
 	map_entity_init(&i->foreigns,      a);
-	map_entity_init(&i->implicits,     a);
 	map_isize_init(&i->type_info_map,  a);
+	map_type_init(&i->type_info_types, a);
 	map_ast_file_init(&i->files,       a);
 	i->type_info_count = 0;
 
 }
 
 void destroy_checker_info(CheckerInfo *i) {
-	map_tav_destroy(&i->types);
-	map_entity_destroy(&i->definitions);
-	map_entity_destroy(&i->uses);
-	map_scope_destroy(&i->scopes);
+	array_free(&i->definitions);
+	map_isize_destroy(&i->definition_map);
 	map_decl_info_destroy(&i->entities);
 	map_expr_info_destroy(&i->untyped);
 	map_entity_destroy(&i->foreigns);
-	map_entity_destroy(&i->implicits);
 	map_isize_destroy(&i->type_info_map);
+	map_type_destroy(&i->type_info_types);
 	map_ast_file_destroy(&i->files);
 }
 
@@ -725,6 +893,7 @@ void init_checker(Checker *c, Parser *parser, BuildContext *bc) {
 
 	c->parser = parser;
 	init_checker_info(&c->info);
+	c->info.nodes = make_ast_node_info_table(a);
 
 	array_init(&c->proc_stack, a);
 	array_init(&c->procs, a);
@@ -736,7 +905,7 @@ void init_checker(Checker *c, Parser *parser, BuildContext *bc) {
 	isize total_token_count = 0;
 	for_array(i, c->parser->files) {
 		AstFile *f = &c->parser->files.e[i];
-		total_token_count += f->tokens.count;
+		total_token_count += f->token_count;
 	}
 	isize arena_size = 2 * item_size * total_token_count;
 	gb_arena_init_from_allocator(&c->arena, a, arena_size);
@@ -748,9 +917,14 @@ void init_checker(Checker *c, Parser *parser, BuildContext *bc) {
 
 	c->global_scope = make_scope(universal_scope, c->allocator);
 	c->context.scope = c->global_scope;
+
+	gb_mutex_init(&c->mutex);
+	array_init(&c->worker_arenas, a);
+	map_overload_cache_init(&c->overload_cache.entries, a);
 }
 
 void destroy_checker(Checker *c) {
+	destroy_ast_node_info_table(heap_allocator(), c->info.nodes);
 	destroy_checker_info(&c->info);
 	destroy_scope(c->global_scope);
 	array_free(&c->proc_stack);
@@ -759,24 +933,64 @@ void destroy_checker(Checker *c) {
 	array_free(&c->delayed_foreign_libraries);
 
 	gb_arena_free(&c->arena);
+	for_array(i, c->worker_arenas) {
+		arena_free(&c->worker_arenas.e[i]);
+	}
+	array_free(&c->worker_arenas);
+	gb_mutex_destroy(&c->mutex);
+
+	for_array(i, c->overload_cache.entries.entries) {
+		OverloadCacheEntry *e = c->overload_cache.entries.entries.e[i].value;
+		while (e != NULL) {
+			OverloadCacheEntry *next = e->next;
+			gb_free(heap_allocator(), e);
+			e = next;
+		}
+	}
+	map_overload_cache_destroy(&c->overload_cache.entries);
 }
 
 
 TypeAndValue *type_and_value_of_expression(CheckerInfo *i, AstNode *expression) {
-	TypeAndValue *found = map_tav_get(&i->types, hash_pointer(expression));
-	return found;
+	AstNodeInfo *info = ast_node_info_of(i, expression);
+	if (info != NULL && info->tav.mode != Addressing_Invalid) {
+		return &info->tav;
+	}
+	return NULL;
 }
 
+Entity *entity_of_definition(CheckerInfo *i, AstNode *identifier) {
+	AstNodeInfo *info = ast_node_info_of(i, identifier);
+	if (info != NULL) {
+		return info->definition;
+	}
+	return NULL;
+}
+
+Entity *entity_of_use(CheckerInfo *i, AstNode *identifier) {
+	AstNodeInfo *info = ast_node_info_of(i, identifier);
+	if (info != NULL) {
+		return info->use;
+	}
+	return NULL;
+}
+
+Entity *implicit_entity_of_node(CheckerInfo *i, AstNode *node) {
+	AstNodeInfo *info = ast_node_info_of(i, node);
+	if (info != NULL) {
+		return info->implicit;
+	}
+	return NULL;
+}
 
 Entity *entity_of_ident(CheckerInfo *i, AstNode *identifier) {
 	if (identifier->kind == AstNode_Ident) {
-		Entity **found = map_entity_get(&i->definitions, hash_pointer(identifier));
-		if (found) {
-			return *found;
-		}
-		found = map_entity_get(&i->uses, hash_pointer(identifier));
-		if (found) {
-			return *found;
+		AstNodeInfo *info = ast_node_info_of(i, identifier);
+		if (info != NULL) {
+			if (info->definition != NULL) {
+				return info->definition;
+			}
+			return info->use;
 		}
 	}
 	return NULL;
@@ -826,7 +1040,7 @@ void add_type_and_value(CheckerInfo *i, AstNode *expression, AddressingMode mode
 	tv.type  = type;
 	tv.value = value;
 	tv.mode  = mode;
-	map_tav_set(&i->types, hash_pointer(expression), tv);
+	ast_node_info_for_set(i, expression)->tav = tv;
 }
 
 void add_entity_definition(CheckerInfo *i, AstNode *identifier, Entity *entity) {
@@ -835,8 +1049,19 @@ void add_entity_definition(CheckerInfo *i, AstNode *identifier, Entity *entity)
 		if (str_eq(identifier->Ident.string, str_lit("_"))) {
 			return;
 		}
+		AstNodeInfo *info = ast_node_info_for_set(i, identifier);
 		HashKey key = hash_pointer(identifier);
-		map_entity_set(&i->definitions, key, entity);
+		if (info->definition == NULL) {
+			map_isize_set(&i->definition_map, key, i->definitions.count);
+			array_add(&i->definitions, entity);
+		} else {
+			// NOTE: A redefinition replaces the entity in place so the order is kept
+			isize *found = map_isize_get(&i->definition_map, key);
+			if (found != NULL) {
+				i->definitions.e[*found] = entity;
+			}
+		}
+		info->definition = entity;
 	} else {
 		// NOTE(bill): Error should handled elsewhere
 	}
@@ -858,7 +1083,7 @@ bool add_entity(Checker *c, Scope *scope, AstNode *identifier, Entity *entity) {
 				      "Redeclaration of `%.*s` in this scope through `using`\n"
 				      "\tat %.*s(%td:%td)",
 				      LIT(name),
-				      LIT(up->token.pos.file), up->token.pos.line, up->token.pos.column);
+				      LIT(token_pos_file(up->token.pos)), token_pos_line(up->token.pos), token_pos_column(up->token.pos));
 				return false;
 			} else {
 				if (token_pos_eq(pos, entity->token.pos)) {
@@ -869,7 +1094,7 @@ bool add_entity(Checker *c, Scope *scope, AstNode *identifier, Entity *entity) {
 				      "Redeclaration of `%.*s` in this scope\n"
 				      "\tat %.*s(%td:%td)",
 				      LIT(name),
-				      LIT(pos.file), pos.line, pos.column);
+				      LIT(token_pos_file(pos)), token_pos_line(pos), token_pos_column(pos));
 				return false;
 			}
 		}
@@ -885,12 +1110,24 @@ void add_entity_use(Checker *c, AstNode *identifier, Entity *entity) {
 	if (identifier->kind != AstNode_Ident) {
 		return;
 	}
-	HashKey key = hash_pointer(identifier);
-	map_entity_set(&c->info.uses, key, entity);
+	ast_node_info_for_set(&c->info, identifier)->use = entity;
 	add_declaration_dependency(c, entity); // TODO(bill): Should this be here?
 }
 
 
+// NOTE: A worker must not write to the entities it shares with the other workers, so it records its
+// uses of them and they are marked once the workers are done
+void add_entity_flag_used(Checker *c, Entity *e) {
+	if ((e->flags & EntityFlag_Used) != 0) {
+		return;
+	}
+	if (c->shared != NULL && e->id <= c->shared_entity_id_max) {
+		array_add(&c->used_entities, e);
+		return;
+	}
+	e->flags |= EntityFlag_Used;
+}
+
 void add_entity_and_decl_info(Checker *c, AstNode *identifier, Entity *e, DeclInfo *d) {
 	GB_ASSERT(identifier->kind == AstNode_Ident);
 	GB_ASSERT(e != NULL && d != NULL);
@@ -903,10 +1140,30 @@ void add_entity_and_decl_info(Checker *c, AstNode *identifier, Entity *e, DeclIn
 void add_implicit_entity(Checker *c, AstNode *node, Entity *e) {
 	GB_ASSERT(node != NULL);
 	GB_ASSERT(e != NULL);
-	map_entity_set(&c->info.implicits, hash_pointer(node), e);
+	ast_node_info_for_set(&c->info, node)->implicit = e;
 }
 
 
+// NOTE: Returns the Type_Info index of `t` or of a type identical to it, -1 if neither has one
+isize find_type_info_index(CheckerInfo *info, Type *t) {
+	isize *found = map_isize_get(&info->type_info_map, hash_pointer(t));
+	if (found != NULL) {
+		return *found;
+	}
+
+	HashKey key = hash_type_structure(t);
+	MapTypeEntry *e = map_type_multi_find_first(&info->type_info_types, key);
+	while (e != NULL) {
+		if (are_types_identical(t, e->value)) {
+			found = map_isize_get(&info->type_info_map, hash_pointer(e->value));
+			GB_ASSERT(found != NULL);
+			return *found;
+		}
+		e = map_type_multi_find_next(&info->type_info_types, e);
+	}
+	return -1;
+}
+
 void add_type_info_type(Checker *c, Type *t) {
 	if (t == NULL) {
 		return;
@@ -916,26 +1173,24 @@ void add_type_info_type(Checker *c, Type *t) {
 		return; // Could be nil
 	}
 
+	if (c->shared != NULL) {
+		// NOTE: The order types are added in decides their index, so a worker defers them
+		array_add(&c->type_info_requests, t);
+		return;
+	}
+
 	if (map_isize_get(&c->info.type_info_map, hash_pointer(t)) != NULL) {
 		// Types have already been added
 		return;
 	}
 
-	isize ti_index = -1;
-	for_array(i, c->info.type_info_map.entries) {
-		MapIsizeEntry *e = &c->info.type_info_map.entries.e[i];
-		Type *prev_type = cast(Type *)e->key.ptr;
-		if (are_types_identical(t, prev_type)) {
-			// Duplicate entry
-			ti_index = e->value;
-			break;
-		}
-	}
+	isize ti_index = find_type_info_index(&c->info, t);
 	if (ti_index < 0) {
 		// Unique entry
 		// NOTE(bill): map entries grow linearly and in order
 		ti_index = c->info.type_info_count;
 		c->info.type_info_count++;
+		map_type_multi_insert(&c->info.type_info_types, hash_type_structure(t), t);
 	}
 	map_isize_set(&c->info.type_info_map, hash_pointer(t), ti_index);
 
@@ -1082,7 +1337,7 @@ Type *const curr_procedure(Checker *c) {
 void add_curr_ast_file(Checker *c, AstFile *file) {
 	if (file != NULL) {
 		TokenPos zero_pos = {0};
-		global_error_collector.prev = zero_pos;
+		error_prev_pos = zero_pos;
 		c->curr_ast_file = file;
 		c->context.decl  = file->decl_info;
 		c->context.scope = file->scope;
@@ -1093,50 +1348,105 @@ void add_curr_ast_file(Checker *c, AstFile *file) {
 
 
 
-void add_dependency_to_map(MapEntity *map, CheckerInfo *info, Entity *node) {
-	if (node == NULL) {
-		return;
+// NOTE: A set of entities as a bitset indexed by `Entity.id`
+typedef struct EntitySet {
+	u64 * bits;
+	isize count; // NOTE: In entity ids
+} EntitySet;
+
+void entity_set_init(EntitySet *s, gbAllocator a, isize count) {
+	isize word_count = (count+63)/64;
+	s->bits  = gb_alloc_array(a, u64, word_count);
+	s->count = count;
+	gb_zero_size(s->bits, gb_size_of(u64)*word_count);
+}
+
+void entity_set_destroy(EntitySet *s, gbAllocator a) {
+	gb_free(a, s->bits);
+	gb_zero_item(s);
+}
+
+bool entity_set_has(EntitySet *s, Entity *e) {
+	if (e->id <= 0 || e->id >= s->count) {
+		return false; // NOTE: Made after the set was
 	}
-	if (map_entity_get(map, hash_pointer(node)) != NULL) {
-		return;
+	return (s->bits[e->id>>6] & (1ull<<(e->id&63))) != 0;
+}
+
+// NOTE: Returns false if `e` was already in the set
+bool entity_set_add(EntitySet *s, Entity *e) {
+	GB_ASSERT(0 < e->id && e->id < s->count);
+	u64 bit = 1ull<<(e->id&63);
+	if (s->bits[e->id>>6] & bit) {
+		return false;
 	}
-	map_entity_set(map, hash_pointer(node), node);
+	s->bits[e->id>>6] |= bit;
+	return true;
+}
 
 
-	DeclInfo **found = map_decl_info_get(&info->entities, hash_pointer(node));
-	if (found == NULL) {
-		return;
-	}
+typedef struct MinDepWorklist {
+	EntitySet       set;
+	DeclInfo **     decls; // Index: Entity.id
+	Array(Entity *) stack;
+} MinDepWorklist;
 
-	DeclInfo *decl = *found;
-	for_array(i, decl->deps.entries) {
-		Entity *e = cast(Entity *)decl->deps.entries.e[i].key.ptr;
-		add_dependency_to_map(map, info, e);
+void add_minimum_dependency(MinDepWorklist *w, Entity *e) {
+	if (e != NULL && entity_set_add(&w->set, e)) {
+		array_add(&w->stack, e);
 	}
 }
 
-MapEntity generate_minimum_dependency_map(CheckerInfo *info, Entity *start) {
-	MapEntity map = {0}; // Key: Entity *
-	map_entity_init(&map, heap_allocator());
+// NOTE: Every entity reachable through `DeclInfo.deps` from the entry point and anything
+// which is always required. This is done with an explicit stack as dependency chains can be
+// far deeper than the call stack allows.
+EntitySet generate_minimum_dependency_set(CheckerInfo *info, Entity *start) {
+	gbAllocator a = heap_allocator();
+	isize entity_count = entity_id_count();
+
+	MinDepWorklist w = {0};
+	entity_set_init(&w.set, a, entity_count);
+	array_init(&w.stack, a);
+	w.decls = gb_alloc_array(a, DeclInfo *, entity_count);
+	gb_zero_size(w.decls, gb_size_of(DeclInfo *)*entity_count);
+	for_array(i, info->entities.entries) {
+		Entity *e = cast(Entity *)info->entities.entries.e[i].key.ptr;
+		GB_ASSERT(0 < e->id && e->id < entity_count);
+		w.decls[e->id] = info->entities.entries.e[i].value;
+	}
 
-	for_array(i, info->definitions.entries) {
-		Entity *e = info->definitions.entries.e[i].value;
+	for_array(i, info->definitions) {
+		Entity *e = info->definitions.e[i];
 		if (e->scope->is_global) {
 			// NOTE(bill): Require runtime stuff
-			add_dependency_to_map(&map, info, e);
+			add_minimum_dependency(&w, e);
 		} else if (e->kind == Entity_Procedure) {
 			if ((e->Procedure.tags & ProcTag_export) != 0) {
-				add_dependency_to_map(&map, info, e);
+				add_minimum_dependency(&w, e);
 			}
 			if (e->Procedure.is_foreign) {
-				add_dependency_to_map(&map, info, e->Procedure.foreign_library);
+				add_minimum_dependency(&w, e->Procedure.foreign_library);
 			}
 		}
 	}
 
-	add_dependency_to_map(&map, info, start);
+	add_minimum_dependency(&w, start);
+
+	while (w.stack.count > 0) {
+		Entity *node = w.stack.e[w.stack.count-1];
+		array_pop(&w.stack);
+		DeclInfo *decl = w.decls[node->id];
+		if (decl == NULL) {
+			continue;
+		}
+		for_array(i, decl->deps.entries) {
+			add_minimum_dependency(&w, cast(Entity *)decl->deps.entries.e[i].key.ptr);
+		}
+	}
 
-	return map;
+	array_free(&w.stack);
+	gb_free(a, w.decls);
+	return w.set;
 }
 
 
@@ -1216,6 +1526,13 @@ void init_preload(Checker *c) {
 		t_type_info_map_ptr           = make_type_pointer(c->allocator, t_type_info_map);
 	}
 
+	if (entity__any_type_info == NULL) {
+		entity__any_type_info = make_entity_field(c->allocator, NULL, make_token_ident(str_lit("type_info")), t_type_info_ptr, false, 0);
+	}
+	if (entity__any_data == NULL) {
+		entity__any_data = make_entity_field(c->allocator, NULL, make_token_ident(str_lit("data")), t_rawptr, false, 1);
+	}
+
 	if (t_allocator == NULL) {
 		Entity *e = find_core_entity(c, str_lit("Allocator"));
 		t_allocator = e->type;
@@ -1340,7 +1657,7 @@ void check_procedure_overloading(Checker *c, Entity *e) {
 			}
 
 			if (is_invalid) {
-				gb_printf_err("\tprevious procedure at %.*s(%td:%td)\n", LIT(pos.file), pos.line, pos.column);
+				gb_printf_err("\tprevious procedure at %.*s(%td:%td)\n", LIT(token_pos_file(pos)), token_pos_line(pos), token_pos_column(pos));
 				q->type = t_invalid;
 			}
 		}
@@ -1743,7 +2060,7 @@ void check_import_entities(Checker *c, MapScope *file_scopes) {
 				Scope *scope = file_scopes->entries.e[scope_index].value;
 				gb_printf_err("%.*s\n", LIT(scope->file->tokenizer.fullpath));
 			}
-			gb_printf_err("%.*s(%td:%td)\n", LIT(token.pos.file), token.pos.line, token.pos.column);
+			gb_printf_err("%.*s(%td:%td)\n", LIT(token_pos_file(token.pos)), token_pos_line(token.pos), token_pos_column(token.pos));
 			GB_PANIC("Unable to find scope for file: %.*s", LIT(id->fullpath));
 		}
 		Scope *scope = *found;
@@ -1811,7 +2128,7 @@ void check_import_entities(Checker *c, MapScope *file_scopes) {
 			if (str_eq(import_name, str_lit("_"))) {
 				error(token, "File name, %.*s, cannot be as an import name as it is not a valid identifier", LIT(id->import_name.string));
 			} else {
-				GB_ASSERT(id->import_name.pos.line != 0);
+				GB_ASSERT(token_pos_is_valid(id->import_name.pos));
 				id->import_name.string = import_name;
 				Entity *e = make_entity_import_name(c->allocator, parent_scope, id->import_name, t_invalid,
 				                                    id->fullpath, id->import_name.string,
@@ -1863,7 +2180,7 @@ void check_import_entities(Checker *c, MapScope *file_scopes) {
 		if (str_eq(library_name, str_lit("_"))) {
 			error(fl->token, "File name, %.*s, cannot be as a library name as it is not a valid identifier", LIT(fl->library_name.string));
 		} else {
-			GB_ASSERT(fl->library_name.pos.line != 0);
+			GB_ASSERT(token_pos_is_valid(fl->library_name.pos));
 			fl->library_name.string = library_name;
 			Entity *e = make_entity_library_name(c->allocator, parent_scope, fl->library_name, t_invalid,
 			                                     file_str, library_name);
@@ -1873,6 +2190,322 @@ void check_import_entities(Checker *c, MapScope *file_scopes) {
 }
 
 
+void check_proc_info(Checker *c, ProcedureInfo pi) {
+	CheckerContext prev_context = c->context;
+	add_curr_ast_file(c, pi.file);
+
+	bool bounds_check    = (pi.tags & ProcTag_bounds_check)    != 0;
+	bool no_bounds_check = (pi.tags & ProcTag_no_bounds_check) != 0;
+
+
+	if (bounds_check) {
+		c->context.stmt_state_flags |= StmtStateFlag_bounds_check;
+		c->context.stmt_state_flags &= ~StmtStateFlag_no_bounds_check;
+	} else if (no_bounds_check) {
+		c->context.stmt_state_flags |= StmtStateFlag_no_bounds_check;
+		c->context.stmt_state_flags &= ~StmtStateFlag_bounds_check;
+	}
+
+	check_proc_body(c, pi.token, pi.decl, pi.type, pi.body);
+
+	c->context = prev_context;
+}
+
+
+#define CHECKER_WORKER_ARENA_BLOCK_SIZE gb_megabytes(1)
+
+typedef struct ProcCheckItem {
+	ProcedureInfo     info;
+	Array(Type *)     type_info_requests;
+	ErrorMessageArray errors;       // NOTE: Printed in queue order once the workers have joined
+	isize             nested_index; // NOTE: Nested procedures of an item are queued together
+	isize             nested_count;
+} ProcCheckItem;
+
+typedef struct ProcCheckQueue {
+	Array(ProcCheckItem) items;
+	isize                root_count;
+	isize                next_index;        // Next entry in `items` to be claimed by a worker
+	isize                busy_worker_count;
+	isize                idle_worker_count; // Workers waiting on `work` for more items
+	gbSemaphore          work;
+} ProcCheckQueue;
+
+typedef struct ProcCheckWorker {
+	ProcCheckQueue *queue;
+	Checker         checker;
+	SelectionStats  selection_stats; // NOTE: Copied from the worker's thread once it is done
+} ProcCheckWorker;
+
+
+// NOTE: A worker is a clone of `c` with its own context, allocators, and CheckerInfo maps.
+// Anything it cannot find in its own maps is looked up in `c` (see `decl_info_of_entity`).
+// The per node information is not cloned, every worker writes to the table of `c`.
+void init_checker_worker(Checker *w, Checker *c, Arena *arena, isize tmp_arena_size) {
+	gbAllocator a = heap_allocator();
+	*w = *c;
+	w->shared = c;
+	init_checker_info(&w->info);
+	w->info.nodes = c->info.nodes;
+
+	array_init(&w->procs, a);
+	array_init(&w->proc_stack, a);
+	array_init(&w->delayed_imports, a);
+	array_init(&w->delayed_foreign_libraries, a);
+	array_init(&w->type_info_requests, a);
+	array_init(&w->used_entities, a);
+	w->shared_entity_id_max = gb_atomic32_load(&global_entity_id);
+	gb_zero_item(&w->worker_arenas);
+	gb_zero_item(&w->mutex);
+	gb_zero_item(&w->overload_cache);
+
+	gb_zero_item(&w->arena);
+	w->allocator = arena_allocator(arena);
+	gb_arena_init_from_allocator(&w->tmp_arena, a, tmp_arena_size);
+	w->tmp_allocator = gb_arena_allocator(&w->tmp_arena);
+}
+
+void destroy_checker_worker(Checker *w) {
+	destroy_checker_info(&w->info);
+	array_free(&w->procs);
+	array_free(&w->proc_stack);
+	array_free(&w->delayed_imports);
+	array_free(&w->delayed_foreign_libraries);
+	array_free(&w->type_info_requests);
+	array_free(&w->used_entities);
+	gb_arena_free(&w->tmp_arena);
+}
+
+void merge_checker_info(CheckerInfo *dst, CheckerInfo *src) {
+	// NOTE: The per node information was written straight into the shared table
+	GB_ASSERT(dst->nodes == src->nodes);
+	isize definition_offset = dst->definitions.count;
+	for_array(i, src->definitions) {
+		array_add(&dst->definitions, src->definitions.e[i]);
+	}
+	for_array(i, src->definition_map.entries) {
+		map_isize_set(&dst->definition_map, src->definition_map.entries.e[i].key,
+		              definition_offset + src->definition_map.entries.e[i].value);
+	}
+	for_array(i, src->untyped.entries) {
+		map_expr_info_set(&dst->untyped, src->untyped.entries.e[i].key, src->untyped.entries.e[i].value);
+	}
+	for_array(i, src->entities.entries) {
+		map_decl_info_set(&dst->entities, src->entities.entries.e[i].key, src->entities.entries.e[i].value);
+	}
+}
+
+GB_THREAD_PROC(check_proc_worker_proc) {
+	ProcCheckWorker *w = cast(ProcCheckWorker *)data;
+	ProcCheckQueue *q = w->queue;
+	Checker *c = &w->checker;
+	Checker *sc = c->shared;
+
+	for (;;) {
+		ProcedureInfo pi = {0};
+		isize index = -1;
+		bool done = false;
+
+		gb_mutex_lock(&sc->mutex);
+		if (q->next_index < q->items.count) {
+			index = q->next_index++;
+			pi = q->items.e[index].info;
+			q->busy_worker_count++;
+		} else if (q->busy_worker_count == 0) {
+			done = true;
+		} else {
+			// NOTE: A busy worker may still queue nested procedures, wait for it
+			q->idle_worker_count++;
+		}
+		gb_mutex_unlock(&sc->mutex);
+
+		if (done) {
+			break;
+		}
+		if (index < 0) {
+			gb_semaphore_wait(&q->work);
+			continue;
+		}
+
+		ErrorMessageArray errors = {0};
+		array_init(&errors, heap_allocator());
+
+		array_clear(&c->procs);
+		array_clear(&c->type_info_requests);
+		error_buffer = &errors;
+		check_proc_info(c, pi);
+
+		// NOTE: A procedure literal shares the declaration (and so the scope) of the procedure
+		// it is within, so it is checked here rather than alongside the rest of that procedure
+		for (isize i = 0; i < c->procs.count; i++) {
+			ProcedureInfo npi = c->procs.e[i];
+			if (npi.decl == pi.decl) {
+				check_proc_info(c, npi);
+			}
+		}
+		error_buffer = NULL;
+
+		gb_mutex_lock(&sc->mutex);
+		isize nested_index = q->items.count;
+		for_array(i, c->procs) {
+			ProcedureInfo npi = c->procs.e[i];
+			if (npi.decl != pi.decl) {
+				ProcCheckItem item = {0};
+				item.info = npi;
+				array_add(&q->items, item);
+			}
+		}
+		ProcCheckItem *item = &q->items.e[index];
+		item->nested_index = nested_index;
+		item->nested_count = q->items.count - nested_index;
+		array_init_count(&item->type_info_requests, heap_allocator(), c->type_info_requests.count);
+		gb_memmove_array(item->type_info_requests.e, c->type_info_requests.e, c->type_info_requests.count);
+		item->errors = errors;
+		q->busy_worker_count--;
+
+		// NOTE: Wake a waiting worker for each new item, or all of them once nothing is left to do
+		isize wake_count = item->nested_count;
+		if (q->busy_worker_count == 0 && q->next_index == q->items.count) {
+			wake_count = q->idle_worker_count;
+		}
+		wake_count = gb_min(wake_count, q->idle_worker_count);
+		q->idle_worker_count -= wake_count;
+		if (wake_count > 0) {
+			gb_semaphore_post(&q->work, cast(i32)wake_count);
+		}
+		gb_mutex_unlock(&sc->mutex);
+	}
+
+	w->selection_stats = selection_stats;
+}
+
+void add_proc_check_type_infos(Checker *c, ProcCheckQueue *q, isize index) {
+	ProcCheckItem *item = &q->items.e[index];
+	for_array(i, item->type_info_requests) {
+		add_type_info_type(c, item->type_info_requests.e[i]);
+	}
+	for (isize i = 0; i < item->nested_count; i++) {
+		add_proc_check_type_infos(c, q, item->nested_index+i);
+	}
+}
+
+// NOTE: Prints the errors of the roots in order, then their nested procedures, and so on, which is
+// the order `check_parsed_files` would have checked them in serially
+void print_proc_check_errors(ProcCheckQueue *q) {
+	Array_isize order = {0};
+	array_init_reserve(&order, heap_allocator(), q->items.count);
+	for (isize i = 0; i < q->root_count; i++) {
+		array_add(&order, i);
+	}
+	for_array(i, order) {
+		ProcCheckItem *item = &q->items.e[order.e[i]];
+		print_error_messages(&item->errors);
+		for (isize j = 0; j < item->nested_count; j++) {
+			array_add(&order, item->nested_index+j);
+		}
+	}
+	array_free(&order);
+}
+
+void check_proc_bodies_parallel(Checker *c) {
+	gbAllocator a = heap_allocator();
+	ProcCheckQueue q = {0};
+	array_init(&q.items, a);
+	gb_semaphore_init(&q.work);
+
+	// NOTE: A procedure literal at file scope (e.g. a global variable's value) is checked
+	// within that file scope which every worker reads from, so check those before going parallel
+	for (isize i = 0; i < c->procs.count; i++) {
+		ProcedureInfo pi = c->procs.e[i];
+		if (pi.decl->scope->is_file) {
+			check_proc_info(c, pi);
+		} else {
+			ProcCheckItem item = {0};
+			item.info = pi;
+			array_add(&q.items, item);
+		}
+	}
+	q.root_count = q.items.count;
+
+	// NOTE: Record layouts are otherwise computed lazily, which would be a race between workers
+	for_array(i, c->info.definitions) {
+		Entity *e = c->info.definitions.e[i];
+		Type *t = e->type;
+		if (t == NULL || !is_type_typed(t)) {
+			continue;
+		}
+		if (e->kind == Entity_Procedure) {
+			Type *pt = base_type(t);
+			if (pt->kind == Type_Proc) {
+				if (pt->Proc.params  != NULL) type_set_offsets(c->allocator, pt->Proc.params);
+				if (pt->Proc.results != NULL) type_set_offsets(c->allocator, pt->Proc.results);
+			}
+		} else if (e->kind == Entity_TypeName || e->kind == Entity_Variable) {
+			type_size_of(c->allocator, t);
+			type_align_of(c->allocator, t);
+		}
+	}
+
+	// NOTE: The calling thread is a worker too
+	isize thread_count = build_context.thread_count;
+	isize tmp_arena_size = gb_max(c->tmp_arena.total_size / thread_count, gb_megabytes(8));
+	ProcCheckWorker *workers = gb_alloc_array(a, ProcCheckWorker, thread_count);
+	gbThread *threads = gb_alloc_array(a, gbThread, thread_count);
+
+	array_init_count(&c->worker_arenas, a, thread_count);
+	for (isize i = 0; i < thread_count; i++) {
+		arena_init(&c->worker_arenas.e[i], a, CHECKER_WORKER_ARENA_BLOCK_SIZE);
+		workers[i].queue = &q;
+		init_checker_worker(&workers[i].checker, c, &c->worker_arenas.e[i], tmp_arena_size);
+	}
+
+	for (isize i = 1; i < thread_count; i++) {
+		gb_thread_init(&threads[i]);
+		gb_thread_start(&threads[i], check_proc_worker_proc, &workers[i]);
+	}
+	check_proc_worker_proc(&workers[0]);
+	for (isize i = 1; i < thread_count; i++) {
+		gb_thread_join(&threads[i]);
+		gb_thread_destory(&threads[i]);
+		selection_stats.path_count       += workers[i].selection_stats.path_count;
+		selection_stats.heap_alloc_count += workers[i].selection_stats.heap_alloc_count;
+	}
+
+	for (isize i = 0; i < thread_count; i++) {
+		Checker *w = &workers[i].checker;
+		for_array(j, w->used_entities) {
+			w->used_entities.e[j]->flags |= EntityFlag_Used;
+		}
+		merge_checker_info(&c->info, &w->info);
+		destroy_checker_worker(w);
+	}
+	print_proc_check_errors(&q);
+	for (isize i = 0; i < q.root_count; i++) {
+		add_proc_check_type_infos(c, &q, i);
+	}
+
+	for_array(i, q.items) {
+		array_free(&q.items.e[i].type_info_requests);
+		destroy_error_messages(&q.items.e[i].errors);
+	}
+	array_free(&q.items);
+	gb_semaphore_destroy(&q.work);
+	gb_free(a, threads);
+	gb_free(a, workers);
+}
+
+
+void compute_type_layouts(Checker *c) {
+	// NOTE: Every type is complete now so layouts can be cached on the types themselves
+	type_layouts_are_final = true;
+	for_array(i, c->info.definitions) {
+		Entity *e = c->info.definitions.e[i];
+		if (e->kind == Entity_TypeName && e->type != NULL) {
+			type_align_of(c->allocator, e->type);
+		}
+	}
+}
+
 void check_parsed_files(Checker *c) {
 	MapScope file_scopes; // Key: String (fullpath)
 	map_scope_init(&file_scopes, heap_allocator());
@@ -1890,7 +2523,7 @@ void check_parsed_files(Checker *c) {
 		}
 
 		if (scope->is_global) {
-			array_add(&c->global_scope->shared, scope);
+			scope_add_shared(c->global_scope, scope);
 		}
 
 		if (scope->is_init || scope->is_global) {
@@ -1919,27 +2552,13 @@ void check_parsed_files(Checker *c) {
 	init_preload(c); // NOTE(bill): This could be setup previously through the use of `type_info(_of_val)`
 
 	// Check procedure bodies
-	// NOTE(bill): Nested procedures bodies will be added to this "queue"
-	for_array(i, c->procs) {
-		ProcedureInfo *pi = &c->procs.e[i];
-		CheckerContext prev_context = c->context;
-		add_curr_ast_file(c, pi->file);
-
-		bool bounds_check    = (pi->tags & ProcTag_bounds_check)    != 0;
-		bool no_bounds_check = (pi->tags & ProcTag_no_bounds_check) != 0;
-
-
-		if (bounds_check) {
-			c->context.stmt_state_flags |= StmtStateFlag_bounds_check;
-			c->context.stmt_state_flags &= ~StmtStateFlag_no_bounds_check;
-		} else if (no_bounds_check) {
-			c->context.stmt_state_flags |= StmtStateFlag_no_bounds_check;
-			c->context.stmt_state_flags &= ~StmtStateFlag_bounds_check;
+	if (build_context.parallel_check && build_context.thread_count > 1) {
+		check_proc_bodies_parallel(c);
+	} else {
+		// NOTE(bill): Nested procedures bodies will be added to this "queue"
+		for_array(i, c->procs) {
+			check_proc_info(c, c->procs.e[i]);
 		}
-
-		check_proc_body(c, pi->token, pi->decl, pi->type, pi->body);
-
-		c->context = prev_context;
 	}
 
 	// Add untyped expression values
@@ -1975,16 +2594,8 @@ void check_parsed_files(Checker *c) {
 		}
 	}
 
-	// NOTE(bill): Check for illegal cyclic type declarations
-	for_array(i, c->info.definitions.entries) {
-		Entity *e = c->info.definitions.entries.e[i].value;
-		if (e->kind == Entity_TypeName) {
-			if (e->type != NULL) {
-				// i64 size  = type_size_of(c->sizes, c->allocator, e->type);
-				i64 align = type_align_of(c->allocator, e->type);
-			}
-		}
-	}
+	// NOTE: Check for illegal cyclic type declarations and memoize the layouts of all named types
+	compute_type_layouts(c);
 
 	for_array(i, file_scopes.entries) {
 		Scope *s = file_scopes.entries.e[i].value;
@@ -1992,13 +2603,8 @@ void check_parsed_files(Checker *c) {
 			Entity *e = current_scope_lookup_entity(s, str_lit("main"));
 			if (e == NULL) {
 				Token token = {0};
-				if (s->file->tokens.count > 0) {
-					token = s->file->tokens.e[0];
-				} else {
-					token.pos.file = s->file->tokenizer.fullpath;
-					token.pos.line = 1;
-					token.pos.column = 1;
-				}
+				token.pos.file_id = s->file->tokenizer.file_id;
+				token.pos.offset  = 0;
 
 				error(token, "Undefined entry point procedure `main`");
 			}
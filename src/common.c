@@ -3,6 +3,7 @@
 #include "gb/gb.h"
 
 #include <math.h>
+#include <string.h> // NOTE: `memcpy` for unaligned loads
 
 gbAllocator heap_allocator(void) {
 	return gb_heap_allocator();
@@ -27,6 +28,104 @@ gbAllocator scratch_allocator(void) {
 }
 
 
+// NOTE: Unlike a gbArena, this does not need to know its total size up front. It is a
+// chain of blocks and a new block is added whenever the current one runs out.
+typedef struct ArenaBlock {
+	struct ArenaBlock *prev;
+	isize              size; // NOTE: Usable bytes which follow the header
+	isize              used;
+} ArenaBlock;
+
+typedef struct Arena {
+	gbAllocator backing;
+	ArenaBlock *curr;
+	isize       block_size;
+	isize       total_reserved;
+	isize       total_used;
+} Arena;
+
+void arena_init(Arena *arena, gbAllocator backing, isize block_size) {
+	GB_ASSERT(block_size > 0);
+	gb_zero_item(arena);
+	arena->backing    = backing;
+	arena->block_size = block_size;
+}
+
+void arena_free(Arena *arena) {
+	ArenaBlock *b = arena->curr;
+	while (b != NULL) {
+		ArenaBlock *prev = b->prev;
+		gb_free(arena->backing, b);
+		b = prev;
+	}
+	arena->curr = NULL;
+	arena->total_reserved = 0;
+	arena->total_used = 0;
+}
+
+void *arena_alloc(Arena *arena, isize size, isize alignment) {
+	ArenaBlock *b = arena->curr;
+	if (b != NULL) {
+		u8 *base = cast(u8 *)(b+1);
+		u8 *ptr = cast(u8 *)gb_align_forward(base + b->used, alignment);
+		isize end = (ptr - base) + size;
+		if (end <= b->size) {
+			arena->total_used += end - b->used;
+			b->used = end;
+			return ptr;
+		}
+	}
+
+	isize block_size = gb_max(arena->block_size, size + alignment);
+	// NOTE: Do not clear the block as each allocation is cleared as it is handed out
+	b = cast(ArenaBlock *)arena->backing.proc(arena->backing.data, gbAllocation_Alloc,
+	                                          gb_size_of(ArenaBlock) + block_size, GB_DEFAULT_MEMORY_ALIGNMENT,
+	                                          NULL, 0, 0);
+	if (b == NULL) {
+		return NULL;
+	}
+	b->prev = arena->curr;
+	b->size = block_size;
+	b->used = 0;
+	arena->curr = b;
+	arena->total_reserved += block_size;
+	return arena_alloc(arena, size, alignment);
+}
+
+GB_ALLOCATOR_PROC(arena_allocator_proc) {
+	Arena *arena = cast(Arena *)allocator_data;
+	void *ptr = NULL;
+
+	switch (type) {
+	case gbAllocation_Alloc:
+		ptr = arena_alloc(arena, size, alignment);
+		if (ptr != NULL && (flags & gbAllocatorFlag_ClearToZero)) {
+			gb_zero_size(ptr, size);
+		}
+		break;
+
+	case gbAllocation_Free:
+		// NOTE: Everything is freed at once with `arena_free`
+		break;
+
+	case gbAllocation_FreeAll:
+		arena_free(arena);
+		break;
+
+	case gbAllocation_Resize: {
+		gbAllocator a = {arena_allocator_proc, arena};
+		ptr = gb_default_resize_align(a, old_memory, old_size, size, alignment);
+	} break;
+	}
+	return ptr;
+}
+
+gbAllocator arena_allocator(Arena *arena) {
+	gbAllocator a = {arena_allocator_proc, arena};
+	return a;
+}
+
+
 i64 next_pow2(i64 n) {
 	if (n <= 0) {
 		return 0;
@@ -55,6 +55,7 @@ typedef struct Entity Entity;
 struct Entity {
 	EntityKind kind;
 	u32        flags;
+	i32        id; // NOTE: Dense and starts at 1, see `entity_id_count`
 	Token      token;
 	Scope *    scope;
 	Type *     type;
@@ -136,12 +137,21 @@ bool is_entity_exported(Entity *e) {
 }
 
 
+gb_global gbAtomic32 global_entity_id = {0}; // NOTE: The last id handed out
+
+i32 entity_id_count(void) {
+	return gb_atomic32_load(&global_entity_id)+1;
+}
+
 Entity *alloc_entity(gbAllocator a, EntityKind kind, Scope *scope, Token token, Type *type) {
 	Entity *entity = gb_alloc_item(a, Entity);
 	entity->kind   = kind;
+	entity->id     = gb_atomic32_fetch_add(&global_entity_id, 1)+1;
 	entity->scope  = scope;
 	entity->token  = token;
 	entity->type   = type;
+	// NOTE: Entity names are always interned, see `lookup_field_with_selection`
+	entity->token.string = intern_string(token.string);
 	return entity;
 }
 
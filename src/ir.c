@@ -8,7 +8,7 @@ typedef Array(irValue *) irValueArray;
 #define MAP_TYPE irValue *
 #define MAP_PROC map_ir_value_
 #define MAP_NAME MapIrValue
-#include "map.c"
+#include "open_map.c"
 
 #define MAP_TYPE irDebugInfo *
 #define MAP_PROC map_ir_debug_info_
@@ -30,7 +30,7 @@ typedef struct irModule {
 	String layout;
 	// String triple;
 
-	MapEntity             min_dep_map; // Key: Entity *
+	EntitySet             min_dep_set;
 	MapIrValue            values;      // Key: Entity *
 	MapIrValue            members;     // Key: String
 	MapString             type_names;  // Key: Type *
@@ -44,6 +44,12 @@ typedef struct irModule {
 	irValueArray          procs_to_generate; // NOTE(bill): Procedures to generate
 
 	Array(String)         foreign_library_paths; // Only the ones that were used
+
+	// NOTE: For `-show-timings`
+	isize                 instr_count_before_opt;
+	isize                 instr_count_after_opt;
+	i64                   print_byte_count;
+	u64                   print_time; // NOTE: In `time_stamp__freq` units
 } irModule;
 
 // NOTE(bill): For more info, see https://en.wikipedia.org/wiki/Dominator_(graph_theory)
@@ -546,6 +552,8 @@ struct irDebugInfo {
 typedef struct irGen {
 	irModule module;
 	gbFile   output_file;
+	String   output_base; // NOTE: Path of the output files without their extensions
+	String   init_dir; // NOTE: Directory of the initial file, ends with a separator
 	bool     opt_called;
 } irGen;
 
@@ -1070,7 +1078,8 @@ irValue *ir_value_procedure(gbAllocator a, irModule *m, Entity *entity, Type *ty
 irValue *ir_generate_array(irModule *m, Type *elem_type, i64 count, String prefix, i64 id) {
 	gbAllocator a = m->allocator;
 	Token token = {Token_Ident};
-	isize name_len = prefix.len + 10;
+	// NOTE: "-", up to 16 hex digits for the id and the NUL
+	isize name_len = prefix.len + 1 + 16 + 1;
 	token.string.text = gb_alloc_array(a, u8, name_len);
 	token.string.len = gb_snprintf(cast(char *)token.string.text, name_len,
 	                               "%.*s-%llx", LIT(prefix), id)-1;
@@ -1085,9 +1094,9 @@ irValue *ir_generate_array(irModule *m, Type *elem_type, i64 count, String prefi
 irBlock *ir_new_block(irProcedure *proc, AstNode *node, char *label) {
 	Scope *scope = NULL;
 	if (node != NULL) {
-		Scope **found = map_scope_get(&proc->module->info->scopes, hash_pointer(node));
+		Scope *found = scope_of_node(proc->module->info, node);
 		if (found) {
-			scope = *found;
+			scope = found;
 		} else {
 			GB_PANIC("Block scope not found for %.*s", LIT(ast_node_strings[node->kind]));
 		}
@@ -1187,6 +1196,20 @@ irValue *ir_add_module_constant(irModule *m, Type *type, ExactValue value) {
 	return ir_value_constant(a, type, value);
 }
 
+// NOTE: The global is not added to a module, see `ir_print_procs_parallel`
+irValue *ir_make_global_string_array(gbAllocator a, String name, String string) {
+	Token token = {Token_String};
+	token.string = name;
+	Type *type = make_type_array(a, t_u8, string.len);
+	ExactValue ev = exact_value_string(string);
+	Entity *entity = make_entity_constant(a, NULL, token, type, ev);
+	irValue *g = ir_value_global(a, entity, ir_value_constant(a, type, ev));
+	g->Global.is_private      = true;
+	// g->Global.is_unnamed_addr = true;
+	// g->Global.is_constant = true;
+	return g;
+}
+
 irValue *ir_add_global_string_array(irModule *m, String string) {
 	// TODO(bill): Should this use the arena allocator or the heap allocator?
 	// Strings could be huge!
@@ -1199,17 +1222,9 @@ irValue *ir_add_global_string_array(irModule *m, String string) {
 	m->global_string_index++;
 
 	String name = make_string(str, len-1);
-	Token token = {Token_String};
-	token.string = name;
-	Type *type = make_type_array(a, t_u8, string.len);
-	ExactValue ev = exact_value_string(string);
-	Entity *entity = make_entity_constant(a, NULL, token, type, ev);
-	irValue *g = ir_value_global(a, entity, ir_add_module_constant(m, type, ev));
-	g->Global.is_private      = true;
-	// g->Global.is_unnamed_addr = true;
-	// g->Global.is_constant = true;
+	irValue *g = ir_make_global_string_array(a, name, string);
 
-	ir_module_add_value(m, entity, g);
+	ir_module_add_value(m, g->Global.entity, g);
 	map_ir_value_set(&m->members, hash_string(name), g);
 
 	return g;
@@ -1239,9 +1254,8 @@ irValue *ir_add_local(irProcedure *proc, Entity *e, AstNode *expr) {
 }
 
 irValue *ir_add_local_for_identifier(irProcedure *proc, AstNode *name, bool zero_initialized) {
-	Entity **found = map_entity_get(&proc->module->info->definitions, hash_pointer(name));
-	if (found) {
-		Entity *e = *found;
+	Entity *e = entity_of_definition(proc->module->info, name);
+	if (e != NULL) {
 		ir_emit_comment(proc, e->token.string);
 		return ir_add_local(proc, e, name);
 	}
@@ -1437,8 +1451,11 @@ void ir_emit_jump(irProcedure *proc, irBlock *target_block) {
 	if (b == NULL) {
 		return;
 	}
-	ir_emit(proc, ir_instr_jump(proc, target_block));
-	ir_add_edge(b, target_block);
+	// NOTE: `ir_emit` drops the jump if the block has already returned, so there is no edge
+	if (!ir_is_instr_terminating(ir_get_last_instr(b))) {
+		ir_emit(proc, ir_instr_jump(proc, target_block));
+		ir_add_edge(b, target_block);
+	}
 	ir_start_block(proc, NULL);
 }
 
@@ -1447,9 +1464,11 @@ void ir_emit_if(irProcedure *proc, irValue *cond, irBlock *true_block, irBlock *
 	if (b == NULL) {
 		return;
 	}
-	ir_emit(proc, ir_instr_if(proc, cond, true_block, false_block));
-	ir_add_edge(b, true_block);
-	ir_add_edge(b, false_block);
+	if (!ir_is_instr_terminating(ir_get_last_instr(b))) {
+		ir_emit(proc, ir_instr_if(proc, cond, true_block, false_block));
+		ir_add_edge(b, true_block);
+		ir_add_edge(b, false_block);
+	}
 	ir_start_block(proc, NULL);
 }
 
@@ -2267,7 +2286,7 @@ irValue *ir_emit_deep_field_gep(irProcedure *proc, irValue *e, Selection sel) {
 	Type *type = type_deref(ir_type(e));
 
 	for_array(i, sel.index) {
-		i32 index = cast(i32)sel.index.e[i];
+		i32 index = selection_index(&sel, i);
 		if (is_type_pointer(type)) {
 			type = type_deref(type);
 			e = ir_emit_load(proc, e);
@@ -2333,7 +2352,7 @@ irValue *ir_emit_deep_field_ev(irProcedure *proc, irValue *e, Selection sel) {
 	Type *type = ir_type(e);
 
 	for_array(i, sel.index) {
-		i32 index = cast(i32)sel.index.e[i];
+		i32 index = selection_index(&sel, i);
 		if (is_type_pointer(type)) {
 			type = type_deref(type);
 			e = ir_emit_load(proc, e);
@@ -2973,9 +2992,9 @@ irValue *ir_emit_union_cast(irProcedure *proc, irValue *value, Type *type, Token
 		irValue **args = gb_alloc_array(a, irValue *, 6);
 		args[0] = ok;
 
-		args[1] = ir_const_string(a, pos.file);
-		args[2] = ir_const_int(a, pos.line);
-		args[3] = ir_const_int(a, pos.column);
+		args[1] = ir_const_string(a, token_pos_file(pos));
+		args[2] = ir_const_int(a, token_pos_line(pos));
+		args[3] = ir_const_int(a, token_pos_column(pos));
 
 		args[4] = ir_type_info(proc, src_type);
 		args[5] = ir_type_info(proc, dst_type);
@@ -2990,25 +3009,11 @@ irValue *ir_emit_union_cast(irProcedure *proc, irValue *value, Type *type, Token
 isize ir_type_info_index(CheckerInfo *info, Type *type) {
 	type = default_type(type);
 
-	isize entry_index = -1;
 	HashKey key = hash_pointer(type);
-	isize *found_entry_index = map_isize_get(&info->type_info_map, key);
-	if (found_entry_index) {
-		entry_index = *found_entry_index;
-	}
-	if (entry_index < 0) {
-		// NOTE(bill): Do manual search
-		// TODO(bill): This is O(n) and can be very slow
-		for_array(i, info->type_info_map.entries){
-			MapIsizeEntry *e = &info->type_info_map.entries.e[i];
-			Type *prev_type = cast(Type *)e->key.ptr;
-			if (are_types_identical(prev_type, type)) {
-				entry_index = e->value;
-				// NOTE(bill): Add it to the search map
-				map_isize_set(&info->type_info_map, key, entry_index);
-				break;
-			}
-		}
+	isize entry_index = find_type_info_index(info, type);
+	if (entry_index >= 0 && map_isize_get(&info->type_info_map, key) == NULL) {
+		// NOTE(bill): Add it to the search map
+		map_isize_set(&info->type_info_map, key, entry_index);
 	}
 
 	if (entry_index < 0) {
@@ -3137,14 +3142,190 @@ void ir_emit_slice_bounds_check(irProcedure *proc, Token token, irValue *low, ir
 //
 ////////////////////////////////////////////////////////////////
 
+bool ir_is_path_separator(u8 c) {
+	return c == '/' || c == '\\';
+}
+
+// NOTE: Where a file lives, `core:` or `project:`, and its path from there with `/` separators, so
+// that it is the same wherever the sources are checked out and whatever order they were imported in.
+// Project files are relative to the directory of the initial file, using `..` if they are outside it
+gbString ir_mangle_package_path(irGen *s, String path) {
+	gbAllocator a = heap_allocator();
+	gbString str = NULL;
+
+	String root = build_context.ODIN_ROOT;
+	String core = str_lit("core");
+	if (str_has_prefix(path, root) &&
+	    path.len > root.len+core.len &&
+	    str_eq(make_string(path.text+root.len, core.len), core) &&
+	    ir_is_path_separator(path.text[root.len+core.len])) {
+		isize skip = root.len+core.len+1;
+		str = gb_string_make(a, "core:");
+		str = gb_string_append_length(str, path.text+skip, path.len-skip);
+	} else {
+		String dir = s->init_dir;
+		isize common = 0; // NOTE: Length of the leading directories shared with `dir`
+		for (isize i = 0; i < dir.len && i < path.len; i++) {
+			if (ir_is_path_separator(dir.text[i]) && ir_is_path_separator(path.text[i])) {
+				common = i+1;
+			} else if (dir.text[i] != path.text[i]) {
+				break;
+			}
+		}
+		str = gb_string_make(a, "project:");
+		for (isize i = common; i < dir.len; i++) {
+			if (ir_is_path_separator(dir.text[i])) {
+				str = gb_string_appendc(str, "../");
+			}
+		}
+		str = gb_string_append_length(str, path.text+common, path.len-common);
+	}
+
+	isize len = gb_string_length(str);
+	for (isize i = 0; i < len; i++) {
+		if (str[i] == '\\') {
+			str[i] = '/';
+		}
+	}
+	return str;
+}
+
+u32 ir_mangle_package_hash(irGen *s, String path) {
+	gbString package_path = ir_mangle_package_path(s, path);
+	u32 hash = gb_fnv32a(package_path, gb_string_length(package_path));
+	gb_string_free(package_path);
+	return hash;
+}
+
+// NOTE: Like `write_type_to_string` but a named type is written with the hash of the package it is
+// declared in, as two packages may declare types of the same name and overloads on them must differ
+gbString ir_write_mangle_signature(irGen *s, gbString str, Type *type) {
+	if (type == NULL) {
+		return gb_string_appendc(str, "<no type>");
+	}
+
+	switch (type->kind) {
+	case Type_Named: {
+		Entity *type_name = type->Named.type_name;
+		if (type_name != NULL && token_pos_is_valid(type_name->token.pos)) {
+			u32 package_hash = ir_mangle_package_hash(s, token_pos_file(type_name->token.pos));
+			str = gb_string_appendc(str, gb_bprintf("%08x.", package_hash));
+		}
+		str = gb_string_append_length(str, type->Named.name.text, type->Named.name.len);
+	} break;
+
+	case Type_Pointer:
+		str = gb_string_appendc(str, "^");
+		str = ir_write_mangle_signature(s, str, type->Pointer.elem);
+		break;
+
+	case Type_Array:
+		str = gb_string_appendc(str, gb_bprintf("[%lld]", type->Array.count));
+		str = ir_write_mangle_signature(s, str, type->Array.elem);
+		break;
+
+	case Type_Vector:
+		str = gb_string_appendc(str, gb_bprintf("[vector %lld]", type->Vector.count));
+		str = ir_write_mangle_signature(s, str, type->Vector.elem);
+		break;
+
+	case Type_Slice:
+		str = gb_string_appendc(str, "[]");
+		str = ir_write_mangle_signature(s, str, type->Slice.elem);
+		break;
+
+	case Type_DynamicArray:
+		str = gb_string_appendc(str, "[dynamic]");
+		str = ir_write_mangle_signature(s, str, type->DynamicArray.elem);
+		break;
+
+	case Type_Map:
+		str = gb_string_appendc(str, gb_bprintf("map[%lld, ", type->Map.count));
+		str = ir_write_mangle_signature(s, str, type->Map.key);
+		str = gb_string_appendc(str, "]");
+		str = ir_write_mangle_signature(s, str, type->Map.value);
+		break;
+
+	case Type_Record:
+		str = gb_string_appendc(str, gb_bprintf("record%d%s%s{", type->Record.kind,
+		                                        type->Record.is_packed  ? " #packed"  : "",
+		                                        type->Record.is_ordered ? " #ordered" : ""));
+		if (type->Record.kind == TypeRecord_Enum && type->Record.enum_base_type != NULL) {
+			str = ir_write_mangle_signature(s, str, type->Record.enum_base_type);
+			str = gb_string_appendc(str, ";");
+		}
+		for (isize i = 0; i < type->Record.field_count; i++) {
+			Entity *f = type->Record.fields[i];
+			str = gb_string_append_length(str, f->token.string.text, f->token.string.len);
+			if (f->kind == Entity_Variable) {
+				str = gb_string_appendc(str, ": ");
+				str = ir_write_mangle_signature(s, str, f->type);
+			}
+			str = gb_string_appendc(str, ", ");
+		}
+		for (isize i = 1; i < type->Record.variant_count; i++) {
+			Entity *v = type->Record.variants[i];
+			str = gb_string_append_length(str, v->token.string.text, v->token.string.len);
+			str = gb_string_appendc(str, ": ");
+			str = ir_write_mangle_signature(s, str, base_type(v->type));
+			str = gb_string_appendc(str, ", ");
+		}
+		str = gb_string_appendc(str, "}");
+		break;
+
+	case Type_Tuple:
+		for (isize i = 0; i < type->Tuple.variable_count; i++) {
+			Entity *var = type->Tuple.variables[i];
+			if (var == NULL) {
+				continue;
+			}
+			if (i > 0) {
+				str = gb_string_appendc(str, ", ");
+			}
+			if (var->flags&EntityFlag_Ellipsis) {
+				str = gb_string_appendc(str, "..");
+			}
+			str = ir_write_mangle_signature(s, str, var->type);
+		}
+		break;
+
+	case Type_Proc:
+		str = gb_string_appendc(str, "proc(");
+		if (type->Proc.params != NULL) {
+			str = ir_write_mangle_signature(s, str, type->Proc.params);
+		}
+		str = gb_string_appendc(str, ")");
+		if (type->Proc.results != NULL) {
+			str = gb_string_appendc(str, " -> ");
+			str = ir_write_mangle_signature(s, str, type->Proc.results);
+		}
+		str = gb_string_appendc(str, gb_bprintf(" #cc%d", type->Proc.calling_convention));
+		break;
+
+	default:
+		str = write_type_to_string(str, type);
+		break;
+	}
+
+	return str;
+}
+
+// NOTE: Overloads of a name in the same file only differ by their signature, so that is what tells
+// them apart. Adding, removing, or reordering the other overloads leaves the name of each one alone
+u64 ir_mangle_signature_hash(irGen *s, Type *type) {
+	gbString signature = ir_write_mangle_signature(s, gb_string_make(heap_allocator(), ""), type);
+	u64 hash = gb_fnv64a(signature, gb_string_length(signature));
+	gb_string_free(signature);
+	return hash;
+}
+
 String ir_mangle_name(irGen *s, String path, Entity *e) {
 	// NOTE(bill): prefix names not in the init scope
-	// TODO(bill): make robust and not just rely on the file's name
+	// NOTE: The name must only depend upon the source so that the same source gives the same
+	// symbols in every build
 	String name = e->token.string;
 	irModule *m = &s->module;
-	CheckerInfo *info = m->info;
 	gbAllocator a = m->allocator;
-	AstFile *file = *map_ast_file_get(&info->files, hash_string(path));
 
 	char *str = gb_alloc_array(a, char, path.len+1);
 	gb_memmove(str, path.text, path.len);
@@ -3159,23 +3340,26 @@ String ir_mangle_name(irGen *s, String path, Entity *e) {
 	char const *ext = gb_path_extension(base);
 	isize base_len = ext-1-base;
 
-	isize max_len = base_len + 1 + 10 + 1 + name.len;
+	u32 path_hash = ir_mangle_package_hash(s, path);
+
+	// NOTE: `gb_snprintf` needs a spare byte after the null terminator
+	isize max_len = base_len + 1 + 8 + 1 + name.len + 2;
 	bool is_overloaded = check_is_entity_overloaded(e);
 	if (is_overloaded) {
-		max_len += 21;
+		max_len += 1 + 16;
 	}
 
 	u8 *new_name = gb_alloc_array(a, u8, max_len);
 	isize new_name_len = gb_snprintf(
 		cast(char *)new_name, max_len,
-		"%.*s-%u.%.*s",
+		"%.*s-%08x.%.*s",
 		cast(int)base_len, base,
-		file->id,
+		path_hash,
 		LIT(name));
 	if (is_overloaded) {
 		char *str = cast(char *)new_name + new_name_len-1;
-		isize len = max_len-new_name_len;
-		isize extra = gb_snprintf(str, len, "-%tu", cast(usize)cast(uintptr)e);
+		isize len = max_len-new_name_len+1;
+		isize extra = gb_snprintf(str, len, "-%016llx", cast(unsigned long long)ir_mangle_signature_hash(s, e->type));
 		new_name_len += extra-1;
 	}
 
@@ -3202,9 +3386,8 @@ void ir_mangle_add_sub_type_name(irModule *m, Entity *field, String parent) {
 
 irBranchBlocks ir_lookup_branch_blocks(irProcedure *proc, AstNode *ident) {
 	GB_ASSERT(ident->kind == AstNode_Ident);
-	Entity **found = map_entity_get(&proc->module->info->uses, hash_pointer(ident));
-	GB_ASSERT(found != NULL);
-	Entity *e = *found;
+	Entity *e = entity_of_use(proc->module->info, ident);
+	GB_ASSERT(e != NULL);
 	GB_ASSERT(e->kind == Entity_Label);
 	for_array(i, proc->branch_blocks) {
 		irBranchBlocks *b = &proc->branch_blocks.e[i];
@@ -3312,7 +3495,7 @@ void ir_build_stmt_list(irProcedure *proc, AstNodeArray stmts);
 irValue *ir_build_expr(irProcedure *proc, AstNode *expr) {
 	expr = unparen_expr(expr);
 
-	TypeAndValue *tv = map_tav_get(&proc->module->info->types, hash_pointer(expr));
+	TypeAndValue *tv = type_and_value_of_expression(proc->module->info, expr);
 	GB_ASSERT_NOT_NULL(tv);
 
 	if (tv->value.kind != ExactValue_Invalid) {
@@ -3326,12 +3509,12 @@ irValue *ir_build_expr(irProcedure *proc, AstNode *expr) {
 	switch (expr->kind) {
 	case_ast_node(bl, BasicLit, expr);
 		TokenPos pos = bl->pos;
-		GB_PANIC("Non-constant basic literal %.*s(%td:%td) - %.*s", LIT(pos.file), pos.line, pos.column, LIT(token_strings[bl->kind]));
+		GB_PANIC("Non-constant basic literal %.*s(%td:%td) - %.*s", LIT(token_pos_file(pos)), token_pos_line(pos), token_pos_column(pos), LIT(token_strings[bl->kind]));
 	case_end;
 
 	case_ast_node(bd, BasicDirective, expr);
 		TokenPos pos = bd->token.pos;
-		GB_PANIC("Non-constant basic literal %.*s(%td:%td) - %.*s", LIT(pos.file), pos.line, pos.column, LIT(bd->name));
+		GB_PANIC("Non-constant basic literal %.*s(%td:%td) - %.*s", LIT(token_pos_file(pos)), token_pos_line(pos), token_pos_column(pos), LIT(bd->name));
 	case_end;
 
 	case_ast_node(i, Implicit, expr);
@@ -3339,12 +3522,12 @@ irValue *ir_build_expr(irProcedure *proc, AstNode *expr) {
 	case_end;
 
 	case_ast_node(i, Ident, expr);
-		Entity *e = *map_entity_get(&proc->module->info->uses, hash_pointer(expr));
+		Entity *e = entity_of_use(proc->module->info, expr);
 		if (e->kind == Entity_Builtin) {
 			Token token = ast_node_token(expr);
 			GB_PANIC("TODO(bill): ir_build_single_expr Entity_Builtin `%.*s`\n"
 			         "\t at %.*s(%td:%td)", LIT(builtin_procs[e->Builtin.id].name),
-			         LIT(token.pos.file), token.pos.line, token.pos.column);
+			         LIT(token_pos_file(token.pos)), token_pos_line(token.pos), token_pos_column(token.pos));
 			return NULL;
 		} else if (e->kind == Entity_Nil) {
 			return ir_value_nil(proc->module->allocator, tv->type);
@@ -3377,7 +3560,7 @@ irValue *ir_build_expr(irProcedure *proc, AstNode *expr) {
 	case_end;
 
 	case_ast_node(se, SelectorExpr, expr);
-		TypeAndValue *tav = map_tav_get(&proc->module->info->types, hash_pointer(expr));
+		TypeAndValue *tav = type_and_value_of_expression(proc->module->info, expr);
 		GB_ASSERT(tav != NULL);
 		return ir_addr_load(proc, ir_build_addr(proc, expr));
 	case_end;
@@ -3560,7 +3743,7 @@ irValue *ir_build_expr(irProcedure *proc, AstNode *expr) {
 
 
 	case_ast_node(ce, CallExpr, expr);
-		if (map_tav_get(&proc->module->info->types, hash_pointer(ce->proc))->mode == Addressing_Type) {
+		if (type_and_value_of_expression(proc->module->info, ce->proc)->mode == Addressing_Type) {
 			GB_ASSERT(ce->args.count == 1);
 			irValue *x = ir_build_expr(proc, ce->args.e[0]);
 			irValue *y = ir_emit_conv(proc, x, tv->type);
@@ -3569,9 +3752,8 @@ irValue *ir_build_expr(irProcedure *proc, AstNode *expr) {
 
 		AstNode *p = unparen_expr(ce->proc);
 		if (p->kind == AstNode_Ident) {
-			Entity **found = map_entity_get(&proc->module->info->uses, hash_pointer(p));
-			if (found && (*found)->kind == Entity_Builtin) {
-				Entity *e = *found;
+			Entity *e = entity_of_use(proc->module->info, p);
+			if (e != NULL && e->kind == Entity_Builtin) {
 				switch (e->Builtin.id) {
 				case BuiltinProc_type_info: {
 					Type *t = default_type(type_of_expr(proc->module->info, ce->args.e[0]));
@@ -3948,7 +4130,7 @@ irValue *ir_build_expr(irProcedure *proc, AstNode *expr) {
 					}
 
 					irValue **args = gb_alloc_array(proc->module->allocator, irValue *, arg_count);
-					bool vari_expand = ce->ellipsis.pos.line != 0;
+					bool vari_expand = token_pos_is_valid(ce->ellipsis.pos);
 
 					for_array(i, ce->args) {
 						irValue *a = ir_build_expr(proc, ce->args.e[i]);
@@ -4052,9 +4234,9 @@ irValue *ir_build_expr(irProcedure *proc, AstNode *expr) {
 
 
 					irValue **args = gb_alloc_array(proc->module->allocator, irValue *, 4);
-					args[0] = ir_const_string(proc->module->allocator, pos.file);
-					args[1] = ir_const_int(proc->module->allocator, pos.line);
-					args[2] = ir_const_int(proc->module->allocator, pos.column);
+					args[0] = ir_const_string(proc->module->allocator, token_pos_file(pos));
+					args[1] = ir_const_int(proc->module->allocator, token_pos_line(pos));
+					args[2] = ir_const_int(proc->module->allocator, token_pos_column(pos));
 					args[3] = ir_const_string(proc->module->allocator, expr_str);
 					ir_emit_global_call(proc, "__assert", args, 4);
 
@@ -4073,9 +4255,9 @@ irValue *ir_build_expr(irProcedure *proc, AstNode *expr) {
 					TokenPos pos = token.pos;
 
 					irValue **args = gb_alloc_array(proc->module->allocator, irValue *, 4);
-					args[0] = ir_const_string(proc->module->allocator, pos.file);
-					args[1] = ir_const_int(proc->module->allocator, pos.line);
-					args[2] = ir_const_int(proc->module->allocator, pos.column);
+					args[0] = ir_const_string(proc->module->allocator, token_pos_file(pos));
+					args[1] = ir_const_int(proc->module->allocator, token_pos_line(pos));
+					args[2] = ir_const_int(proc->module->allocator, token_pos_column(pos));
 					args[3] = msg;
 					ir_emit_global_call(proc, "__panic", args, 4);
 
@@ -4352,7 +4534,7 @@ irValue *ir_build_expr(irProcedure *proc, AstNode *expr) {
 		}
 		irValue **args = gb_alloc_array(proc->module->allocator, irValue *, arg_count);
 		bool variadic = proc_type_->Proc.variadic;
-		bool vari_expand = ce->ellipsis.pos.line != 0;
+		bool vari_expand = token_pos_is_valid(ce->ellipsis.pos);
 
 		for_array(i, ce->args) {
 			irValue *a = ir_build_expr(proc, ce->args.e[i]);
@@ -4756,7 +4938,7 @@ irAddr ir_build_addr(irProcedure *proc, AstNode *expr) {
 
 
 		case Type_Basic: { // Basic_string
-			TypeAndValue *tv = map_tav_get(&proc->module->info->types, hash_pointer(ie->expr));
+			TypeAndValue *tv = type_and_value_of_expression(proc->module->info, ie->expr);
 			irValue *str;
 			irValue *elem;
 			irValue *len;
@@ -4947,12 +5129,12 @@ irAddr ir_build_addr(irProcedure *proc, AstNode *expr) {
 					if (elem->kind == AstNode_FieldValue) {
 						ast_node(fv, FieldValue, elem);
 						Selection sel = lookup_field(proc->module->allocator, bt, fv->field->Ident.string, false);
-						index = sel.index.e[0];
+						index = selection_index(&sel, 0);
 						elem = fv->value;
 					} else {
 						TypeAndValue *tav = type_and_value_of_expression(proc->module->info, elem);
 						Selection sel = lookup_field(proc->module->allocator, bt, st->fields_in_src_order[field_index]->token.string, false);
-						index = sel.index.e[0];
+						index = selection_index(&sel, 0);
 					}
 
 					field = st->fields[index];
@@ -5099,12 +5281,12 @@ irAddr ir_build_addr(irProcedure *proc, AstNode *expr) {
 					if (elem->kind == AstNode_FieldValue) {
 						ast_node(fv, FieldValue, elem);
 						Selection sel = lookup_field(proc->module->allocator, bt, fv->field->Ident.string, false);
-						index = sel.index.e[0];
+						index = selection_index(&sel, 0);
 						elem = fv->value;
 					} else {
 						TypeAndValue *tav = type_and_value_of_expression(proc->module->info, elem);
 						Selection sel = lookup_field(proc->module->allocator, bt, field_names[field_index], false);
-						index = sel.index.e[0];
+						index = selection_index(&sel, 0);
 					}
 
 					field_expr = ir_build_expr(proc, elem);
@@ -5129,7 +5311,7 @@ irAddr ir_build_addr(irProcedure *proc, AstNode *expr) {
 	         "\tAstNode: %.*s @ "
 	         "%.*s(%td:%td)\n",
 	         LIT(ast_node_strings[expr->kind]),
-	         LIT(token_pos.file), token_pos.line, token_pos.column);
+	         LIT(token_pos_file(token_pos)), token_pos_line(token_pos), token_pos_column(token_pos));
 
 
 	return ir_addr(NULL);
@@ -5462,9 +5644,8 @@ void ir_build_range_interval(irProcedure *proc, AstNodeIntervalExpr *node, Type
 }
 
 void ir_store_type_case_implicit(irProcedure *proc, AstNode *clause, irValue *value) {
-	Entity **found = map_entity_get(&proc->module->info->implicits, hash_pointer(clause));
-	GB_ASSERT(found != NULL);
-	Entity *e = *found; GB_ASSERT(e != NULL);
+	Entity *e = implicit_entity_of_node(proc->module->info, clause);
+	GB_ASSERT(e != NULL);
 	irValue *x = ir_add_local(proc, e, NULL);
 	ir_emit_store(proc, x, value);
 }
@@ -5589,7 +5770,7 @@ void ir_build_stmt_internal(irProcedure *proc, AstNode *node) {
 					if (pd->body != NULL) {
 						CheckerInfo *info = proc->module->info;
 
-						if (map_entity_get(&proc->module->min_dep_map, hash_pointer(e)) == NULL) {
+						if (!entity_set_has(&proc->module->min_dep_set, e)) {
 							// NOTE(bill): Nothing depends upon it so doesn't need to be built
 							break;
 						}
@@ -6184,9 +6365,8 @@ void ir_build_stmt_internal(irProcedure *proc, AstNode *node) {
 
 			Entity *case_entity = NULL;
 			{
-				Entity **found = map_entity_get(&proc->module->info->implicits, hash_pointer(clause));
-				GB_ASSERT(found != NULL);
-				case_entity = *found;
+				case_entity = implicit_entity_of_node(proc->module->info, clause);
+				GB_ASSERT(case_entity != NULL);
 			}
 
 
@@ -6422,7 +6602,7 @@ void ir_build_proc(irValue *value, irProcedure *parent) {
 		irModule *m = proc->module;
 		CheckerInfo *info = m->info;
 		Entity *e = proc->entity;
-		String filename = e->token.pos.file;
+		String filename = token_pos_file(e->token.pos);
 		AstFile **found = map_ast_file_get(&info->files, hash_string(filename));
 		GB_ASSERT(found != NULL);
 		AstFile *f = *found;
@@ -6629,9 +6809,21 @@ bool ir_gen_init(irGen *s, Checker *c) {
 	ir_init_module(&s->module, c);
 	// s->module.generate_debug_info = false;
 
+	s->init_dir = c->parser->init_fullpath;
+	while (s->init_dir.len > 0) {
+		u8 last = s->init_dir.text[s->init_dir.len-1];
+		if (last == '/' || last == '\\') {
+			break;
+		}
+		s->init_dir.len--;
+	}
+
 	// TODO(bill): generate appropriate output name
 	int pos = cast(int)string_extension_position(c->parser->init_fullpath);
-	gbFileError err = gb_file_create(&s->output_file, gb_bprintf("%.*s.ll", pos, c->parser->init_fullpath.text));
+	s->output_base = make_string(c->parser->init_fullpath.text, pos);
+	// NOTE: opt writes "<base>.bc", so the bitcode it reads needs another name
+	char *ext = build_context.emit_llvm_text ? "ll" : "unopt.bc";
+	gbFileError err = gb_file_create(&s->output_file, gb_bprintf("%.*s.%s", pos, c->parser->init_fullpath.text, ext));
 	if (err != gbFileError_None) {
 		return false;
 	}
@@ -6748,7 +6940,7 @@ void ir_gen_tree(irGen *s) {
 	array_init_reserve(&global_variables, m->tmp_allocator, global_variable_max_count);
 
 	m->entry_point_entity = entry_point;
-	m->min_dep_map = generate_minimum_dependency_map(info, entry_point);
+	m->min_dep_set = generate_minimum_dependency_set(info, entry_point);
 
 	for_array(i, info->entities.entries) {
 		MapDeclInfoEntry *entry = &info->entities.entries.e[i];
@@ -6761,7 +6953,7 @@ void ir_gen_tree(irGen *s) {
 			continue;
 		}
 
-		if (map_entity_get(&m->min_dep_map, hash_pointer(e)) == NULL) {
+		if (!entity_set_has(&m->min_dep_set, e)) {
 			// NOTE(bill): Nothing depends upon it so doesn't need to be built
 			continue;
 		}
@@ -6772,7 +6964,7 @@ void ir_gen_tree(irGen *s) {
 				// Handle later
 			} else if (scope->is_init && e->kind == Entity_Procedure && str_eq(name, str_lit("main"))) {
 			} else {
-				name = ir_mangle_name(s, e->token.pos.file, e);
+				name = ir_mangle_name(s, token_pos_file(e->token.pos), e);
 			}
 		}
 
@@ -6793,7 +6985,7 @@ void ir_gen_tree(irGen *s) {
 			var.decl = decl;
 
 			if (decl->init_expr != NULL) {
-				TypeAndValue *tav = map_tav_get(&info->types, hash_pointer(decl->init_expr));
+				TypeAndValue *tav = type_and_value_of_expression(info, decl->init_expr);
 				if (tav != NULL) {
 					if (tav->value.kind != ExactValue_Invalid) {
 						ExactValue v = tav->value;
@@ -7505,6 +7697,9 @@ void ir_gen_tree(irGen *s) {
 		ir_build_proc(m->procs_to_generate.e[i], m->procs_to_generate.e[i]->Proc.parent);
 	}
 
+	// NOTE: Every procedure has been built so nothing else needs to know what is depended upon
+	entity_set_destroy(&m->min_dep_set, heap_allocator());
+
 	// Number debug info
 	for_array(i, m->debug_info.entries) {
 		MapIrDebugInfoEntry *entry = &m->debug_info.entries.e[i];
@@ -0,0 +1,1996 @@
+// NOTE: Writes the module as LLVM bitcode, so that `opt` reads it straight away rather than having
+// to parse the text which "ir_print.c" prints. Everything is written as the printer would print it
+// (`-emit-llvm-text` still prints the text for debugging), so the two can be compared with
+// `llvm-dis`. Only the names of the unnamed values, the parameters, and the blocks differ, along
+// with the string constants, which share a global per string rather than having one each, and the
+// unused declaration of `llvm.dbg.declare`, which is left out.
+//
+// This is the oldest form of the module that both the LLVM 4.0 tools in bin/ and the later ones
+// read: version 1 of the module block, operands relative to the instruction, the names in value
+// symbol tables rather than a string table, and every record unabbreviated.
+// The module is walked twice. The first walk finds every type and constant (and makes the globals
+// for the string constants), as all of them have to be written before the first procedure body.
+// The second walk writes the procedure bodies, using the same code with the records switched on.
+
+typedef enum irBcBlockId {
+	irBcBlock_Module         = 8,
+	irBcBlock_ParamAttr      = 9,
+	irBcBlock_ParamAttrGroup = 10,
+	irBcBlock_Constants      = 11,
+	irBcBlock_Function       = 12,
+	irBcBlock_ValueSymtab    = 14,
+	irBcBlock_Type           = 17,
+} irBcBlockId;
+
+// NOTE: The record codes, named as in LLVM's "LLVMBitCodes.h"
+typedef enum irBcCode {
+	irBcModuleCode_Version        = 1,
+	irBcModuleCode_GlobalVar      = 7,
+	irBcModuleCode_Function       = 8,
+
+	irBcAttrCode_Entry            = 2,
+	irBcAttrCode_GroupEntry       = 3,
+
+	irBcTypeCode_NumEntry         = 1,
+	irBcTypeCode_Void             = 2,
+	irBcTypeCode_Float            = 3,
+	irBcTypeCode_Double           = 4,
+	irBcTypeCode_Integer          = 7,
+	irBcTypeCode_Pointer          = 8,
+	irBcTypeCode_Array            = 11,
+	irBcTypeCode_Vector           = 12,
+	irBcTypeCode_StructAnon       = 18,
+	irBcTypeCode_StructName       = 19,
+	irBcTypeCode_StructNamed      = 20,
+	irBcTypeCode_Function         = 21,
+
+	irBcConstCode_SetType         = 1,
+	irBcConstCode_Null            = 2,
+	irBcConstCode_Integer         = 4,
+	irBcConstCode_Float           = 6,
+	irBcConstCode_Aggregate       = 7,
+	irBcConstCode_String          = 8,
+	irBcConstCode_Cast            = 11,
+	irBcConstCode_InboundsGep     = 20,
+
+	irBcFuncCode_DeclareBlocks    = 1,
+	irBcFuncCode_BinaryOp         = 2,
+	irBcFuncCode_Cast             = 3,
+	irBcFuncCode_Ret              = 10,
+	irBcFuncCode_Br               = 11,
+	irBcFuncCode_Unreachable      = 15,
+	irBcFuncCode_Phi              = 16,
+	irBcFuncCode_Alloca           = 19,
+	irBcFuncCode_Load             = 20,
+	irBcFuncCode_ExtractValue     = 26,
+	irBcFuncCode_Cmp              = 28,
+	irBcFuncCode_Select           = 29,
+	irBcFuncCode_Call             = 34,
+	irBcFuncCode_Gep              = 43,
+	irBcFuncCode_Store            = 44,
+
+	irBcSymtabCode_Entry          = 1,
+} irBcCode;
+
+typedef enum irBcAbbrevId {
+	irBcAbbrev_EndBlock      = 0,
+	irBcAbbrev_EnterSubblock = 1,
+	irBcAbbrev_Unabbreviated = 3,
+} irBcAbbrevId;
+
+// NOTE: No abbreviations are defined, so the ids above are all there is
+#define IR_BC_ABBREV_WIDTH 2
+
+typedef struct irBcBlockScope {
+	isize length_index; // NOTE: Index of the word which holds the length of the block
+	u32   abbrev_width;
+} irBcBlockScope;
+
+// NOTE: A bitstream is written from the lowest bit of each 32 bit little endian word upwards
+typedef struct irBitWriter {
+	Array(u32)            words;
+	u64                   bits; // NOTE: Bits not yet in `words`
+	u32                   bit_count;
+	u32                   abbrev_width;
+	Array(irBcBlockScope) blocks;
+} irBitWriter;
+
+void ir_bit_writer_init(irBitWriter *b) {
+	array_init(&b->words, heap_allocator());
+	array_init(&b->blocks, heap_allocator());
+	b->bits = 0;
+	b->bit_count = 0;
+	b->abbrev_width = IR_BC_ABBREV_WIDTH;
+}
+
+void ir_bit_writer_destroy(irBitWriter *b) {
+	array_free(&b->blocks);
+	array_free(&b->words);
+}
+
+void ir_bit_emit(irBitWriter *b, u32 value, u32 width) {
+	GB_ASSERT(width <= 32);
+	b->bits |= cast(u64)value << b->bit_count;
+	b->bit_count += width;
+	if (b->bit_count >= 32) {
+		array_add(&b->words, cast(u32)b->bits);
+		b->bits >>= 32;
+		b->bit_count -= 32;
+	}
+}
+
+void ir_bit_emit_vbr(irBitWriter *b, u64 value, u32 width) {
+	u64 threshold = 1ull << (width-1);
+	while (value >= threshold) {
+		ir_bit_emit(b, cast(u32)((value & (threshold-1)) | threshold), width);
+		value >>= width-1;
+	}
+	ir_bit_emit(b, cast(u32)value, width);
+}
+
+void ir_bit_align_32(irBitWriter *b) {
+	if (b->bit_count > 0) {
+		array_add(&b->words, cast(u32)b->bits);
+		b->bits = 0;
+		b->bit_count = 0;
+	}
+}
+
+void ir_bit_enter_block(irBitWriter *b, irBcBlockId id) {
+	ir_bit_emit(b, irBcAbbrev_EnterSubblock, b->abbrev_width);
+	ir_bit_emit_vbr(b, id, 8);
+	ir_bit_emit_vbr(b, IR_BC_ABBREV_WIDTH, 4);
+	ir_bit_align_32(b);
+
+	irBcBlockScope scope = {b->words.count, b->abbrev_width};
+	array_add(&b->blocks, scope);
+	array_add(&b->words, 0); // NOTE: Filled in by `ir_bit_exit_block`
+	b->abbrev_width = IR_BC_ABBREV_WIDTH;
+}
+
+void ir_bit_exit_block(irBitWriter *b) {
+	GB_ASSERT(b->blocks.count > 0);
+	ir_bit_emit(b, irBcAbbrev_EndBlock, b->abbrev_width);
+	ir_bit_align_32(b);
+
+	irBcBlockScope scope = b->blocks.e[b->blocks.count-1];
+	array_pop(&b->blocks);
+	// NOTE: The length is in words and does not include the length itself
+	b->words.e[scope.length_index] = cast(u32)(b->words.count - scope.length_index - 1);
+	b->abbrev_width = scope.abbrev_width;
+}
+
+void ir_bit_record(irBitWriter *b, irBcCode code, u64 *ops, isize op_count) {
+	ir_bit_emit(b, irBcAbbrev_Unabbreviated, b->abbrev_width);
+	ir_bit_emit_vbr(b, code, 6);
+	ir_bit_emit_vbr(b, op_count, 6);
+	for (isize i = 0; i < op_count; i++) {
+		ir_bit_emit_vbr(b, ops[i], 6);
+	}
+}
+
+
+typedef enum irBcTypeKind {
+	irBcType_Void,
+	irBcType_Int,
+	irBcType_Float,
+	irBcType_Pointer,
+	irBcType_Array,
+	irBcType_Vector,
+	irBcType_Struct,
+	irBcType_Proc,
+} irBcTypeKind;
+
+typedef struct irBcType irBcType;
+struct irBcType {
+	irBcTypeKind kind;
+	i32          id;        // NOTE: -1 until a named struct has its fields
+	i64          count;     // NOTE: Bits of an integer or a float, elements of an array or a vector
+	bool         is_packed;
+	String       name;      // NOTE: Only a named struct has one
+	irBcType *   elem;      // NOTE: Pointer, array, vector, and the result of a procedure
+	irBcType **  elems;     // NOTE: Fields of a struct, parameters of a procedure
+	isize        elem_count;
+};
+
+typedef enum irBcConstKind {
+	irBcConst_Null,
+	irBcConst_Int,
+	irBcConst_Float,
+	irBcConst_Aggregate,
+	irBcConst_String,
+	irBcConst_IntToPtr,
+	irBcConst_Gep,
+	irBcConst_Global, // NOTE: A global or a procedure, which is a value of the module and not a constant
+} irBcConstKind;
+
+typedef struct irBcConst irBcConst;
+struct irBcConst {
+	irBcConstKind kind;
+	irBcType *    type;
+	i32           index;  // NOTE: Into `constants`, -1 for irBcConst_Global
+	u64           value;  // NOTE: Sign extended for an integer, the bits of a float
+	String        string;
+	irValue *     global;
+	irBcConst **  elems;
+	isize         elem_count;
+};
+
+#define MAP_TYPE irBcType *
+#define MAP_PROC map_ir_bc_type_
+#define MAP_NAME MapIrBcType
+#include "open_map.c"
+
+#define MAP_TYPE irBcConst *
+#define MAP_PROC map_ir_bc_const_
+#define MAP_NAME MapIrBcConst
+#include "open_map.c"
+
+// NOTE: The flags of an attribute group, which are all for either the procedure or one parameter
+typedef enum irBcAttrFlag {
+	irBcAttr_AlwaysInline = 1<<0,
+	irBcAttr_NoInline     = 1<<1,
+	irBcAttr_NoAlias      = 1<<2,
+} irBcAttrFlag;
+
+#define IR_BC_PROC_ATTR_INDEX 0xffffffffull
+
+typedef struct irBcAttrList {
+	isize offset; // NOTE: Into `attr_list_groups`
+	isize count;
+} irBcAttrList;
+
+typedef struct irBcWriter {
+	irModule *    module;
+	irBitWriter   out;
+	Arena         arena;
+	gbAllocator   allocator;
+	gbArena       tmp_arena;     // NOTE: For the arrays a type or a constant is made from
+	gbAllocator   tmp_allocator;
+	bool          is_collecting; // NOTE: The first walk, the only time types and constants may be added
+	Array(u64)    ops;           // NOTE: Operands of the record being written
+
+	MapIrBcType        types;       // Key: Hash of the contents
+	MapIrBcType        type_cache;  // Key: Type *
+	MapIrBcType        named_types; // Key: String
+	Array(irBcType *)  type_table;  // NOTE: Index: id
+
+	MapIrBcConst       consts;      // Key: Hash of the contents
+	Array(irBcConst *) const_table; // NOTE: Index: index
+	MapIrValue         string_globals; // Key: String
+
+	// NOTE: Value ids, the procedures come first, then the globals, then the constants
+	Array(irProcedure *) procs;
+	irValueArray         globals;
+	MapIsize             value_ids;  // Key: irProcedure * or irValue * of a global
+	MapIsize             symbol_ids; // Key: String (as it is in the module)
+	Array(String)        symbols;    // NOTE: Index: value id
+	isize                const_base;
+
+	MapIsize            attr_groups; // Key: (index << 32) | irBcAttrFlag
+	Array(u64)          attr_group_keys;
+	Array(u32)          attr_list_groups;
+	Array(irBcAttrList) attr_lists;
+	MapIsize            attr_list_ids; // Key: Hash of the groups
+
+	// NOTE: The procedure being written
+	irProcedure *        proc;
+	u32                  param_base;
+	u32                  instr_base;
+	u32                  next_value; // NOTE: Operands are relative to this
+} irBcWriter;
+
+HashKey ir_bc_hash_key(u64 hash) {
+	HashKey h = {HashKey_Default};
+	h.key = hash;
+	return h;
+}
+
+void ir_bc_push(irBcWriter *w, u64 op) {
+	array_add(&w->ops, op);
+}
+
+void ir_bc_push_string(irBcWriter *w, String s) {
+	for (isize i = 0; i < s.len; i++) {
+		array_add(&w->ops, s.text[i]);
+	}
+}
+
+void ir_bc_record(irBcWriter *w, irBcCode code) {
+	if (!w->is_collecting) {
+		ir_bit_record(&w->out, code, w->ops.e, w->ops.count);
+	}
+	array_clear(&w->ops);
+}
+
+u64 ir_bc_signed(i64 v) {
+	// NOTE: The sign is in the lowest bit, so small negative numbers stay small
+	if (v >= 0) {
+		return cast(u64)v << 1;
+	}
+	return ((0ull - cast(u64)v) << 1) | 1;
+}
+
+u64 ir_bc_log2_align(i64 align) {
+	// NOTE: Alignments are written as log2(align)+1, zero is no alignment
+	u64 n = 0;
+	while ((1ll << n) < align) {
+		n++;
+	}
+	return n+1;
+}
+
+
+////////////////////////////////////////////////////////////////
+//
+// @Types
+//
+////////////////////////////////////////////////////////////////
+
+u64 ir_bc_type_hash(irBcType *t) {
+	struct {
+		irBcTypeKind kind;
+		bool         is_packed;
+		i64          count;
+		irBcType *   elem;
+		u64          elems;
+	} key;
+	gb_zero_item(&key); // NOTE: Padding is hashed too
+	key.kind      = t->kind;
+	key.is_packed = t->is_packed;
+	key.count     = t->count;
+	key.elem      = t->elem;
+	key.elems     = gb_fnv64a(t->elems, t->elem_count*gb_size_of(irBcType *));
+	return hashing_proc(&key, gb_size_of(key)).key;
+}
+
+bool ir_bc_type_equal(irBcType *a, irBcType *b) {
+	if (a->kind != b->kind || a->is_packed != b->is_packed || a->count != b->count ||
+	    a->elem != b->elem || a->elem_count != b->elem_count || a->name.len != 0) {
+		return false;
+	}
+	for (isize i = 0; i < a->elem_count; i++) {
+		if (a->elems[i] != b->elems[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void ir_bc_type_complete(irBcWriter *w, irBcType *t) {
+	t->id = cast(i32)w->type_table.count;
+	array_add(&w->type_table, t);
+}
+
+// NOTE: Types without a name are the same type if they have the same contents, as they are in LLVM,
+// and as every part of a type is made before the type itself, the parts can be compared by pointer
+irBcType *ir_bc_make_type(irBcWriter *w, irBcType t) {
+	HashKey key = ir_bc_hash_key(ir_bc_type_hash(&t));
+	for (MapIrBcTypeEntry *e = map_ir_bc_type_multi_find_first(&w->types, key);
+	     e != NULL;
+	     e = map_ir_bc_type_multi_find_next(&w->types, e)) {
+		if (ir_bc_type_equal(e->value, &t)) {
+			return e->value;
+		}
+	}
+	GB_ASSERT_MSG(w->is_collecting, "A type was not found in the first walk of the module");
+
+	irBcType *n = gb_alloc_item(w->allocator, irBcType);
+	*n = t;
+	if (t.elem_count > 0) {
+		n->elems = gb_alloc_array(w->allocator, irBcType *, t.elem_count);
+		gb_memcopy(n->elems, t.elems, t.elem_count*gb_size_of(irBcType *));
+	}
+	ir_bc_type_complete(w, n);
+	map_ir_bc_type_multi_insert(&w->types, key, n);
+	return n;
+}
+
+irBcType *ir_bc_type_basic(irBcWriter *w, irBcTypeKind kind, i64 count) {
+	irBcType t = {kind};
+	t.count = count;
+	return ir_bc_make_type(w, t);
+}
+
+irBcType *ir_bc_type_pointer(irBcWriter *w, irBcType *elem) {
+	irBcType t = {irBcType_Pointer};
+	t.elem = elem;
+	return ir_bc_make_type(w, t);
+}
+
+irBcType *ir_bc_type_array(irBcWriter *w, irBcTypeKind kind, i64 count, irBcType *elem) {
+	irBcType t = {kind};
+	t.count = count;
+	t.elem = elem;
+	return ir_bc_make_type(w, t);
+}
+
+irBcType *ir_bc_type_struct(irBcWriter *w, irBcType **elems, isize elem_count, bool is_packed) {
+	irBcType t = {irBcType_Struct};
+	t.elems = elems;
+	t.elem_count = elem_count;
+	t.is_packed = is_packed;
+	return ir_bc_make_type(w, t);
+}
+
+// NOTE: `{[0 x <align x i8>], ...}`, see the NOTE in `ir_print_type`
+irBcType *ir_bc_type_align_field(irBcWriter *w, i64 align) {
+	irBcType *bytes = ir_bc_type_array(w, irBcType_Vector, align, ir_bc_type_basic(w, irBcType_Int, 8));
+	return ir_bc_type_array(w, irBcType_Array, 0, bytes);
+}
+
+// NOTE: A named struct may be used (through a pointer) by its own fields, so it exists before them,
+// but it only gets an id once they do, as only a named struct may be used before its record
+irBcType *ir_bc_named_struct_begin(irBcWriter *w, String name, bool *is_new) {
+	irBcType **found = map_ir_bc_type_get(&w->named_types, hash_string(name));
+	if (found != NULL) {
+		*is_new = false;
+		return *found;
+	}
+	GB_ASSERT_MSG(w->is_collecting, "A type was not found in the first walk of the module: %.*s", LIT(name));
+	irBcType *t = gb_alloc_item(w->allocator, irBcType);
+	t->kind = irBcType_Struct;
+	t->id = -1;
+	t->name = name;
+	map_ir_bc_type_set(&w->named_types, hash_string(name), t);
+	*is_new = true;
+	return t;
+}
+
+void ir_bc_named_struct_end(irBcWriter *w, irBcType *t, irBcType *body) {
+	GB_ASSERT(body->kind == irBcType_Struct);
+	t->is_packed  = body->is_packed;
+	t->elems      = body->elems;
+	t->elem_count = body->elem_count;
+	ir_bc_type_complete(w, t);
+}
+
+irBcType *ir_bc_named_struct(irBcWriter *w, String name, irBcType **elems, isize elem_count) {
+	bool is_new = false;
+	irBcType *t = ir_bc_named_struct_begin(w, name, &is_new);
+	if (is_new) {
+		ir_bc_named_struct_end(w, t, ir_bc_type_struct(w, elems, elem_count, false));
+	}
+	return t;
+}
+
+irBcType *ir_bc_type(irBcWriter *w, Type *t);
+
+irBcType *ir_bc_proc_type(irBcWriter *w, Type *t) {
+	GB_ASSERT(t->kind == Type_Proc);
+	irBcType p = {irBcType_Proc};
+	if (t->Proc.result_count == 0) {
+		p.elem = ir_bc_type_basic(w, irBcType_Void, 0);
+	} else {
+		p.elem = ir_bc_type(w, t->Proc.results);
+	}
+
+	gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&w->tmp_arena);
+	p.elem_count = t->Proc.param_count;
+	p.elems = gb_alloc_array(w->tmp_allocator, irBcType *, p.elem_count);
+	TypeTuple *params = &t->Proc.params->Tuple;
+	for (isize i = 0; i < p.elem_count; i++) {
+		p.elems[i] = ir_bc_type(w, params->variables[i]->type);
+	}
+	irBcType *result = ir_bc_make_type(w, p);
+	gb_temp_arena_memory_end(tmp);
+	return result;
+}
+
+irBcType *ir_bc_type_uncached(irBcWriter *w, Type *t) {
+	i64 word_bits = 8*build_context.word_size;
+	irBcType *i8  = ir_bc_type_basic(w, irBcType_Int, 8);
+	irBcType *int_type = ir_bc_type_basic(w, irBcType_Int, word_bits);
+
+	switch (t->kind) {
+	case Type_Basic:
+		switch (t->Basic.kind) {
+		case Basic_bool: return ir_bc_type_basic(w, irBcType_Int, 1);
+		case Basic_i8:   return i8;
+		case Basic_u8:   return i8;
+		case Basic_i16:  return ir_bc_type_basic(w, irBcType_Int, 16);
+		case Basic_u16:  return ir_bc_type_basic(w, irBcType_Int, 16);
+		case Basic_i32:  return ir_bc_type_basic(w, irBcType_Int, 32);
+		case Basic_u32:  return ir_bc_type_basic(w, irBcType_Int, 32);
+		case Basic_i64:  return ir_bc_type_basic(w, irBcType_Int, 64);
+		case Basic_u64:  return ir_bc_type_basic(w, irBcType_Int, 64);
+
+		case Basic_f32:  return ir_bc_type_basic(w, irBcType_Float, 32);
+		case Basic_f64:  return ir_bc_type_basic(w, irBcType_Float, 64);
+
+		case Basic_complex64:
+		case Basic_complex128:
+		case Basic_quaternion128:
+		case Basic_quaternion256: {
+			irBcType *f = ir_bc_type_basic(w, irBcType_Float, 64);
+			isize count = 2;
+			String name = str_lit("..complex128");
+			switch (t->Basic.kind) {
+			case Basic_complex64:     f = ir_bc_type_basic(w, irBcType_Float, 32); name = str_lit("..complex64");     break;
+			case Basic_quaternion128: f = ir_bc_type_basic(w, irBcType_Float, 32); name = str_lit("..quaternion128"); count = 4; break;
+			case Basic_quaternion256: name = str_lit("..quaternion256"); count = 4; break;
+			}
+			irBcType *elems[4] = {f, f, f, f};
+			return ir_bc_named_struct(w, name, elems, count);
+		}
+
+		case Basic_rawptr: return ir_bc_type_pointer(w, i8);
+		case Basic_string: {
+			irBcType *elems[2] = {ir_bc_type_pointer(w, i8), int_type};
+			return ir_bc_named_struct(w, str_lit("..string"), elems, 2);
+		}
+		case Basic_uint: return int_type;
+		case Basic_int:  return int_type;
+		case Basic_any: {
+			irBcType *elems[2] = {ir_bc_type(w, t_type_info_ptr), ir_bc_type(w, t_rawptr)};
+			return ir_bc_named_struct(w, str_lit("..any"), elems, 2);
+		}
+		}
+		break;
+
+	case Type_Pointer:
+		return ir_bc_type_pointer(w, ir_bc_type(w, t->Pointer.elem));
+	case Type_Array:
+		return ir_bc_type_array(w, irBcType_Array, t->Array.count, ir_bc_type(w, t->Array.elem));
+	case Type_Vector: {
+		irBcType *elems[2] = {
+			ir_bc_type_align_field(w, type_align_of(heap_allocator(), t)),
+			ir_bc_type_array(w, irBcType_Array, t->Vector.count, ir_bc_type(w, t->Vector.elem)),
+		};
+		return ir_bc_type_struct(w, elems, 2, false);
+	}
+	case Type_Slice: {
+		irBcType *elems[3] = {ir_bc_type_pointer(w, ir_bc_type(w, t->Slice.elem)), int_type, int_type};
+		return ir_bc_type_struct(w, elems, 3, false);
+	}
+	case Type_DynamicArray: {
+		irBcType *elems[4] = {
+			ir_bc_type_pointer(w, ir_bc_type(w, t->DynamicArray.elem)), int_type, int_type,
+			ir_bc_type(w, t_allocator),
+		};
+		return ir_bc_type_struct(w, elems, 4, false);
+	}
+	case Type_Record: {
+		switch (t->Record.kind) {
+		case TypeRecord_Struct: {
+			gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&w->tmp_arena);
+			isize count = 0;
+			irBcType **elems = gb_alloc_array(w->tmp_allocator, irBcType *, t->Record.field_count+1);
+			if (t->Record.custom_align > 0) {
+				elems[count++] = ir_bc_type_align_field(w, t->Record.custom_align);
+			}
+			for (isize i = 0; i < t->Record.field_count; i++) {
+				elems[count++] = ir_bc_type(w, t->Record.fields[i]->type);
+			}
+			irBcType *result = ir_bc_type_struct(w, elems, count, t->Record.is_packed);
+			gb_temp_arena_memory_end(tmp);
+			return result;
+		}
+		case TypeRecord_Union: {
+			i64 size_of_union  = type_size_of(heap_allocator(), t) - build_context.word_size;
+			i64 align_of_union = type_align_of(heap_allocator(), t);
+			irBcType *elems[3] = {
+				ir_bc_type_align_field(w, align_of_union),
+				ir_bc_type_array(w, irBcType_Array, size_of_union, i8),
+				int_type,
+			};
+			return ir_bc_type_struct(w, elems, 3, false);
+		}
+		case TypeRecord_RawUnion: {
+			i64 size_of_union  = type_size_of(heap_allocator(), t);
+			i64 align_of_union = type_align_of(heap_allocator(), t);
+			irBcType *elems[2] = {
+				ir_bc_type_align_field(w, align_of_union),
+				ir_bc_type_array(w, irBcType_Array, size_of_union, i8),
+			};
+			return ir_bc_type_struct(w, elems, 2, false);
+		}
+		case TypeRecord_Enum:
+			return ir_bc_type(w, base_enum_type(t));
+		}
+	} break;
+
+	case Type_Named:
+		if (is_type_struct(t) || is_type_union(t)) {
+			String *name = map_string_get(&w->module->type_names, hash_pointer(t));
+			GB_ASSERT_MSG(name != NULL, "%.*s", LIT(t->Named.name));
+			bool is_new = false;
+			irBcType *named = ir_bc_named_struct_begin(w, *name, &is_new);
+			if (is_new) {
+				// NOTE: Cached before the fields, which may point back at it
+				map_ir_bc_type_set(&w->type_cache, hash_pointer(t), named);
+				ir_bc_named_struct_end(w, named, ir_bc_type(w, base_type(t->Named.base)));
+			}
+			return named;
+		}
+		return ir_bc_type(w, base_type(t));
+
+	case Type_Tuple:
+		if (t->Tuple.variable_count == 1) {
+			return ir_bc_type(w, t->Tuple.variables[0]->type);
+		} else {
+			gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&w->tmp_arena);
+			irBcType **elems = gb_alloc_array(w->tmp_allocator, irBcType *, t->Tuple.variable_count);
+			for (isize i = 0; i < t->Tuple.variable_count; i++) {
+				elems[i] = ir_bc_type(w, t->Tuple.variables[i]->type);
+			}
+			irBcType *result = ir_bc_type_struct(w, elems, t->Tuple.variable_count, false);
+			gb_temp_arena_memory_end(tmp);
+			return result;
+		}
+
+	case Type_Proc:
+		return ir_bc_type_pointer(w, ir_bc_proc_type(w, t));
+
+	case Type_Map:
+		GB_ASSERT(t->Map.generated_struct_type != NULL);
+		return ir_bc_type(w, t->Map.generated_struct_type);
+	}
+
+	GB_PANIC("Unhandled type: %s", type_to_string(t));
+	return NULL;
+}
+
+irBcType *ir_bc_type(irBcWriter *w, Type *t) {
+	GB_ASSERT_NOT_NULL(t);
+	t = default_type(t);
+	GB_ASSERT(is_type_typed(t));
+
+	irBcType **found = map_ir_bc_type_get(&w->type_cache, hash_pointer(t));
+	if (found != NULL) {
+		return *found;
+	}
+	irBcType *result = ir_bc_type_uncached(w, t);
+	map_ir_bc_type_set(&w->type_cache, hash_pointer(t), result);
+	return result;
+}
+
+u64 ir_bc_type_id(irBcType *t) {
+	GB_ASSERT(t->id >= 0);
+	return cast(u64)t->id;
+}
+
+
+////////////////////////////////////////////////////////////////
+//
+// @Constants
+//
+////////////////////////////////////////////////////////////////
+
+u64 ir_bc_const_hash(irBcConst *c) {
+	struct {
+		irBcConstKind kind;
+		irBcType *    type;
+		u64           value;
+		u64           string;
+		irValue *     global;
+		u64           elems;
+	} key;
+	gb_zero_item(&key); // NOTE: Padding is hashed too
+	key.kind   = c->kind;
+	key.type   = c->type;
+	key.value  = c->value;
+	key.string = gb_fnv64a(c->string.text, c->string.len);
+	key.global = c->global;
+	key.elems  = gb_fnv64a(c->elems, c->elem_count*gb_size_of(irBcConst *));
+	return hashing_proc(&key, gb_size_of(key)).key;
+}
+
+bool ir_bc_const_equal(irBcConst *a, irBcConst *b) {
+	if (a->kind != b->kind || a->type != b->type || a->value != b->value ||
+	    a->global != b->global || a->elem_count != b->elem_count || !str_eq(a->string, b->string)) {
+		return false;
+	}
+	for (isize i = 0; i < a->elem_count; i++) {
+		if (a->elems[i] != b->elems[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// NOTE: Like the types, the constants with the same contents are the same constant
+irBcConst *ir_bc_make_const(irBcWriter *w, irBcConst c) {
+	HashKey key = ir_bc_hash_key(ir_bc_const_hash(&c));
+	for (MapIrBcConstEntry *e = map_ir_bc_const_multi_find_first(&w->consts, key);
+	     e != NULL;
+	     e = map_ir_bc_const_multi_find_next(&w->consts, e)) {
+		if (ir_bc_const_equal(e->value, &c)) {
+			return e->value;
+		}
+	}
+	GB_ASSERT_MSG(w->is_collecting, "A constant was not found in the first walk of the module");
+
+	irBcConst *n = gb_alloc_item(w->allocator, irBcConst);
+	*n = c;
+	if (c.elem_count > 0) {
+		n->elems = gb_alloc_array(w->allocator, irBcConst *, c.elem_count);
+		gb_memcopy(n->elems, c.elems, c.elem_count*gb_size_of(irBcConst *));
+	}
+	n->index = -1;
+	if (n->kind != irBcConst_Global) {
+		n->index = cast(i32)w->const_table.count;
+		array_add(&w->const_table, n);
+	}
+	map_ir_bc_const_multi_insert(&w->consts, key, n);
+	return n;
+}
+
+irBcConst *ir_bc_const_null(irBcWriter *w, irBcType *type) {
+	irBcConst c = {irBcConst_Null};
+	c.type = type;
+	return ir_bc_make_const(w, c);
+}
+
+irBcConst *ir_bc_const_int(irBcWriter *w, irBcType *type, i64 value) {
+	GB_ASSERT(type->kind == irBcType_Int);
+	// NOTE: Sign extended from the width of the type, as LLVM writes them
+	if (type->count < 64) {
+		u64 sign = 1ull << (type->count-1);
+		u64 bits = cast(u64)value & ((sign << 1) - 1);
+		value = cast(i64)((bits ^ sign) - sign);
+	}
+	irBcConst c = {irBcConst_Int};
+	c.type = type;
+	c.value = cast(u64)value;
+	return ir_bc_make_const(w, c);
+}
+
+irBcConst *ir_bc_const_float(irBcWriter *w, irBcType *type, f64 value) {
+	GB_ASSERT(type->kind == irBcType_Float);
+	irBcConst c = {irBcConst_Float};
+	c.type = type;
+	u64 u = *cast(u64 *)&value;
+	if (type->count == 32) {
+		// NOTE: The same rounding as `ir_print_exact_value`, which has to print a 32 bit float as
+		// a 64 bit one which is exactly representable as a 32 bit one
+		u >>= 29;
+		u <<= 29;
+		f32 f = cast(f32)*cast(f64 *)&u;
+		c.value = *cast(u32 *)&f;
+	} else {
+		c.value = u;
+	}
+	return ir_bc_make_const(w, c);
+}
+
+irBcConst *ir_bc_const_aggregate(irBcWriter *w, irBcType *type, irBcConst **elems, isize elem_count) {
+	irBcConst c = {irBcConst_Aggregate};
+	c.type = type;
+	c.elems = elems;
+	c.elem_count = elem_count;
+	return ir_bc_make_const(w, c);
+}
+
+irBcConst *ir_bc_const_global(irBcWriter *w, irValue *global) {
+	GB_ASSERT(global->kind == irValue_Global || global->kind == irValue_Proc);
+	irBcConst c = {irBcConst_Global};
+	c.type = ir_bc_type(w, ir_type(global));
+	c.global = global;
+	return ir_bc_make_const(w, c);
+}
+
+// NOTE: `getelementptr inbounds (T, T* global, int 0, i32 0)`, the first element of an array global
+irBcConst *ir_bc_const_first_elem_ptr(irBcWriter *w, irValue *global) {
+	irBcConst *base = ir_bc_const_global(w, global);
+	GB_ASSERT(base->type->kind == irBcType_Pointer && base->type->elem->kind == irBcType_Array);
+	irBcConst *elems[3] = {
+		base,
+		ir_bc_const_int(w, ir_bc_type(w, t_int), 0),
+		ir_bc_const_int(w, ir_bc_type(w, t_i32), 0),
+	};
+	irBcConst c = {irBcConst_Gep};
+	c.type = ir_bc_type_pointer(w, base->type->elem->elem);
+	c.elems = elems;
+	c.elem_count = 3;
+	return ir_bc_make_const(w, c);
+}
+
+irBcConst *ir_bc_const_int_to_ptr(irBcWriter *w, u64 value) {
+	irBcConst *elems[1] = {ir_bc_const_int(w, ir_bc_type(w, t_int), cast(i64)value)};
+	irBcConst c = {irBcConst_IntToPtr};
+	c.type = ir_bc_type(w, t_rawptr);
+	c.elems = elems;
+	c.elem_count = 1;
+	return ir_bc_make_const(w, c);
+}
+
+irValue *ir_bc_string_global(irBcWriter *w, String str) {
+	irValue **found = map_ir_value_get(&w->string_globals, hash_string(str));
+	if (found != NULL) {
+		return *found;
+	}
+	GB_ASSERT_MSG(w->is_collecting, "A string was not found in the first walk of the module");
+	irValue *g = ir_add_global_string_array(w->module, str);
+	map_ir_value_set(&w->string_globals, hash_string(str), g);
+	return g;
+}
+
+irBcConst *ir_bc_exact_value(irBcWriter *w, ExactValue value, Type *type);
+
+irBcConst *ir_bc_compound_element(irBcWriter *w, ExactValue v, Type *elem_type) {
+	if (v.kind == ExactValue_Invalid || base_type(elem_type) == t_any) {
+		return ir_bc_const_null(w, ir_bc_type(w, elem_type));
+	}
+	return ir_bc_exact_value(w, v, elem_type);
+}
+
+// NOTE: Mirrors `ir_print_exact_value`, the type of the constant is the type it is printed with
+irBcConst *ir_bc_exact_value(irBcWriter *w, ExactValue value, Type *type) {
+	irBcType *bt = ir_bc_type(w, type);
+	type = core_type(type);
+	if (is_type_float(type)) {
+		value = exact_value_to_float(value);
+	} else if (is_type_integer(type)) {
+		value = exact_value_to_integer(value);
+	} else if (is_type_pointer(type)) {
+		value = exact_value_to_integer(value);
+	}
+
+	switch (value.kind) {
+	case ExactValue_Bool:
+		return ir_bc_const_int(w, bt, value.value_bool ? 1 : 0);
+
+	case ExactValue_String: {
+		String str = value.value_string;
+		if (str.len == 0) {
+			return ir_bc_const_null(w, bt);
+		}
+		if (!is_type_string(type)) {
+			GB_ASSERT(is_type_array(type));
+			irBcConst c = {irBcConst_String};
+			c.type = bt;
+			c.string = str;
+			return ir_bc_make_const(w, c);
+		}
+		irBcConst *elems[2] = {
+			ir_bc_const_first_elem_ptr(w, ir_bc_string_global(w, str)),
+			ir_bc_const_int(w, ir_bc_type(w, t_int), str.len),
+		};
+		return ir_bc_const_aggregate(w, bt, elems, 2);
+	}
+
+	case ExactValue_Integer:
+		if (is_type_pointer(type)) {
+			if (value.value_integer == 0) {
+				return ir_bc_const_null(w, bt);
+			}
+			return ir_bc_const_int_to_ptr(w, cast(u64)value.value_integer);
+		}
+		return ir_bc_const_int(w, bt, value.value_integer);
+
+	case ExactValue_Float:
+		GB_ASSERT_MSG(is_type_float(type), "%s", type_to_string(type));
+		return ir_bc_const_float(w, bt, value.value_float);
+
+	case ExactValue_Complex: {
+		Type *ft = NULL;
+		f64 parts[4] = {value.value_complex.real, value.value_complex.imag, 0, 0};
+		isize count = 2;
+		if (is_type_quaternion(type)) {
+			ft = base_quaternion_elem_type(type);
+			count = 4;
+		} else {
+			GB_ASSERT_MSG(is_type_complex(type), "%s", type_to_string(type));
+			ft = base_complex_elem_type(type);
+		}
+		irBcConst *elems[4] = {0};
+		for (isize i = 0; i < count; i++) {
+			elems[i] = ir_bc_exact_value(w, exact_value_float(parts[i]), ft);
+		}
+		return ir_bc_const_aggregate(w, bt, elems, count);
+	}
+
+	case ExactValue_Quaternion: {
+		GB_ASSERT_MSG(is_type_quaternion(type), "%s", type_to_string(type));
+		Type *ft = base_quaternion_elem_type(type);
+		Quaternion256 q = value.value_quaternion;
+		irBcConst *elems[4] = {
+			ir_bc_exact_value(w, exact_value_float(q.real), ft),
+			ir_bc_exact_value(w, exact_value_float(q.imag), ft),
+			ir_bc_exact_value(w, exact_value_float(q.jmag), ft),
+			ir_bc_exact_value(w, exact_value_float(q.kmag), ft),
+		};
+		return ir_bc_const_aggregate(w, bt, elems, 4);
+	}
+
+	case ExactValue_Pointer:
+		if (value.value_pointer == 0) {
+			return ir_bc_const_null(w, bt);
+		}
+		return ir_bc_const_int_to_ptr(w, cast(u64)cast(uintptr)value.value_pointer);
+
+	case ExactValue_Compound: {
+		type = base_type(type);
+		ast_node(cl, CompoundLit, value.value_compound);
+		if (cl->elems.count == 0 || (!is_type_array(type) && !is_type_vector(type) && !is_type_struct(type))) {
+			return ir_bc_const_null(w, bt);
+		}
+
+		gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&w->tmp_arena);
+		irBcConst *result = NULL;
+
+		if (is_type_array(type)) {
+			Type *elem_type = type->Array.elem;
+			irBcConst **elems = gb_alloc_array(w->tmp_allocator, irBcConst *, type->Array.count);
+			for (isize i = 0; i < type->Array.count; i++) {
+				if (i < cl->elems.count) {
+					TypeAndValue *tav = type_and_value_of_expression(w->module->info, cl->elems.e[i]);
+					GB_ASSERT(tav != NULL);
+					elems[i] = ir_bc_compound_element(w, tav->value, elem_type);
+				} else {
+					elems[i] = ir_bc_const_null(w, ir_bc_type(w, elem_type));
+				}
+			}
+			result = ir_bc_const_aggregate(w, bt, elems, type->Array.count);
+		} else if (is_type_vector(type)) {
+			Type *elem_type = type->Vector.elem;
+			isize count = type->Vector.count;
+			irBcConst **elems = gb_alloc_array(w->tmp_allocator, irBcConst *, count);
+			for (isize i = 0; i < count; i++) {
+				// NOTE: A single element is used for all of them
+				AstNode *elem = cl->elems.e[cl->elems.count == 1 ? 0 : i];
+				TypeAndValue *tav = type_and_value_of_expression(w->module->info, elem);
+				GB_ASSERT(tav != NULL);
+				elems[i] = ir_bc_compound_element(w, tav->value, elem_type);
+			}
+			GB_ASSERT(bt->elem_count == 2);
+			irBcConst *fields[2] = {
+				ir_bc_const_null(w, bt->elems[0]),
+				ir_bc_const_aggregate(w, bt->elems[1], elems, count),
+			};
+			result = ir_bc_const_aggregate(w, bt, fields, 2);
+		} else {
+			isize value_count = type->Record.field_count;
+			ExactValue *values = gb_alloc_array(w->tmp_allocator, ExactValue, value_count);
+			if (cl->elems.e[0]->kind == AstNode_FieldValue) {
+				for_array(i, cl->elems) {
+					ast_node(fv, FieldValue, cl->elems.e[i]);
+					String name = fv->field->Ident.string;
+					TypeAndValue *tav = type_and_value_of_expression(w->module->info, fv->value);
+					GB_ASSERT(tav != NULL);
+					Selection sel = lookup_field(heap_allocator(), type, name, false);
+					Entity *f = type->Record.fields[selection_index(&sel, 0)];
+					values[f->Variable.field_index] = tav->value;
+				}
+			} else {
+				for (isize i = 0; i < value_count; i++) {
+					TypeAndValue *tav = type_and_value_of_expression(w->module->info, cl->elems.e[i]);
+					GB_ASSERT(tav != NULL);
+					Entity *f = type->Record.fields_in_src_order[i];
+					values[f->Variable.field_index] = tav->value;
+				}
+			}
+
+			irBcConst **elems = gb_alloc_array(w->tmp_allocator, irBcConst *, value_count);
+			for (isize i = 0; i < value_count; i++) {
+				elems[i] = ir_bc_compound_element(w, values[i], type->Record.fields[i]->type);
+			}
+			result = ir_bc_const_aggregate(w, bt, elems, value_count);
+		}
+
+		gb_temp_arena_memory_end(tmp);
+		return result;
+	}
+	}
+
+	return ir_bc_const_null(w, bt);
+}
+
+
+////////////////////////////////////////////////////////////////
+//
+// @Values
+//
+////////////////////////////////////////////////////////////////
+
+void *ir_bc_module_value_key(irValue *v) {
+	if (v->kind == irValue_Proc) {
+		return &v->Proc;
+	}
+	GB_ASSERT(v->kind == irValue_Global);
+	return v;
+}
+
+String ir_bc_symbol_name(gbAllocator a, String name, bool remove_prefix) {
+	if (remove_prefix) {
+		return name;
+	}
+	String symbol = {0};
+	symbol.len = name.len+1;
+	symbol.text = gb_alloc_array(a, u8, symbol.len);
+	symbol.text[0] = '.';
+	gb_memcopy(symbol.text+1, name.text, name.len);
+	return symbol;
+}
+
+u32 ir_bc_module_value_id(irBcWriter *w, irValue *v) {
+	isize *found = map_isize_get(&w->value_ids, hash_pointer(ir_bc_module_value_key(v)));
+	if (found == NULL && v->kind == irValue_Proc) {
+		// NOTE: A foreign procedure which is declared more than once is only a member the first
+		// time, the others are the same symbol
+		gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&w->tmp_arena);
+		String symbol = ir_bc_symbol_name(w->tmp_allocator, v->Proc.name, ir_print_is_proc_global(w->module, &v->Proc));
+		found = map_isize_get(&w->symbol_ids, hash_string(symbol));
+		gb_temp_arena_memory_end(tmp);
+	}
+	if (found == NULL) {
+		// NOTE: The globals only get their ids after the first walk, which might add some
+		GB_ASSERT(w->is_collecting);
+		return 0;
+	}
+	return cast(u32)*found;
+}
+
+u32 ir_bc_const_id(irBcWriter *w, irBcConst *c) {
+	if (c->kind == irBcConst_Global) {
+		return ir_bc_module_value_id(w, c->global);
+	}
+	return cast(u32)(w->const_base + c->index);
+}
+
+// NOTE: The procedure the printer names directly, e.g. `@.__bounds_check_error`
+u32 ir_bc_runtime_proc_id(irBcWriter *w, String name, irProcedure **proc_) {
+	gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&w->tmp_arena);
+	String symbol = ir_bc_symbol_name(w->tmp_allocator, name, false);
+	isize *found = map_isize_get(&w->symbol_ids, hash_string(symbol));
+	gb_temp_arena_memory_end(tmp);
+
+	GB_ASSERT_MSG(found != NULL, "Unknown runtime procedure: %.*s", LIT(name));
+	GB_ASSERT(*found < w->procs.count);
+	*proc_ = w->procs.e[*found];
+	return cast(u32)*found;
+}
+
+u32 ir_bc_value_id(irBcWriter *w, irValue *value, Type *type_hint) {
+	GB_ASSERT(value != NULL);
+	switch (value->kind) {
+	case irValue_Constant:
+		return ir_bc_const_id(w, ir_bc_exact_value(w, value->Constant.value, type_hint));
+
+	case irValue_ConstantSlice: {
+		irValueConstantSlice *cs = &value->ConstantSlice;
+		irBcType *bt = ir_bc_type(w, type_hint);
+		if (cs->backing_array == NULL || cs->count == 0) {
+			return ir_bc_const_id(w, ir_bc_const_null(w, bt));
+		}
+		irBcConst *elems[2] = {
+			ir_bc_const_first_elem_ptr(w, cs->backing_array),
+			ir_bc_const_int(w, ir_bc_type(w, t_int), cs->count),
+		};
+		return ir_bc_const_id(w, ir_bc_const_aggregate(w, bt, elems, 2));
+	}
+
+	case irValue_Nil:
+		return ir_bc_const_id(w, ir_bc_const_null(w, ir_bc_type(w, type_hint)));
+
+	case irValue_Global:
+	case irValue_Proc:
+		return ir_bc_module_value_id(w, value);
+
+	case irValue_Param: {
+		TypeTuple *params = &w->proc->type->Proc.params->Tuple;
+		for (isize i = 0; i < params->variable_count; i++) {
+			if (params->variables[i] == value->Param.entity) {
+				return w->param_base + cast(u32)i;
+			}
+		}
+		GB_PANIC("Unknown parameter: %.*s", LIT(value->Param.entity->token.string));
+	} break;
+
+	case irValue_Instr:
+		GB_ASSERT(value->index >= 0);
+		return w->instr_base + cast(u32)value->index;
+	}
+
+	GB_PANIC("Unknown irValue kind");
+	return 0;
+}
+
+// NOTE: Operands are written relative to the value id of the instruction, as most are close by.
+// One which comes later wraps around (as LLVM's reader takes it in 32 bits).
+void ir_bc_push_value(irBcWriter *w, irValue *value, Type *type) {
+	u32 id = ir_bc_value_id(w, value, type);
+	ir_bc_push(w, cast(u32)(w->next_value - id));
+}
+
+// NOTE: An operand whose type is not known from the instruction has its type written too if it
+// comes later
+void ir_bc_push_typed_value(irBcWriter *w, irValue *value, Type *type) {
+	irBcType *bt = ir_bc_type(w, type);
+	u32 id = ir_bc_value_id(w, value, type);
+	ir_bc_push(w, cast(u32)(w->next_value - id));
+	if (id >= w->next_value) {
+		ir_bc_push(w, ir_bc_type_id(bt));
+	}
+}
+
+void ir_bc_push_const(irBcWriter *w, irBcConst *c) {
+	ir_bc_push(w, cast(u32)(w->next_value - ir_bc_const_id(w, c)));
+}
+
+void ir_bc_push_block(irBcWriter *w, irBlock *b) {
+	GB_ASSERT(b != NULL);
+	ir_bc_push(w, cast(u64)b->index);
+}
+
+
+////////////////////////////////////////////////////////////////
+//
+// @Attributes
+//
+////////////////////////////////////////////////////////////////
+
+u64 ir_bc_attr_group(irBcWriter *w, u64 index, u32 flags) {
+	u64 key = (index << 32) | flags;
+	isize *found = map_isize_get(&w->attr_groups, ir_bc_hash_key(key));
+	if (found != NULL) {
+		return cast(u64)*found;
+	}
+	GB_ASSERT(w->is_collecting);
+	array_add(&w->attr_group_keys, key);
+	isize id = w->attr_group_keys.count; // NOTE: Group ids start at 1
+	map_isize_set(&w->attr_groups, ir_bc_hash_key(key), id);
+	return cast(u64)id;
+}
+
+// NOTE: Returns 0 for no attributes, otherwise the index of the attribute list plus one
+u64 ir_bc_attr_list(irBcWriter *w, u32 proc_flags, Type *proc_type) {
+	isize first = w->attr_list_groups.count;
+	if (proc_flags != 0) {
+		array_add(&w->attr_list_groups, cast(u32)ir_bc_attr_group(w, IR_BC_PROC_ATTR_INDEX, proc_flags));
+	}
+	if (proc_type->Proc.param_count > 0) {
+		TypeTuple *params = &proc_type->Proc.params->Tuple;
+		for (isize i = 0; i < params->variable_count; i++) {
+			if (params->variables[i]->flags&EntityFlag_NoAlias) {
+				array_add(&w->attr_list_groups, cast(u32)ir_bc_attr_group(w, i+1, irBcAttr_NoAlias));
+			}
+		}
+	}
+	isize count = w->attr_list_groups.count - first;
+	if (count == 0) {
+		return 0;
+	}
+
+	u32 *groups = w->attr_list_groups.e + first;
+	HashKey key = ir_bc_hash_key(gb_fnv64a(groups, count*gb_size_of(u32)));
+	for (MapIsizeEntry *e = map_isize_multi_find_first(&w->attr_list_ids, key);
+	     e != NULL;
+	     e = map_isize_multi_find_next(&w->attr_list_ids, e)) {
+		irBcAttrList *list = &w->attr_lists.e[e->value];
+		if (list->count == count &&
+		    gb_memcompare(w->attr_list_groups.e + list->offset, groups, count*gb_size_of(u32)) == 0) {
+			w->attr_list_groups.count = first;
+			return cast(u64)e->value + 1;
+		}
+	}
+	GB_ASSERT(w->is_collecting);
+	irBcAttrList list = {first, count};
+	map_isize_multi_insert(&w->attr_list_ids, key, w->attr_lists.count);
+	array_add(&w->attr_lists, list);
+	return cast(u64)w->attr_lists.count;
+}
+
+u64 ir_bc_proc_attr_list(irBcWriter *w, irProcedure *proc) {
+	u32 flags = 0;
+	if (proc->tags & ProcTag_inline) {
+		flags |= irBcAttr_AlwaysInline;
+	}
+	if (proc->tags & ProcTag_no_inline) {
+		flags |= irBcAttr_NoInline;
+	}
+	return ir_bc_attr_list(w, flags, proc->type);
+}
+
+
+////////////////////////////////////////////////////////////////
+//
+// @Instructions
+//
+////////////////////////////////////////////////////////////////
+
+u64 ir_bc_calling_convention(ProcCallingConvention cc) {
+	switch (cc) {
+	case ProcCC_Odin: return 0;
+	case ProcCC_C:    return 0;
+	case ProcCC_Std:  return 64;
+	case ProcCC_Fast: return 65;
+	}
+	GB_PANIC("unknown calling convention: %d", cc);
+	return 0;
+}
+
+u64 ir_bc_cast_opcode(irConvKind kind) {
+	switch (kind) {
+	case irConv_trunc:    return 0;
+	case irConv_zext:     return 1;
+	case irConv_sext:     return 2;
+	case irConv_fptoui:   return 3;
+	case irConv_fptosi:   return 4;
+	case irConv_uitofp:   return 5;
+	case irConv_sitofp:   return 6;
+	case irConv_fptrunc:  return 7;
+	case irConv_fpext:    return 8;
+	case irConv_ptrtoint: return 9;
+	case irConv_inttoptr: return 10;
+	case irConv_bitcast:  return 11;
+	}
+	GB_PANIC("Unknown conversion: %d", kind);
+	return 0;
+}
+
+// NOTE: [attributes, calling convention, procedure type, callee], the arguments come after
+void ir_bc_push_call(irBcWriter *w, u64 attrs, ProcCallingConvention cc, Type *proc_type, u32 callee_id) {
+	u64 const explicit_type = 1ull<<15;
+	ir_bc_push(w, attrs);
+	ir_bc_push(w, (ir_bc_calling_convention(cc) << 1) | explicit_type);
+	ir_bc_push(w, ir_bc_type_id(ir_bc_proc_type(w, proc_type)));
+	ir_bc_push(w, cast(u32)(w->next_value - callee_id));
+}
+
+void ir_bc_push_runtime_call(irBcWriter *w, String name) {
+	irProcedure *proc = NULL;
+	u32 id = ir_bc_runtime_proc_id(w, name, &proc);
+	ir_bc_push_call(w, ir_bc_proc_attr_list(w, proc), ProcCC_Odin, proc->type, id);
+}
+
+void ir_bc_push_pos_args(irBcWriter *w, TokenPos pos) {
+	ir_bc_push_const(w, ir_bc_exact_value(w, exact_value_string(token_pos_file(pos)), t_string));
+	ir_bc_push_const(w, ir_bc_exact_value(w, exact_value_integer(token_pos_line(pos)), t_int));
+	ir_bc_push_const(w, ir_bc_exact_value(w, exact_value_integer(token_pos_column(pos)), t_int));
+}
+
+void ir_bc_push_struct_gep(irBcWriter *w, irValue *address, i64 index) {
+	Type *et = ir_type(address);
+	ir_bc_push(w, 1); // NOTE: inbounds
+	ir_bc_push(w, ir_bc_type_id(ir_bc_type(w, type_deref(et))));
+	ir_bc_push_typed_value(w, address, et);
+	ir_bc_push_const(w, ir_bc_const_int(w, ir_bc_type(w, t_int), 0));
+	ir_bc_push_const(w, ir_bc_const_int(w, ir_bc_type(w, t_i32), index));
+}
+
+void ir_bc_write_binary_op(irBcWriter *w, irValue *value) {
+	irInstrBinaryOp *bo = &value->Instr.BinaryOp;
+	Type *type = base_type(ir_type(bo->left));
+	Type *elem_type = type;
+	GB_ASSERT(!is_type_vector(elem_type));
+
+	if (gb_is_between(bo->op, Token__ComparisonBegin+1, Token__ComparisonEnd-1)) {
+		char *runtime_proc = NULL;
+		if (is_type_string(elem_type)) {
+			switch (bo->op) {
+			case Token_CmpEq: runtime_proc = "__string_eq"; break;
+			case Token_NotEq: runtime_proc = "__string_ne"; break;
+			case Token_Lt:    runtime_proc = "__string_lt"; break;
+			case Token_Gt:    runtime_proc = "__string_gt"; break;
+			case Token_LtEq:  runtime_proc = "__string_le"; break;
+			case Token_GtEq:  runtime_proc = "__string_gt"; break;
+			}
+		} else if (is_type_complex(elem_type)) {
+			i64 sz = 8*type_size_of(heap_allocator(), elem_type);
+			if (sz == 64) {
+				runtime_proc = bo->op == Token_CmpEq ? "__complex64_eq" : "__complex64_ne";
+			} else {
+				runtime_proc = bo->op == Token_CmpEq ? "__complex128_eq" : "__complex128_ne";
+			}
+		} else if (is_type_quaternion(elem_type)) {
+			i64 sz = 8*type_size_of(heap_allocator(), elem_type);
+			if (sz == 128) {
+				runtime_proc = bo->op == Token_CmpEq ? "__quaternion128_eq" : "__quaternion128_ne";
+			} else {
+				runtime_proc = bo->op == Token_CmpEq ? "__quaternion256_eq" : "__quaternion256_ne";
+			}
+		}
+
+		if (runtime_proc != NULL) {
+			ir_bc_push_runtime_call(w, make_string_c(runtime_proc));
+			ir_bc_push_value(w, bo->left, type);
+			ir_bc_push_value(w, bo->right, type);
+			ir_bc_record(w, irBcFuncCode_Call);
+			return;
+		}
+
+		u64 pred = 0;
+		if (is_type_float(elem_type)) {
+			switch (bo->op) {
+			case Token_CmpEq: pred = 1; break; // oeq
+			case Token_Gt:    pred = 2; break; // ogt
+			case Token_GtEq:  pred = 3; break; // oge
+			case Token_Lt:    pred = 4; break; // olt
+			case Token_LtEq:  pred = 5; break; // ole
+			case Token_NotEq: pred = 6; break; // one
+			}
+		} else {
+			bool is_unsigned = is_type_unsigned(elem_type);
+			switch (bo->op) {
+			case Token_CmpEq: pred = 32; break;                    // eq
+			case Token_NotEq: pred = 33; break;                    // ne
+			case Token_Gt:    pred = is_unsigned ? 34 : 38; break; // ugt, sgt
+			case Token_GtEq:  pred = is_unsigned ? 35 : 39; break; // uge, sge
+			case Token_Lt:    pred = is_unsigned ? 36 : 40; break; // ult, slt
+			case Token_LtEq:  pred = is_unsigned ? 37 : 41; break; // ule, sle
+			default: GB_PANIC("invalid comparison"); break;
+			}
+		}
+		ir_bc_push_typed_value(w, bo->left, type);
+		ir_bc_push_value(w, bo->right, type);
+		ir_bc_push(w, pred);
+		ir_bc_record(w, irBcFuncCode_Cmp);
+		return;
+	}
+
+	// NOTE: The same opcodes are used for floats, e.g. `sdiv` is `fdiv`
+	u64 opcode = 0;
+	bool is_unsigned = !is_type_float(elem_type) && is_type_unsigned(elem_type);
+	switch (bo->op) {
+	case Token_Add: opcode = 0;  break;
+	case Token_Sub: opcode = 1;  break;
+	case Token_Mul: opcode = 2;  break;
+	case Token_Quo: opcode = is_unsigned ? 3 : 4; break;
+	case Token_Mod: opcode = is_unsigned ? 5 : 6; break;
+	case Token_Shl: opcode = 7;  break;
+	case Token_Shr: opcode = 8;  break; // lshr
+	case Token_And: opcode = 10; break;
+	case Token_Or:  opcode = 11; break;
+	case Token_Xor: opcode = 12; break;
+	case Token_Not: opcode = 12; break;
+
+	case Token_AndNot: GB_PANIC("Token_AndNot Should never be called");
+	default: GB_PANIC("Unknown binary operator"); break;
+	}
+	ir_bc_push_typed_value(w, bo->left, type);
+	ir_bc_push_value(w, bo->right, type);
+	ir_bc_push(w, opcode);
+	ir_bc_record(w, irBcFuncCode_BinaryOp);
+}
+
+// NOTE: Mirrors `ir_print_instr`
+void ir_bc_write_instr(irBcWriter *w, irValue *value) {
+	GB_ASSERT(value->kind == irValue_Instr);
+	irInstr *instr = &value->Instr;
+
+	switch (instr->kind) {
+	default:
+		GB_PANIC("<unknown instr> %d\n", instr->kind);
+		break;
+
+	case irInstr_Comment:
+	case irInstr_DebugDeclare:
+		break;
+
+	case irInstr_StartupRuntime:
+		ir_bc_push_runtime_call(w, str_lit(IR_STARTUP_RUNTIME_PROC_NAME));
+		ir_bc_record(w, irBcFuncCode_Call);
+		break;
+
+	case irInstr_Local: {
+		Type *type = instr->Local.entity->type;
+		u64 const explicit_type = 1ull<<6;
+		ir_bc_push(w, ir_bc_type_id(ir_bc_type(w, type)));
+		// NOTE: The number of elements, which is absolute unlike every other operand
+		irBcConst *one = ir_bc_const_int(w, ir_bc_type(w, t_i32), 1);
+		ir_bc_push(w, ir_bc_type_id(one->type));
+		ir_bc_push(w, ir_bc_const_id(w, one));
+		ir_bc_push(w, ir_bc_log2_align(type_align_of(heap_allocator(), type)) | explicit_type);
+		ir_bc_record(w, irBcFuncCode_Alloca);
+	} break;
+
+	case irInstr_ZeroInit: {
+		Type *pt = ir_type(instr->ZeroInit.address);
+		ir_bc_push_typed_value(w, instr->ZeroInit.address, pt);
+		ir_bc_push_const(w, ir_bc_const_null(w, ir_bc_type(w, type_deref(pt))));
+		ir_bc_push(w, 0);
+		ir_bc_push(w, 0);
+		ir_bc_record(w, irBcFuncCode_Store);
+	} break;
+
+	case irInstr_Store: {
+		Type *pt = ir_type(instr->Store.address);
+		Type *type = type_deref(pt);
+		ir_bc_push_typed_value(w, instr->Store.address, pt);
+		ir_bc_push_typed_value(w, instr->Store.value, type);
+		ir_bc_push(w, 0);
+		ir_bc_push(w, 0);
+		ir_bc_record(w, irBcFuncCode_Store);
+	} break;
+
+	case irInstr_Load: {
+		Type *type = instr->Load.type;
+		ir_bc_push_typed_value(w, instr->Load.address, make_type_pointer(heap_allocator(), type));
+		ir_bc_push(w, ir_bc_type_id(ir_bc_type(w, type)));
+		ir_bc_push(w, ir_bc_log2_align(type_align_of(heap_allocator(), type)));
+		ir_bc_push(w, 0);
+		ir_bc_record(w, irBcFuncCode_Load);
+	} break;
+
+	case irInstr_ArrayElementPtr: {
+		Type *et = ir_type(instr->ArrayElementPtr.address);
+		irValue *index = instr->ArrayElementPtr.elem_index;
+		ir_bc_push(w, 1); // NOTE: inbounds
+		ir_bc_push(w, ir_bc_type_id(ir_bc_type(w, type_deref(et))));
+		ir_bc_push_typed_value(w, instr->ArrayElementPtr.address, et);
+		ir_bc_push_const(w, ir_bc_const_int(w, ir_bc_type(w, t_int), 0));
+		if (is_type_vector(type_deref(et))) {
+			ir_bc_push_const(w, ir_bc_const_int(w, ir_bc_type(w, t_i32), 1));
+		}
+		ir_bc_push_typed_value(w, index, ir_type(index));
+		ir_bc_record(w, irBcFuncCode_Gep);
+	} break;
+
+	case irInstr_StructElementPtr: {
+		Type *et = ir_type(instr->StructElementPtr.address);
+		i32 index = instr->StructElementPtr.elem_index;
+		Type *st = base_type(type_deref(et));
+		if (is_type_struct(st)) {
+			if (st->Record.custom_align > 0) {
+				index += 1;
+			}
+		}
+		ir_bc_push_struct_gep(w, instr->StructElementPtr.address, index);
+		ir_bc_record(w, irBcFuncCode_Gep);
+	} break;
+
+	case irInstr_PtrOffset: {
+		Type *pt = ir_type(instr->PtrOffset.address);
+		irValue *offset = instr->PtrOffset.offset;
+		ir_bc_push(w, 1); // NOTE: inbounds
+		ir_bc_push(w, ir_bc_type_id(ir_bc_type(w, type_deref(pt))));
+		ir_bc_push_typed_value(w, instr->PtrOffset.address, pt);
+		ir_bc_push_typed_value(w, offset, ir_type(offset));
+		ir_bc_record(w, irBcFuncCode_Gep);
+	} break;
+
+	case irInstr_Phi: {
+		ir_bc_push(w, ir_bc_type_id(ir_bc_type(w, instr->Phi.type)));
+		for_array(i, instr->Phi.edges) {
+			irValue *edge = instr->Phi.edges.e[i];
+			irBlock *block = NULL;
+			if (instr->parent != NULL &&
+			    i < instr->parent->preds.count) {
+				block = instr->parent->preds.e[i];
+			}
+			// NOTE: A phi may use a later value, so its operands are signed
+			u32 id = ir_bc_value_id(w, edge, instr->Phi.type);
+			ir_bc_push(w, ir_bc_signed(cast(i64)w->next_value - cast(i64)id));
+			ir_bc_push_block(w, block);
+		}
+		ir_bc_record(w, irBcFuncCode_Phi);
+	} break;
+
+	case irInstr_StructExtractValue: {
+		Type *et = ir_type(instr->StructExtractValue.address);
+		i32 index = instr->StructExtractValue.index;
+		Type *st = base_type(et);
+		if (is_type_struct(st)) {
+			if (st->Record.custom_align > 0) {
+				index += 1;
+			}
+		}
+		ir_bc_push_typed_value(w, instr->StructExtractValue.address, et);
+		ir_bc_push(w, cast(u64)index);
+		ir_bc_record(w, irBcFuncCode_ExtractValue);
+	} break;
+
+	case irInstr_UnionTagPtr:
+		ir_bc_push_struct_gep(w, instr->UnionTagPtr.address, 2);
+		ir_bc_record(w, irBcFuncCode_Gep);
+		break;
+
+	case irInstr_UnionTagValue: {
+		Type *et = ir_type(instr->UnionTagValue.address);
+		ir_bc_push_typed_value(w, instr->UnionTagValue.address, et);
+		ir_bc_push(w, 2);
+		ir_bc_record(w, irBcFuncCode_ExtractValue);
+	} break;
+
+	case irInstr_Jump:
+		ir_bc_push_block(w, instr->Jump.block);
+		ir_bc_record(w, irBcFuncCode_Br);
+		break;
+
+	case irInstr_If:
+		ir_bc_push_block(w, instr->If.true_block);
+		ir_bc_push_block(w, instr->If.false_block);
+		ir_bc_push_value(w, instr->If.cond, t_bool);
+		ir_bc_record(w, irBcFuncCode_Br);
+		break;
+
+	case irInstr_Return: {
+		irValue *ret = instr->Return.value;
+		if (ret != NULL) {
+			ir_bc_push_typed_value(w, ret, ir_type(ret));
+		}
+		ir_bc_record(w, irBcFuncCode_Ret);
+	} break;
+
+	case irInstr_Conv: {
+		irInstrConv *c = &instr->Conv;
+		ir_bc_push_typed_value(w, c->value, c->from);
+		ir_bc_push(w, ir_bc_type_id(ir_bc_type(w, c->to)));
+		ir_bc_push(w, ir_bc_cast_opcode(c->kind));
+		ir_bc_record(w, irBcFuncCode_Cast);
+	} break;
+
+	case irInstr_Unreachable:
+		ir_bc_record(w, irBcFuncCode_Unreachable);
+		break;
+
+	case irInstr_UnaryOp: {
+		irInstrUnaryOp *uo = &instr->UnaryOp;
+		Type *type = base_type(ir_type(uo->expr));
+		Type *elem_type = type;
+		while (elem_type->kind == Type_Vector) {
+			elem_type = base_type(elem_type->Vector.elem);
+		}
+
+		// NOTE: `sub T 0, x`, `fsub T 0.0, x`, or `xor T -1, x`
+		irBcType *bt = ir_bc_type(w, type);
+		irBcConst *left = NULL;
+		u64 opcode = 0;
+		switch (uo->op) {
+		case Token_Sub:
+			opcode = 1;
+			if (is_type_float(elem_type)) {
+				left = ir_bc_exact_value(w, exact_value_float(0), elem_type);
+			} else {
+				left = ir_bc_const_int(w, bt, 0);
+			}
+			break;
+		case Token_Xor:
+		case Token_Not:
+			GB_ASSERT(is_type_integer(type) || is_type_boolean(type));
+			opcode = 12;
+			left = ir_bc_const_int(w, bt, -1);
+			break;
+		default:
+			GB_PANIC("Unknown unary operator");
+			break;
+		}
+		ir_bc_push_const(w, left);
+		ir_bc_push_value(w, uo->expr, type);
+		ir_bc_push(w, opcode);
+		ir_bc_record(w, irBcFuncCode_BinaryOp);
+	} break;
+
+	case irInstr_BinaryOp:
+		ir_bc_write_binary_op(w, value);
+		break;
+
+	case irInstr_Call: {
+		irInstrCall *call = &instr->Call;
+		Type *proc_type = base_type(ir_type(call->value));
+		GB_ASSERT(is_type_proc(proc_type));
+		ir_bc_push_call(w, ir_bc_attr_list(w, 0, proc_type), proc_type->Proc.calling_convention,
+		                proc_type, ir_bc_value_id(w, call->value, proc_type));
+		if (call->arg_count > 0) {
+			TypeTuple *params = &proc_type->Proc.params->Tuple;
+			for (isize i = 0; i < call->arg_count; i++) {
+				Entity *e = params->variables[i];
+				GB_ASSERT(e != NULL);
+				ir_bc_push_value(w, call->args[i], e->type);
+			}
+		}
+		ir_bc_record(w, irBcFuncCode_Call);
+	} break;
+
+	case irInstr_Select: {
+		irValue *t = instr->Select.true_value;
+		irValue *f = instr->Select.false_value;
+		ir_bc_push_typed_value(w, t, ir_type(t));
+		ir_bc_push_value(w, f, ir_type(f));
+		ir_bc_push_typed_value(w, instr->Select.cond, t_bool);
+		ir_bc_record(w, irBcFuncCode_Select);
+	} break;
+
+	case irInstr_BoundsCheck: {
+		irInstrBoundsCheck *bc = &instr->BoundsCheck;
+		ir_bc_push_runtime_call(w, str_lit("__bounds_check_error"));
+		ir_bc_push_pos_args(w, bc->pos);
+		ir_bc_push_value(w, bc->index, t_int);
+		ir_bc_push_value(w, bc->len, t_int);
+		ir_bc_record(w, irBcFuncCode_Call);
+	} break;
+
+	case irInstr_SliceBoundsCheck: {
+		irInstrSliceBoundsCheck *bc = &instr->SliceBoundsCheck;
+		if (bc->is_substring) {
+			ir_bc_push_runtime_call(w, str_lit("__substring_expr_error"));
+		} else {
+			ir_bc_push_runtime_call(w, str_lit("__slice_expr_error"));
+		}
+		ir_bc_push_pos_args(w, bc->pos);
+		ir_bc_push_value(w, bc->low, t_int);
+		ir_bc_push_value(w, bc->high, t_int);
+		if (!bc->is_substring) {
+			ir_bc_push_value(w, bc->max, t_int);
+		}
+		ir_bc_record(w, irBcFuncCode_Call);
+	} break;
+	}
+
+	if (value->index >= 0) {
+		GB_ASSERT(w->is_collecting || w->instr_base + cast(u32)value->index == w->next_value);
+		w->next_value++;
+	}
+}
+
+void ir_bc_write_proc_body(irBcWriter *w, irProcedure *proc) {
+	GB_ASSERT(proc->body != NULL);
+	w->proc = proc;
+	w->param_base = cast(u32)(w->const_base + w->const_table.count);
+	w->instr_base = w->param_base + cast(u32)proc->type->Proc.param_count;
+	w->next_value = w->instr_base;
+
+	if (!w->is_collecting) {
+		ir_bit_enter_block(&w->out, irBcBlock_Function);
+	}
+	ir_bc_push(w, proc->blocks.count);
+	ir_bc_record(w, irBcFuncCode_DeclareBlocks);
+	for_array(i, proc->blocks) {
+		irBlock *block = proc->blocks.e[i];
+		GB_ASSERT(block->index == i);
+		for_array(j, block->instrs) {
+			ir_bc_write_instr(w, block->instrs.e[j]);
+		}
+	}
+	if (!w->is_collecting) {
+		ir_bit_exit_block(&w->out);
+	}
+	w->proc = NULL;
+}
+
+
+////////////////////////////////////////////////////////////////
+//
+// @Module
+//
+////////////////////////////////////////////////////////////////
+
+void ir_bc_add_proc(irBcWriter *w, irProcedure *proc) {
+	array_add(&w->procs, proc);
+	for_array(i, proc->children) {
+		ir_bc_add_proc(w, proc->children.e[i]);
+	}
+}
+
+void ir_bc_add_symbol(irBcWriter *w, void *key, String name, bool remove_prefix) {
+	String symbol = ir_bc_symbol_name(w->allocator, name, remove_prefix);
+	isize id = w->symbols.count;
+	array_add(&w->symbols, symbol);
+	map_isize_set(&w->value_ids, hash_pointer(key), id);
+	map_isize_set(&w->symbol_ids, hash_string(symbol), id);
+}
+
+bool ir_bc_is_global_in_global_scope(irValueGlobal *g) {
+	Scope *scope = g->entity->scope;
+	if (scope != NULL) {
+		return scope->is_global || scope->is_init;
+	}
+	return false;
+}
+
+u32 ir_bc_global_init_id(irBcWriter *w, irValueGlobal *g) {
+	Type *type = g->entity->type;
+	if (g->value != NULL) {
+		return ir_bc_value_id(w, g->value, type);
+	}
+	return ir_bc_const_id(w, ir_bc_const_null(w, ir_bc_type(w, type)));
+}
+
+void ir_bc_write_types(irBcWriter *w) {
+	irBitWriter *b = &w->out;
+	ir_bit_enter_block(b, irBcBlock_Type);
+	ir_bc_push(w, w->type_table.count);
+	ir_bc_record(w, irBcTypeCode_NumEntry);
+	for_array(i, w->type_table) {
+		irBcType *t = w->type_table.e[i];
+		switch (t->kind) {
+		case irBcType_Void:
+			ir_bc_record(w, irBcTypeCode_Void);
+			break;
+		case irBcType_Int:
+			ir_bc_push(w, t->count);
+			ir_bc_record(w, irBcTypeCode_Integer);
+			break;
+		case irBcType_Float:
+			ir_bc_record(w, t->count == 32 ? irBcTypeCode_Float : irBcTypeCode_Double);
+			break;
+		case irBcType_Pointer:
+			ir_bc_push(w, ir_bc_type_id(t->elem));
+			ir_bc_push(w, 0); // NOTE: Address space
+			ir_bc_record(w, irBcTypeCode_Pointer);
+			break;
+		case irBcType_Array:
+		case irBcType_Vector:
+			ir_bc_push(w, t->count);
+			ir_bc_push(w, ir_bc_type_id(t->elem));
+			ir_bc_record(w, t->kind == irBcType_Array ? irBcTypeCode_Array : irBcTypeCode_Vector);
+			break;
+		case irBcType_Struct:
+			if (t->name.len > 0) {
+				ir_bc_push_string(w, t->name);
+				ir_bc_record(w, irBcTypeCode_StructName);
+			}
+			ir_bc_push(w, t->is_packed);
+			for (isize j = 0; j < t->elem_count; j++) {
+				ir_bc_push(w, ir_bc_type_id(t->elems[j]));
+			}
+			ir_bc_record(w, t->name.len > 0 ? irBcTypeCode_StructNamed : irBcTypeCode_StructAnon);
+			break;
+		case irBcType_Proc:
+			ir_bc_push(w, 0); // NOTE: Not variadic
+			ir_bc_push(w, ir_bc_type_id(t->elem));
+			for (isize j = 0; j < t->elem_count; j++) {
+				ir_bc_push(w, ir_bc_type_id(t->elems[j]));
+			}
+			ir_bc_record(w, irBcTypeCode_Function);
+			break;
+		}
+	}
+	ir_bit_exit_block(b);
+}
+
+void ir_bc_write_attrs(irBcWriter *w) {
+	if (w->attr_lists.count == 0) {
+		return;
+	}
+	irBitWriter *b = &w->out;
+	ir_bit_enter_block(b, irBcBlock_ParamAttrGroup);
+	for_array(i, w->attr_group_keys) {
+		u64 key = w->attr_group_keys.e[i];
+		u32 flags = cast(u32)key;
+		ir_bc_push(w, i+1);
+		ir_bc_push(w, key >> 32);
+		// NOTE: Each is an attribute without a value (0) and its kind, from LLVM's "LLVMBitCodes.h"
+		if (flags & irBcAttr_AlwaysInline) { ir_bc_push(w, 0); ir_bc_push(w, 2);  }
+		if (flags & irBcAttr_NoAlias)      { ir_bc_push(w, 0); ir_bc_push(w, 9);  }
+		if (flags & irBcAttr_NoInline)     { ir_bc_push(w, 0); ir_bc_push(w, 14); }
+		ir_bc_record(w, irBcAttrCode_GroupEntry);
+	}
+	ir_bit_exit_block(b);
+
+	ir_bit_enter_block(b, irBcBlock_ParamAttr);
+	for_array(i, w->attr_lists) {
+		irBcAttrList *list = &w->attr_lists.e[i];
+		for (isize j = 0; j < list->count; j++) {
+			ir_bc_push(w, w->attr_list_groups.e[list->offset+j]);
+		}
+		ir_bc_record(w, irBcAttrCode_Entry);
+	}
+	ir_bit_exit_block(b);
+}
+
+void ir_bc_write_constants(irBcWriter *w) {
+	if (w->const_table.count == 0) {
+		return;
+	}
+	irBitWriter *b = &w->out;
+	ir_bit_enter_block(b, irBcBlock_Constants);
+	irBcType *type = NULL;
+	for_array(i, w->const_table) {
+		irBcConst *c = w->const_table.e[i];
+		if (c->type != type) {
+			type = c->type;
+			ir_bc_push(w, ir_bc_type_id(type));
+			ir_bc_record(w, irBcConstCode_SetType);
+		}
+		switch (c->kind) {
+		case irBcConst_Null:
+			ir_bc_record(w, irBcConstCode_Null);
+			break;
+		case irBcConst_Int:
+			ir_bc_push(w, ir_bc_signed(cast(i64)c->value));
+			ir_bc_record(w, irBcConstCode_Integer);
+			break;
+		case irBcConst_Float:
+			ir_bc_push(w, c->value);
+			ir_bc_record(w, irBcConstCode_Float);
+			break;
+		case irBcConst_Aggregate:
+			for (isize j = 0; j < c->elem_count; j++) {
+				ir_bc_push(w, ir_bc_const_id(w, c->elems[j]));
+			}
+			ir_bc_record(w, irBcConstCode_Aggregate);
+			break;
+		case irBcConst_String:
+			ir_bc_push_string(w, c->string);
+			ir_bc_record(w, irBcConstCode_String);
+			break;
+		case irBcConst_IntToPtr:
+			ir_bc_push(w, ir_bc_cast_opcode(irConv_inttoptr));
+			ir_bc_push(w, ir_bc_type_id(c->elems[0]->type));
+			ir_bc_push(w, ir_bc_const_id(w, c->elems[0]));
+			ir_bc_record(w, irBcConstCode_Cast);
+			break;
+		case irBcConst_Gep:
+			// NOTE: [pointee type, (type, value)...]
+			ir_bc_push(w, ir_bc_type_id(c->elems[0]->type->elem));
+			for (isize j = 0; j < c->elem_count; j++) {
+				ir_bc_push(w, ir_bc_type_id(c->elems[j]->type));
+				ir_bc_push(w, ir_bc_const_id(w, c->elems[j]));
+			}
+			ir_bc_record(w, irBcConstCode_InboundsGep);
+			break;
+		default:
+			GB_PANIC("Unknown constant kind: %d", c->kind);
+			break;
+		}
+	}
+	ir_bit_exit_block(b);
+}
+
+void write_llvm_bitcode(irGen *ir) {
+	irModule *m = &ir->module;
+	u64 start = time_stamp_time_now();
+	gbAllocator a = heap_allocator();
+
+	irBcWriter writer = {0}, *w = &writer;
+	w->module = m;
+	ir_bit_writer_init(&w->out);
+	arena_init(&w->arena, a, gb_megabytes(1));
+	w->allocator = arena_allocator(&w->arena);
+	gb_arena_init_from_allocator(&w->tmp_arena, a, gb_megabytes(1));
+	w->tmp_allocator = gb_arena_allocator(&w->tmp_arena);
+	array_init(&w->ops, a);
+	map_ir_bc_type_init(&w->types, a);
+	map_ir_bc_type_init(&w->type_cache, a);
+	map_ir_bc_type_init(&w->named_types, a);
+	array_init(&w->type_table, a);
+	map_ir_bc_const_init(&w->consts, a);
+	array_init(&w->const_table, a);
+	map_ir_value_init(&w->string_globals, a);
+	array_init(&w->procs, a);
+	array_init(&w->globals, a);
+	map_isize_init(&w->value_ids, a);
+	map_isize_init(&w->symbol_ids, a);
+	array_init(&w->symbols, a);
+	map_isize_init(&w->attr_groups, a);
+	array_init(&w->attr_group_keys, a);
+	array_init(&w->attr_list_groups, a);
+	array_init(&w->attr_lists, a);
+	map_isize_init(&w->attr_list_ids, a);
+
+	// NOTE: The procedures get their ids first, as the calls to the runtime look them up by name
+	for_array(member_index, m->members.entries) {
+		irValue *v = m->members.entries.e[member_index].value;
+		if (v->kind == irValue_Proc) {
+			ir_bc_add_proc(w, &v->Proc);
+		}
+	}
+	for_array(i, w->procs) {
+		irProcedure *proc = w->procs.e[i];
+		ir_bc_add_symbol(w, proc, proc->name, ir_print_is_proc_global(m, proc));
+	}
+
+	// NOTE: The first walk, which may add globals (for the strings) as it goes
+	w->is_collecting = true;
+	for_array(i, w->procs) {
+		irProcedure *proc = w->procs.e[i];
+		ir_bc_proc_type(w, proc->type);
+		ir_bc_proc_attr_list(w, proc);
+		if (proc->body != NULL) {
+			ir_bc_write_proc_body(w, proc);
+		}
+	}
+	for_array(member_index, m->members.entries) {
+		irValue *v = m->members.entries.e[member_index].value;
+		if (v->kind == irValue_Global) {
+			array_add(&w->globals, v);
+			ir_bc_type(w, v->Global.entity->type);
+			ir_bc_global_init_id(w, &v->Global);
+		}
+	}
+	w->is_collecting = false;
+
+	for_array(i, w->globals) {
+		irValueGlobal *g = &w->globals.e[i]->Global;
+		ir_bc_add_symbol(w, w->globals.e[i], g->entity->token.string, ir_bc_is_global_in_global_scope(g));
+	}
+	w->const_base = w->symbols.count;
+
+
+	irBitWriter *b = &w->out;
+	ir_bit_emit(b, 'B', 8);
+	ir_bit_emit(b, 'C', 8);
+	ir_bit_emit(b, 0x0, 4);
+	ir_bit_emit(b, 0xc, 4);
+	ir_bit_emit(b, 0xe, 4);
+	ir_bit_emit(b, 0xd, 4);
+
+	ir_bit_enter_block(b, irBcBlock_Module);
+	ir_bc_push(w, 1);
+	ir_bc_record(w, irBcModuleCode_Version);
+
+	ir_bc_write_attrs(w);
+	ir_bc_write_types(w);
+
+	for_array(i, w->procs) {
+		irProcedure *proc = w->procs.e[i];
+		u64 dll_storage = 0;
+		if (build_context.is_dll && proc->body != NULL && (proc->tags & ProcTag_export)) {
+			dll_storage = 2; // NOTE: dllexport
+		}
+		// NOTE: [type, calling convention, is declaration, linkage, attributes, alignment, section,
+		//        visibility, gc, unnamed_addr, prologue, dll storage]
+		ir_bc_push(w, ir_bc_type_id(ir_bc_proc_type(w, proc->type)));
+		ir_bc_push(w, ir_bc_calling_convention(proc->type->Proc.calling_convention));
+		ir_bc_push(w, proc->body == NULL);
+		ir_bc_push(w, 0); // NOTE: external
+		ir_bc_push(w, ir_bc_proc_attr_list(w, proc));
+		ir_bc_push(w, 0);
+		ir_bc_push(w, 0);
+		ir_bc_push(w, 0);
+		ir_bc_push(w, 0);
+		ir_bc_push(w, 0);
+		ir_bc_push(w, 0);
+		ir_bc_push(w, dll_storage);
+		ir_bc_record(w, irBcModuleCode_Function);
+	}
+
+	for_array(i, w->globals) {
+		irValueGlobal *g = &w->globals.e[i]->Global;
+		u64 const explicit_type = 2;
+		// NOTE: [type, flags, initializer+1, linkage, alignment, section, visibility, thread_local,
+		//        unnamed_addr]
+		ir_bc_push(w, ir_bc_type_id(ir_bc_type(w, g->entity->type)));
+		ir_bc_push(w, (g->is_constant ? 1 : 0) | explicit_type);
+		ir_bc_push(w, g->is_foreign ? 0 : ir_bc_global_init_id(w, g)+1);
+		ir_bc_push(w, g->is_private ? 9 : 0); // NOTE: private, external
+		ir_bc_push(w, 0);
+		ir_bc_push(w, 0);
+		ir_bc_push(w, 0);
+		ir_bc_push(w, g->is_thread_local ? 1 : 0);
+		ir_bc_push(w, (g->is_constant && g->is_unnamed_addr) ? 1 : 0);
+		ir_bc_record(w, irBcModuleCode_GlobalVar);
+	}
+
+	ir_bc_write_constants(w);
+
+	ir_bit_enter_block(b, irBcBlock_ValueSymtab);
+	for_array(i, w->symbols) {
+		ir_bc_push(w, i);
+		ir_bc_push_string(w, w->symbols.e[i]);
+		ir_bc_record(w, irBcSymtabCode_Entry);
+	}
+	ir_bit_exit_block(b);
+
+	// NOTE: The bodies must be in the same order as their procedures
+	for_array(i, w->procs) {
+		irProcedure *proc = w->procs.e[i];
+		if (proc->body != NULL) {
+			ir_bc_write_proc_body(w, proc);
+		}
+	}
+
+	ir_bit_exit_block(b);
+	GB_ASSERT(b->bit_count == 0);
+
+	isize size = b->words.count*gb_size_of(u32);
+	gb_file_write(&ir->output_file, b->words.e, size);
+
+	m->print_byte_count = size;
+	m->print_time = time_stamp_time_now() - start;
+
+	map_isize_destroy(&w->attr_list_ids);
+	array_free(&w->attr_lists);
+	array_free(&w->attr_list_groups);
+	array_free(&w->attr_group_keys);
+	map_isize_destroy(&w->attr_groups);
+	array_free(&w->symbols);
+	map_isize_destroy(&w->symbol_ids);
+	map_isize_destroy(&w->value_ids);
+	array_free(&w->globals);
+	array_free(&w->procs);
+	map_ir_value_destroy(&w->string_globals);
+	array_free(&w->const_table);
+	map_ir_bc_const_destroy(&w->consts);
+	array_free(&w->type_table);
+	map_ir_bc_type_destroy(&w->named_types);
+	map_ir_bc_type_destroy(&w->type_cache);
+	map_ir_bc_type_destroy(&w->types);
+	array_free(&w->ops);
+	gb_arena_free(&w->tmp_arena);
+	arena_free(&w->arena);
+	ir_bit_writer_destroy(&w->out);
+}
@@ -1,92 +1,111 @@
 // Optimizations for the IR code
 
-void ir_opt_add_operands(irValueArray *ops, irInstr *i) {
+typedef Array(irValue **) irValueRefArray;
+typedef Array(irBlock *)  irBlockArray;
+
+// NOTE: Every operand of `i` which is a value, as a pointer so that it can be replaced
+// This must be complete otherwise the referrers of a value will be missing some of its uses
+void ir_opt_add_operand_refs(irValueRefArray *ops, irInstr *i) {
 	switch (i->kind) {
 	case irInstr_Comment:
 		break;
 	case irInstr_Local:
 		break;
 	case irInstr_ZeroInit:
-		array_add(ops, i->ZeroInit.address);
+		array_add(ops, &i->ZeroInit.address);
 		break;
 	case irInstr_Store:
-		array_add(ops, i->Store.address);
-		array_add(ops, i->Store.value);
+		array_add(ops, &i->Store.address);
+		array_add(ops, &i->Store.value);
 		break;
 	case irInstr_Load:
-		array_add(ops, i->Load.address);
+		array_add(ops, &i->Load.address);
 		break;
 	case irInstr_ArrayElementPtr:
-		array_add(ops, i->ArrayElementPtr.address);
-		array_add(ops, i->ArrayElementPtr.elem_index);
+		array_add(ops, &i->ArrayElementPtr.address);
+		array_add(ops, &i->ArrayElementPtr.elem_index);
 		break;
 	case irInstr_StructElementPtr:
-		array_add(ops, i->StructElementPtr.address);
+		array_add(ops, &i->StructElementPtr.address);
 		break;
 	case irInstr_PtrOffset:
-		array_add(ops, i->PtrOffset.address);
-		array_add(ops, i->PtrOffset.offset);
+		array_add(ops, &i->PtrOffset.address);
+		array_add(ops, &i->PtrOffset.offset);
 		break;
 	case irInstr_StructExtractValue:
-		array_add(ops, i->StructExtractValue.address);
+		array_add(ops, &i->StructExtractValue.address);
+		break;
+	case irInstr_UnionTagPtr:
+		array_add(ops, &i->UnionTagPtr.address);
+		break;
+	case irInstr_UnionTagValue:
+		array_add(ops, &i->UnionTagValue.address);
 		break;
 	case irInstr_Conv:
-		array_add(ops, i->Conv.value);
+		array_add(ops, &i->Conv.value);
 		break;
 	case irInstr_Jump:
 		break;
 	case irInstr_If:
-		array_add(ops, i->If.cond);
+		array_add(ops, &i->If.cond);
 		break;
 	case irInstr_Return:
 		if (i->Return.value != NULL) {
-			array_add(ops, i->Return.value);
+			array_add(ops, &i->Return.value);
 		}
 		break;
 	case irInstr_Select:
-		array_add(ops, i->Select.cond);
+		array_add(ops, &i->Select.cond);
+		array_add(ops, &i->Select.true_value);
+		array_add(ops, &i->Select.false_value);
 		break;
 	case irInstr_Phi:
 		for_array(j, i->Phi.edges) {
-			array_add(ops, i->Phi.edges.e[j]);
+			array_add(ops, &i->Phi.edges.e[j]);
 		}
 		break;
 	case irInstr_Unreachable:
 		break;
 	case irInstr_UnaryOp:
-		array_add(ops, i->UnaryOp.expr);
+		array_add(ops, &i->UnaryOp.expr);
 		break;
 	case irInstr_BinaryOp:
-		array_add(ops, i->BinaryOp.left);
-		array_add(ops, i->BinaryOp.right);
+		array_add(ops, &i->BinaryOp.left);
+		array_add(ops, &i->BinaryOp.right);
 		break;
 	case irInstr_Call:
-		array_add(ops, i->Call.value);
+		array_add(ops, &i->Call.value);
 		for (isize j = 0; j < i->Call.arg_count; j++) {
-			array_add(ops, i->Call.args[j]);
+			array_add(ops, &i->Call.args[j]);
 		}
 		break;
 	// case irInstr_VectorExtractElement:
-		// array_add(ops, i->VectorExtractElement.vector);
-		// array_add(ops, i->VectorExtractElement.index);
+		// array_add(ops, &i->VectorExtractElement.vector);
+		// array_add(ops, &i->VectorExtractElement.index);
 		// break;
 	// case irInstr_VectorInsertElement:
-		// array_add(ops, i->VectorInsertElement.vector);
-		// array_add(ops, i->VectorInsertElement.elem);
-		// array_add(ops, i->VectorInsertElement.index);
+		// array_add(ops, &i->VectorInsertElement.vector);
+		// array_add(ops, &i->VectorInsertElement.elem);
+		// array_add(ops, &i->VectorInsertElement.index);
 		// break;
 	// case irInstr_VectorShuffle:
-		// array_add(ops, i->VectorShuffle.vector);
+		// array_add(ops, &i->VectorShuffle.vector);
 		// break;
 	case irInstr_StartupRuntime:
 		break;
 	case irInstr_BoundsCheck:
-		array_add(ops, i->BoundsCheck.index);
-		array_add(ops, i->BoundsCheck.len);
+		array_add(ops, &i->BoundsCheck.index);
+		array_add(ops, &i->BoundsCheck.len);
 		break;
 	case irInstr_SliceBoundsCheck:
-		array_add(ops, i->SliceBoundsCheck.low);
-		array_add(ops, i->SliceBoundsCheck.high);
+		array_add(ops, &i->SliceBoundsCheck.low);
+		array_add(ops, &i->SliceBoundsCheck.high);
+		if (i->SliceBoundsCheck.max != NULL) {
+			array_add(ops, &i->SliceBoundsCheck.max);
+		}
+		break;
+	case irInstr_DebugDeclare:
+		array_add(ops, &i->DebugDeclare.value);
 		break;
 	}
 }
@@ -273,16 +292,16 @@ void ir_opt_blocks(irProcedure *proc) {
 void ir_opt_build_referrers(irProcedure *proc) {
 	gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&proc->module->tmp_arena);
 
-	irValueArray ops = {0}; // NOTE(bill): Act as a buffer
+	irValueRefArray ops = {0}; // NOTE: Act as a buffer
 	array_init_reserve(&ops, proc->module->tmp_allocator, 64); // HACK(bill): This _could_ overflow the temp arena
 	for_array(i, proc->blocks) {
 		irBlock *b = proc->blocks.e[i];
 		for_array(j, b->instrs) {
 			irValue *instr = b->instrs.e[j];
 			array_clear(&ops);
-			ir_opt_add_operands(&ops, &instr->Instr);
+			ir_opt_add_operand_refs(&ops, &instr->Instr);
 			for_array(k, ops) {
-				irValue *op = ops.e[k];
+				irValue *op = *ops.e[k];
 				if (op == NULL) {
 					continue;
 				}
@@ -352,14 +371,12 @@ typedef struct irDomPrePost {
 irDomPrePost ir_opt_number_dom_tree(irBlock *v, i32 pre, i32 post) {
 	irDomPrePost result = {pre, post};
 
-	v->dom.pre = pre++;
+	v->dom.pre = result.pre++;
 	for_array(i, v->dom.children) {
 		result = ir_opt_number_dom_tree(v->dom.children.e[i], result.pre, result.post);
 	}
-	v->dom.post = post++;
+	v->dom.post = result.post++;
 
-	result.pre  = pre;
-	result.post = post;
 	return result;
 }
 
@@ -372,6 +389,7 @@ void ir_opt_build_dom_tree(irProcedure *proc) {
 
 	isize n = proc->blocks.count;
 	irBlock **buf = gb_alloc_array(proc->module->tmp_allocator, irBlock *, 5*n);
+	gb_zero_size(buf, gb_size_of(irBlock *)*5*n);
 
 	irLTState lt = {0};
 	lt.count    = n;
@@ -451,12 +469,406 @@ void ir_opt_build_dom_tree(irProcedure *proc) {
 	gb_temp_arena_memory_end(tmp);
 }
 
+// NOTE: mem2reg promotes the locals which are only ever loaded from and stored to
+// into SSA registers. Phi nodes are placed at the iterated dominance frontiers of the blocks
+// which store to a local (Cytron et al.) and then the loads are renamed by walking the
+// dominator tree. Requires `ir_opt_build_referrers` and `ir_opt_build_dom_tree`
+
+typedef struct irNewPhi {
+	struct irNewPhi *next;
+	irValue *        phi;
+	isize            local; // Index into `irMem2Reg.locals`
+} irNewPhi;
+
+typedef struct irMem2Reg {
+	irProcedure * proc;
+	gbAllocator   allocator; // NOTE: Temporary
+	irValue **    locals;
+	irValue **    zero_values;
+	isize         local_count;
+	irNewPhi **   block_phis;   // Index: irBlock.index
+	MapIrValue    replacements; // Key: irValue * (irInstr_Load)
+} irMem2Reg;
+
+bool ir_opt_is_local_promotable(irValue *local) {
+	irInstr *l = &local->Instr;
+	Type *t = l->Local.entity->type;
+	// NOTE: Aggregates are nearly always accessed through element pointers and
+	// LLVM is better at splitting those itself
+	if (!is_type_integer(t) && !is_type_float(t) && !is_type_boolean(t) &&
+	    !is_type_pointer(t) && !is_type_rawptr(t) && !is_type_proc(t)) {
+		return false;
+	}
+
+	for_array(i, l->Local.referrers) {
+		irInstr *r = &l->Local.referrers.e[i]->Instr;
+		switch (r->kind) {
+		case irInstr_Load:
+			if (!are_types_identical(r->Load.type, t)) {
+				return false;
+			}
+			break;
+		case irInstr_Store:
+			// NOTE: Storing the address itself means it escapes
+			if (r->Store.address != local || r->Store.value == local) {
+				return false;
+			}
+			if (!are_types_identical(ir_type(r->Store.value), t)) {
+				return false;
+			}
+			break;
+		case irInstr_ZeroInit:
+		case irInstr_DebugDeclare:
+			break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
+// NOTE: Returns -1 if `v` is not a promoted local
+isize ir_mem2reg_local_index(irValue *v) {
+	if (v != NULL && v->kind == irValue_Instr && v->Instr.kind == irInstr_Local) {
+		// NOTE: Registers are not numbered until after the optimizations so `index`
+		// is used to store the promoted local index in the mean time
+		return v->index;
+	}
+	return -1;
+}
+
+irValue *ir_mem2reg_resolve(irMem2Reg *s, irValue *v) {
+	while (v != NULL && v->kind == irValue_Instr && v->Instr.kind == irInstr_Load) {
+		irValue **found = map_ir_value_get(&s->replacements, hash_pointer(v));
+		if (found == NULL) {
+			break;
+		}
+		v = *found;
+	}
+	return v;
+}
+
+void ir_mem2reg_place_phis(irMem2Reg *s, irBlockArray *frontiers) {
+	irProcedure *proc = s->proc;
+	isize n = proc->blocks.count;
+	i32 *has_phi   = gb_alloc_array(s->allocator, i32, n);
+	i32 *work      = gb_alloc_array(s->allocator, i32, n);
+	irBlock **list = gb_alloc_array(s->allocator, irBlock *, n);
+	gb_zero_size(has_phi, gb_size_of(i32)*n);
+	gb_zero_size(work,    gb_size_of(i32)*n);
+
+	for (isize k = 0; k < s->local_count; k++) {
+		i32 stamp = cast(i32)(k+1);
+		isize list_count = 0;
+		irValueArray *refs = &s->locals[k]->Instr.Local.referrers;
+		for_array(i, *refs) {
+			irInstr *r = &refs->e[i]->Instr;
+			if (r->kind == irInstr_Store || r->kind == irInstr_ZeroInit) {
+				irBlock *b = r->parent;
+				if (work[b->index] != stamp) {
+					work[b->index] = stamp;
+					list[list_count++] = b;
+				}
+			}
+		}
+
+		while (list_count > 0) {
+			irBlock *x = list[--list_count];
+			for_array(i, frontiers[x->index]) {
+				irBlock *y = frontiers[x->index].e[i];
+				if (has_phi[y->index] == stamp) {
+					continue;
+				}
+				has_phi[y->index] = stamp;
+
+				Type *t = s->locals[k]->Instr.Local.entity->type;
+				irValueArray edges = {0};
+				array_init_count(&edges, proc->module->allocator, y->preds.count);
+				irValue *phi = ir_instr_phi(proc, edges, t);
+				phi->Instr.parent = y;
+
+				irNewPhi *np = gb_alloc_item(s->allocator, irNewPhi);
+				np->phi   = phi;
+				np->local = k;
+				np->next  = s->block_phis[y->index];
+				s->block_phis[y->index] = np;
+
+				if (work[y->index] != stamp) {
+					work[y->index] = stamp;
+					list[list_count++] = y;
+				}
+			}
+		}
+	}
+}
+
+void ir_mem2reg_rename(irMem2Reg *s, irBlock *b, irValue **values) {
+	for (irNewPhi *np = s->block_phis[b->index]; np != NULL; np = np->next) {
+		values[np->local] = np->phi;
+	}
+
+	for_array(i, b->instrs) {
+		irValue *v = b->instrs.e[i];
+		irInstr *instr = &v->Instr;
+		isize k = -1;
+		switch (instr->kind) {
+		case irInstr_Store:
+			k = ir_mem2reg_local_index(instr->Store.address);
+			if (k >= 0) {
+				values[k] = ir_mem2reg_resolve(s, instr->Store.value);
+			}
+			break;
+		case irInstr_ZeroInit:
+			k = ir_mem2reg_local_index(instr->ZeroInit.address);
+			if (k >= 0) {
+				values[k] = s->zero_values[k];
+			}
+			break;
+		case irInstr_Load:
+			k = ir_mem2reg_local_index(instr->Load.address);
+			if (k >= 0) {
+				// NOTE: A load before any store is undefined, zero is as good as anything
+				irValue *value = values[k] != NULL ? values[k] : s->zero_values[k];
+				map_ir_value_set(&s->replacements, hash_pointer(v), value);
+			}
+			break;
+		default: break;
+		}
+	}
+
+	for_array(i, b->succs) {
+		irBlock *succ = b->succs.e[i];
+		for_array(j, succ->preds) {
+			if (succ->preds.e[j] != b) {
+				continue;
+			}
+			for (irNewPhi *np = s->block_phis[succ->index]; np != NULL; np = np->next) {
+				irValue *value = values[np->local];
+				np->phi->Instr.Phi.edges.e[j] = value != NULL ? value : s->zero_values[np->local];
+			}
+		}
+	}
+
+	isize child_count = b->dom.children.count;
+	for (isize i = 0; i < child_count; i++) {
+		irValue **child_values = values;
+		if (i+1 < child_count) {
+			// NOTE: The last child can reuse the values as nothing needs them afterwards
+			child_values = gb_alloc_array(s->allocator, irValue *, s->local_count);
+			gb_memcopy(child_values, values, gb_size_of(irValue *)*s->local_count);
+		}
+		ir_mem2reg_rename(s, b->dom.children.e[i], child_values);
+	}
+}
+
+// NOTE: Removes the new phi nodes which are not used by anything but other unused phis
+void ir_mem2reg_remove_dead_phis(irMem2Reg *s, irValueRefArray *ops) {
+	irProcedure *proc = s->proc;
+	MapIrValue new_phis = {0}; // Key: irValue * | The ones which are live are removed
+	map_ir_value_init(&new_phis, heap_allocator());
+	irValueArray live = {0};
+	array_init(&live, heap_allocator());
+
+	for_array(i, proc->blocks) {
+		for (irNewPhi *np = s->block_phis[i]; np != NULL; np = np->next) {
+			map_ir_value_set(&new_phis, hash_pointer(np->phi), np->phi);
+		}
+	}
+
+	for_array(i, proc->blocks) {
+		irBlock *b = proc->blocks.e[i];
+		for_array(j, b->instrs) {
+			irValue *v = b->instrs.e[j];
+			if (map_ir_value_get(&new_phis, hash_pointer(v)) != NULL) {
+				continue;
+			}
+			array_clear(ops);
+			ir_opt_add_operand_refs(ops, &v->Instr);
+			for_array(k, *ops) {
+				irValue *op = *ops->e[k];
+				if (op != NULL && map_ir_value_get(&new_phis, hash_pointer(op)) != NULL) {
+					map_ir_value_remove(&new_phis, hash_pointer(op));
+					array_add(&live, op);
+				}
+			}
+		}
+	}
+	while (live.count > 0) {
+		irValue *phi = live.e[live.count-1];
+		array_pop(&live);
+		for_array(k, phi->Instr.Phi.edges) {
+			irValue *op = phi->Instr.Phi.edges.e[k];
+			if (op != NULL && map_ir_value_get(&new_phis, hash_pointer(op)) != NULL) {
+				map_ir_value_remove(&new_phis, hash_pointer(op));
+				array_add(&live, op);
+			}
+		}
+	}
+
+	if (new_phis.entries.count > 0) {
+		for_array(i, proc->blocks) {
+			irBlock *b = proc->blocks.e[i];
+			isize count = 0;
+			for_array(j, b->instrs) {
+				irValue *v = b->instrs.e[j];
+				if (v->Instr.kind == irInstr_Phi && map_ir_value_get(&new_phis, hash_pointer(v)) != NULL) {
+					continue;
+				}
+				b->instrs.e[count++] = v;
+			}
+			b->instrs.count = count;
+		}
+	}
+
+	array_free(&live);
+	map_ir_value_destroy(&new_phis);
+}
+
 void ir_opt_mem2reg(irProcedure *proc) {
-	// TODO(bill): ir_opt_mem2reg
+	irBlock *decl_block = proc->decl_block;
+	if (decl_block->locals.count == 0) {
+		return;
+	}
+
+	gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&proc->module->tmp_arena);
+
+	irMem2Reg s = {0};
+	s.proc      = proc;
+	s.allocator = proc->module->tmp_allocator;
+	s.locals      = gb_alloc_array(s.allocator, irValue *, decl_block->locals.count);
+	s.zero_values = gb_alloc_array(s.allocator, irValue *, decl_block->locals.count);
+	for_array(i, decl_block->locals) {
+		irValue *local = decl_block->locals.e[i];
+		local->index = -1;
+		if (ir_opt_is_local_promotable(local)) {
+			local->index = cast(i32)s.local_count;
+			s.zero_values[s.local_count] = ir_value_nil(proc->module->allocator, local->Instr.Local.entity->type);
+			s.locals[s.local_count++] = local;
+		}
+	}
+
+	if (s.local_count > 0) {
+		isize n = proc->blocks.count;
+
+		// NOTE: Dominance frontiers (Cooper, Harvey, and Kennedy)
+		irBlockArray *frontiers = gb_alloc_array(s.allocator, irBlockArray, n);
+		for (isize i = 0; i < n; i++) {
+			array_init(&frontiers[i], s.allocator);
+		}
+		for_array(i, proc->blocks) {
+			irBlock *b = proc->blocks.e[i];
+			if (b->preds.count < 2) {
+				continue;
+			}
+			for_array(j, b->preds) {
+				for (irBlock *runner = b->preds.e[j]; runner != NULL && runner != b->dom.idom; runner = runner->dom.idom) {
+					irBlockArray *df = &frontiers[runner->index];
+					if (df->count > 0 && df->e[df->count-1] == b) {
+						continue;
+					}
+					array_add(df, b);
+				}
+			}
+		}
+
+		s.block_phis = gb_alloc_array(s.allocator, irNewPhi *, n);
+		gb_zero_size(s.block_phis, gb_size_of(irNewPhi *)*n);
+		ir_mem2reg_place_phis(&s, frontiers);
+
+		map_ir_value_init(&s.replacements, heap_allocator());
+		irValue **values = gb_alloc_array(s.allocator, irValue *, s.local_count);
+		gb_zero_size(values, gb_size_of(irValue *)*s.local_count);
+		ir_mem2reg_rename(&s, proc->blocks.e[0], values);
+
+		irValueRefArray ops = {0};
+		array_init_reserve(&ops, s.allocator, 64);
+
+		for_array(i, proc->blocks) {
+			irBlock *b = proc->blocks.e[i];
+			isize phi_count = 0;
+			for (irNewPhi *np = s.block_phis[b->index]; np != NULL; np = np->next) {
+				phi_count++;
+			}
+
+			// NOTE: Remove the promoted locals and every access of them, and put
+			// the new phi nodes at the start of the block
+			irValueArray instrs = {0};
+			array_init_reserve(&instrs, heap_allocator(), phi_count + b->instrs.count);
+			for (irNewPhi *np = s.block_phis[b->index]; np != NULL; np = np->next) {
+				array_add(&instrs, np->phi);
+			}
+			for_array(j, b->instrs) {
+				irValue *v = b->instrs.e[j];
+				irInstr *instr = &v->Instr;
+				bool remove = false;
+				switch (instr->kind) {
+				case irInstr_Local:        remove = ir_mem2reg_local_index(v) >= 0;                          break;
+				case irInstr_Store:        remove = ir_mem2reg_local_index(instr->Store.address) >= 0;       break;
+				case irInstr_ZeroInit:     remove = ir_mem2reg_local_index(instr->ZeroInit.address) >= 0;    break;
+				case irInstr_Load:         remove = ir_mem2reg_local_index(instr->Load.address) >= 0;        break;
+				case irInstr_DebugDeclare: remove = ir_mem2reg_local_index(instr->DebugDeclare.value) >= 0;  break;
+				default: break;
+				}
+				if (remove) {
+					continue;
+				}
+
+				array_clear(&ops);
+				ir_opt_add_operand_refs(&ops, instr);
+				for_array(k, ops) {
+					*ops.e[k] = ir_mem2reg_resolve(&s, *ops.e[k]);
+				}
+				array_add(&instrs, v);
+			}
+			array_free(&b->instrs);
+			b->instrs = instrs;
+		}
+
+		// NOTE: The edges of the new phis were not in any block when they were rewritten
+		for (isize i = 0; i < n; i++) {
+			for (irNewPhi *np = s.block_phis[i]; np != NULL; np = np->next) {
+				irValueArray *edges = &np->phi->Instr.Phi.edges;
+				for_array(j, *edges) {
+					edges->e[j] = ir_mem2reg_resolve(&s, edges->e[j]);
+				}
+			}
+		}
+
+		ir_mem2reg_remove_dead_phis(&s, &ops);
+
+		isize local_count = 0;
+		for_array(i, decl_block->locals) {
+			irValue *local = decl_block->locals.e[i];
+			if (ir_mem2reg_local_index(local) < 0) {
+				decl_block->locals.e[local_count++] = local;
+			}
+		}
+		decl_block->locals.count = local_count;
+		proc->local_count = cast(i32)local_count;
+
+		map_ir_value_destroy(&s.replacements);
+	}
+
+	for_array(i, decl_block->locals) {
+		decl_block->locals.e[i]->index = 0;
+	}
+	for (isize i = 0; i < s.local_count; i++) {
+		s.locals[i]->index = 0;
+	}
+
+	gb_temp_arena_memory_end(tmp);
 }
 
 
 
+isize ir_opt_proc_instr_count(irProcedure *proc) {
+	isize count = 0;
+	for_array(i, proc->blocks) {
+		count += proc->blocks.e[i]->instrs.count;
+	}
+	return count;
+}
+
 void ir_opt_tree(irGen *s) {
 	s->opt_called = true;
 
@@ -467,7 +879,8 @@ void ir_opt_tree(irGen *s) {
 		}
 
 		ir_opt_blocks(proc);
-	#if 0
+		s->module.instr_count_before_opt += ir_opt_proc_instr_count(proc);
+
 		ir_opt_build_referrers(proc);
 		ir_opt_build_dom_tree(proc);
 
@@ -479,11 +892,10 @@ void ir_opt_tree(irGen *s) {
 		// [ ] phi elim
 		// [ ] short circuit elim
 		// [ ] bounds check elim
-		// [ ] lift/mem2reg
-		// [ ] lift/mem2reg
+		// [x] lift/mem2reg
 
 		ir_opt_mem2reg(proc);
-	#endif
+		s->module.instr_count_after_opt += ir_opt_proc_instr_count(proc);
 
 		GB_ASSERT(proc->blocks.count > 0);
 		ir_number_proc_registers(proc);
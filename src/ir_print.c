@@ -1,7 +1,14 @@
 typedef struct irFileBuffer {
 	gbVirtualMemory vm;
 	isize           offset;
-	gbFile *        output;
+	gbFile *        output;        // NOTE: If NULL, the buffer grows rather than being written out
+	i64             written;       // NOTE: Bytes already written to `output`
+	gbArena         tmp_arena;     // NOTE: Temporary memory for whichever thread prints into this buffer
+	gbAllocator     tmp_allocator;
+
+	// NOTE: If set, strings made into globals whilst printing are added here rather than to the module
+	irValueArray *  global_strings;
+	isize           global_string_proc_index;
 } irFileBuffer;
 
 void ir_file_buffer_init(irFileBuffer *f, gbFile *output) {
@@ -9,37 +16,110 @@ void ir_file_buffer_init(irFileBuffer *f, gbFile *output) {
 	f->vm = gb_vm_alloc(NULL, size);
 	f->offset = 0;
 	f->output = output;
+	f->written = 0;
+	gb_arena_init_from_allocator(&f->tmp_arena, heap_allocator(), gb_megabytes(1));
+	f->tmp_allocator = gb_arena_allocator(&f->tmp_arena);
 }
 
-void ir_file_buffer_destroy(irFileBuffer *f) {
-	if (f->offset > 0) {
-		// NOTE(bill): finish writing buffered data
+void ir_file_buffer_flush(irFileBuffer *f) {
+	if (f->offset > 0 && f->output != NULL) {
 		gb_file_write(f->output, f->vm.data, f->offset);
+		f->written += f->offset;
+		f->offset = 0;
 	}
+}
+
+void ir_file_buffer_destroy(irFileBuffer *f) {
+	// NOTE(bill): finish writing buffered data
+	ir_file_buffer_flush(f);
 
 	gb_vm_free(f->vm);
+	gb_arena_free(&f->tmp_arena);
 }
 
-void ir_file_buffer_write(irFileBuffer *f, void *data, isize len) {
-	if (len > f->vm.size) {
-		gb_file_write(f->output, data, len);
-		return;
+void ir_file_buffer_grow(irFileBuffer *f, isize min_size) {
+	isize size = gb_max(2*f->vm.size, min_size);
+	gbVirtualMemory vm = gb_vm_alloc(NULL, size);
+	gb_memmove(vm.data, f->vm.data, f->offset);
+	gb_vm_free(f->vm);
+	f->vm = vm;
+}
+
+// NOTE: Only called once the buffer is full, so that `ir_file_buffer_write` stays small
+void ir_file_buffer_write_slow(irFileBuffer *f, void *data, isize len) {
+	if (f->output == NULL) {
+		ir_file_buffer_grow(f, f->offset+len);
+	} else {
+		// NOTE: Anything already buffered must come first
+		ir_file_buffer_flush(f);
+		if (len > f->vm.size) {
+			gb_file_write(f->output, data, len);
+			f->written += len;
+			return;
+		}
 	}
+	gb_memcopy(cast(u8 *)f->vm.data + f->offset, data, len);
+	f->offset += len;
+}
 
+void ir_file_buffer_write(irFileBuffer *f, void *data, isize len) {
 	if ((f->vm.size - f->offset) < len) {
-		gb_file_write(f->output, f->vm.data, f->offset);
-		f->offset = 0;
+		ir_file_buffer_write_slow(f, data, len);
+		return;
 	}
-	u8 *cursor = cast(u8 *)f->vm.data + f->offset;
-	gb_memmove(cursor, data, len);
+	gb_memcopy(cast(u8 *)f->vm.data + f->offset, data, len);
 	f->offset += len;
 }
 
 
+// NOTE: The printer writes with these rather than `ir_fprintf` wherever it can as they do not
+// have to parse a format string nor format into a temporary buffer first
+// NOTE: `s` must be a string literal as its length is taken from its size, the `"" s` will not
+// compile with anything else (e.g. a `char *`, whose size is that of the pointer)
+#define ir_write_str_lit(f, s) ir_file_buffer_write((f), ("" s), gb_size_of("" s)-1)
+
+void ir_write_string(irFileBuffer *f, String s) {
+	ir_file_buffer_write(f, s.text, s.len);
+}
+
+void ir_write_byte(irFileBuffer *f, u8 c) {
+	if (f->offset < f->vm.size) {
+		(cast(u8 *)f->vm.data)[f->offset++] = c;
+		return;
+	}
+	ir_file_buffer_write_slow(f, &c, 1);
+}
+
+void ir_write_u64(irFileBuffer *f, u64 i) {
+	u8 buf[20];
+	isize n = gb_size_of(buf);
+	do {
+		buf[--n] = cast(u8)('0' + i%10);
+		i /= 10;
+	} while (i > 0);
+	ir_file_buffer_write(f, buf+n, gb_size_of(buf)-n);
+}
+
+void ir_write_i64(irFileBuffer *f, i64 i) {
+	if (i < 0) {
+		ir_write_byte(f, '-');
+		ir_write_u64(f, 0ull - cast(u64)i);
+	} else {
+		ir_write_u64(f, cast(u64)i);
+	}
+}
+
+// NOTE: The name of an unnamed local value, e.g. `%12`
+void ir_write_register(irFileBuffer *f, i32 index) {
+	ir_write_byte(f, '%');
+	ir_write_i64(f, index);
+}
+
+
 void ir_fprintf(irFileBuffer *f, char *fmt, ...) {
 	va_list va;
 	va_start(va, fmt);
-	char buf[4096] = {0};
+	char buf[4096];
 	isize len = gb_snprintf_va(buf, gb_size_of(buf), fmt, va);
 	ir_file_buffer_write(f, buf, len-1);
 	va_end(va);
@@ -72,65 +152,50 @@ bool ir_valid_char(u8 c) {
 }
 
 void ir_print_escape_string(irFileBuffer *f, String name, bool print_quotes) {
-	isize extra = 0;
-	for (isize i = 0; i < name.len; i++) {
-		u8 c = name.text[i];
-		if (!ir_valid_char(c)) {
-			extra += 2;
-		}
+	isize i = 0;
+	while (i < name.len && ir_valid_char(name.text[i])) {
+		i++;
 	}
-
-	if (extra == 0) {
-		ir_fprintf(f, "%.*s", LIT(name));
+	if (i == name.len) {
+		ir_write_string(f, name);
 		return;
 	}
 
-
-	char hex_table[] = "0123456789ABCDEF";
-	isize buf_len = name.len + extra + 2;
-
-	gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&string_buffer_arena);
-
-	u8 *buf = gb_alloc_array(string_buffer_allocator, u8, buf_len);
-
-	isize j = 0;
+	char const hex_table[] = "0123456789ABCDEF";
 
 	if (print_quotes) {
-		buf[j++] = '"';
+		ir_write_byte(f, '"');
 	}
 
-	for (isize i = 0; i < name.len; i++) {
+	// NOTE: Write the runs of valid characters straight from `name`
+	isize run_start = 0;
+	for (; i < name.len; i++) {
 		u8 c = name.text[i];
-		if (ir_valid_char(c)) {
-			buf[j++] = c;
-		} else {
-			buf[j] = '\\';
-			buf[j+1] = hex_table[c >> 4];
-			buf[j+2] = hex_table[c & 0x0f];
-			j += 3;
+		if (!ir_valid_char(c)) {
+			u8 escaped[3] = {'\\', hex_table[c >> 4], hex_table[c & 0x0f]};
+			ir_file_buffer_write(f, name.text+run_start, i-run_start);
+			ir_file_buffer_write(f, escaped, gb_size_of(escaped));
+			run_start = i+1;
 		}
 	}
+	ir_file_buffer_write(f, name.text+run_start, name.len-run_start);
 
 	if (print_quotes) {
-		buf[j++] = '"';
+		ir_write_byte(f, '"');
 	}
-
-	ir_file_write(f, buf, j);
-
-	gb_temp_arena_memory_end(tmp);
 }
 
 
 
 void ir_print_encoded_local(irFileBuffer *f, String name) {
-	ir_fprintf(f, "%%");
+	ir_write_str_lit(f, "%");
 	ir_print_escape_string(f, name, true);
 }
 
 void ir_print_encoded_global(irFileBuffer *f, String name, bool remove_prefix) {
-	ir_fprintf(f, "@");
+	ir_write_str_lit(f, "@");
 	if (!remove_prefix) {
-		ir_fprintf(f, ".");
+		ir_write_str_lit(f, ".");
 	}
 	ir_print_escape_string(f, name, true);
 }
@@ -145,47 +210,53 @@ void ir_print_type(irFileBuffer *f, irModule *m, Type *t) {
 	switch (t->kind) {
 	case Type_Basic:
 		switch (t->Basic.kind) {
-		case Basic_bool:   ir_fprintf(f, "i1");                       return;
-		case Basic_i8:     ir_fprintf(f, "i8");                       return;
-		case Basic_u8:     ir_fprintf(f, "i8");                       return;
-		case Basic_i16:    ir_fprintf(f, "i16");                      return;
-		case Basic_u16:    ir_fprintf(f, "i16");                      return;
-		case Basic_i32:    ir_fprintf(f, "i32");                      return;
-		case Basic_u32:    ir_fprintf(f, "i32");                      return;
-		case Basic_i64:    ir_fprintf(f, "i64");                      return;
-		case Basic_u64:    ir_fprintf(f, "i64");                      return;
-
-		case Basic_f32:    ir_fprintf(f, "float");                    return;
-		case Basic_f64:    ir_fprintf(f, "double");                   return;
-
-		case Basic_complex64:  ir_fprintf(f, "%%..complex64");        return;
-		case Basic_complex128: ir_fprintf(f, "%%..complex128");       return;
-
-		case Basic_quaternion128: ir_fprintf(f, "%%..quaternion128"); return;
-		case Basic_quaternion256: ir_fprintf(f, "%%..quaternion256"); return;
-
-		case Basic_rawptr: ir_fprintf(f, "%%..rawptr");               return;
-		case Basic_string: ir_fprintf(f, "%%..string");               return;
-		case Basic_uint:   ir_fprintf(f, "i%lld", word_bits);         return;
-		case Basic_int:    ir_fprintf(f, "i%lld", word_bits);         return;
-		case Basic_any:    ir_fprintf(f, "%%..any");                  return;
+		case Basic_bool:          ir_write_str_lit(f, "i1");                          return;
+		case Basic_i8:            ir_write_str_lit(f, "i8");                          return;
+		case Basic_u8:            ir_write_str_lit(f, "i8");                          return;
+		case Basic_i16:           ir_write_str_lit(f, "i16");                         return;
+		case Basic_u16:           ir_write_str_lit(f, "i16");                         return;
+		case Basic_i32:           ir_write_str_lit(f, "i32");                         return;
+		case Basic_u32:           ir_write_str_lit(f, "i32");                         return;
+		case Basic_i64:           ir_write_str_lit(f, "i64");                         return;
+		case Basic_u64:           ir_write_str_lit(f, "i64");                         return;
+
+		case Basic_f32:           ir_write_str_lit(f, "float");                       return;
+		case Basic_f64:           ir_write_str_lit(f, "double");                      return;
+
+		case Basic_complex64:     ir_write_str_lit(f, "%..complex64");                return;
+		case Basic_complex128:    ir_write_str_lit(f, "%..complex128");               return;
+
+		case Basic_quaternion128: ir_write_str_lit(f, "%..quaternion128");            return;
+		case Basic_quaternion256: ir_write_str_lit(f, "%..quaternion256");            return;
+
+		case Basic_rawptr:        ir_write_str_lit(f, "%..rawptr");                   return;
+		case Basic_string:        ir_write_str_lit(f, "%..string");                   return;
+		case Basic_uint:          ir_write_byte(f, 'i'); ir_write_i64(f, word_bits);  return;
+		case Basic_int:           ir_write_byte(f, 'i'); ir_write_i64(f, word_bits);  return;
+		case Basic_any:           ir_write_str_lit(f, "%..any");                      return;
 		}
 		break;
 	case Type_Pointer:
 		ir_print_type(f, m, t->Pointer.elem);
-		ir_fprintf(f, "*");
+		ir_write_str_lit(f, "*");
 		return;
 	case Type_Array:
-		ir_fprintf(f, "[%lld x ", t->Array.count);
+		ir_write_byte(f, '[');
+		ir_write_i64(f, t->Array.count);
+		ir_write_str_lit(f, " x ");
 		ir_print_type(f, m, t->Array.elem);
-		ir_fprintf(f, "]");
+		ir_write_str_lit(f, "]");
 		return;
 	case Type_Vector: {
 		i64 align = type_align_of(heap_allocator(), t);
 		i64 count = t->Vector.count;
-		ir_fprintf(f, "{[0 x <%lld x i8>], [%lld x ", align, count);
+		ir_write_str_lit(f, "{[0 x <");
+		ir_write_i64(f, align);
+		ir_write_str_lit(f, " x i8>], [");
+		ir_write_i64(f, count);
+		ir_write_str_lit(f, " x ");
 		ir_print_type(f, m, t->Vector.elem);
-		ir_fprintf(f, "]}");
+		ir_write_str_lit(f, "]}");
 		return;
 	}
 /* 		ir_fprintf(f, "<%lld x ", t->Vector.count);
@@ -193,39 +264,49 @@ void ir_print_type(irFileBuffer *f, irModule *m, Type *t) {
 		ir_fprintf(f, ">");
 		return; */
 	case Type_Slice:
-		ir_fprintf(f, "{");
+		ir_write_str_lit(f, "{");
 		ir_print_type(f, m, t->Slice.elem);
-		ir_fprintf(f, "*, i%lld, i%lld}", word_bits, word_bits);
+		ir_write_str_lit(f, "*, i");
+		ir_write_i64(f, word_bits);
+		ir_write_str_lit(f, ", i");
+		ir_write_i64(f, word_bits);
+		ir_write_str_lit(f, "}");
 		return;
 	case Type_DynamicArray:
-		ir_fprintf(f, "{");
+		ir_write_str_lit(f, "{");
 		ir_print_type(f, m, t->DynamicArray.elem);
-		ir_fprintf(f, "*, i%lld, i%lld,", word_bits, word_bits);
+		ir_write_str_lit(f, "*, i");
+		ir_write_i64(f, word_bits);
+		ir_write_str_lit(f, ", i");
+		ir_write_i64(f, word_bits);
+		ir_write_str_lit(f, ",");
 		ir_print_type(f, m, t_allocator);
-		ir_fprintf(f, "}");
+		ir_write_str_lit(f, "}");
 		return;
 	case Type_Record: {
 		switch (t->Record.kind) {
 		case TypeRecord_Struct:
 			if (t->Record.is_packed) {
-				ir_fprintf(f, "<");
+				ir_write_str_lit(f, "<");
 			}
-			ir_fprintf(f, "{");
+			ir_write_str_lit(f, "{");
 			if (t->Record.custom_align > 0) {
-				ir_fprintf(f, "[0 x <%lld x i8>]", t->Record.custom_align);
+				ir_write_str_lit(f, "[0 x <");
+				ir_write_i64(f, t->Record.custom_align);
+				ir_write_str_lit(f, " x i8>]");
 				if (t->Record.field_count > 0) {
-					ir_fprintf(f, ", ");
+					ir_write_str_lit(f, ", ");
 				}
 			}
 			for (isize i = 0; i < t->Record.field_count; i++) {
 				if (i > 0) {
-					ir_fprintf(f, ", ");
+					ir_write_str_lit(f, ", ");
 				}
 				ir_print_type(f, m, t->Record.fields[i]->type);
 			}
-			ir_fprintf(f, "}");
+			ir_write_str_lit(f, "}");
 			if (t->Record.is_packed) {
-				ir_fprintf(f, ">");
+				ir_write_str_lit(f, ">");
 			}
 			return;
 		case TypeRecord_Union: {
@@ -233,14 +314,24 @@ void ir_print_type(irFileBuffer *f, irModule *m, Type *t) {
 			// LLVM takes the first element's alignment as the entire alignment (like C)
 			i64 size_of_union  = type_size_of(heap_allocator(), t) - build_context.word_size;
 			i64 align_of_union = type_align_of(heap_allocator(), t);
-			ir_fprintf(f, "{[0 x <%lld x i8>], [%lld x i8], i%lld}", align_of_union, size_of_union, word_bits);
+			ir_write_str_lit(f, "{[0 x <");
+			ir_write_i64(f, align_of_union);
+			ir_write_str_lit(f, " x i8>], [");
+			ir_write_i64(f, size_of_union);
+			ir_write_str_lit(f, " x i8], i");
+			ir_write_i64(f, word_bits);
+			ir_write_str_lit(f, "}");
 		} return;
 		case TypeRecord_RawUnion: {
 			// NOTE(bill): The zero size array is used to fix the alignment used in a structure as
 			// LLVM takes the first element's alignment as the entire alignment (like C)
 			i64 size_of_union  = type_size_of(heap_allocator(), t);
 			i64 align_of_union = type_align_of(heap_allocator(), t);
-			ir_fprintf(f, "{[0 x <%lld x i8>], [%lld x i8]}", align_of_union, size_of_union);
+			ir_write_str_lit(f, "{[0 x <");
+			ir_write_i64(f, align_of_union);
+			ir_write_str_lit(f, " x i8>], [");
+			ir_write_i64(f, size_of_union);
+			ir_write_str_lit(f, " x i8]}");
 		} return;
 		case TypeRecord_Enum:
 			ir_print_type(f, m, base_enum_type(t));
@@ -262,31 +353,31 @@ void ir_print_type(irFileBuffer *f, irModule *m, Type *t) {
 		if (t->Tuple.variable_count == 1) {
 			ir_print_type(f, m, t->Tuple.variables[0]->type);
 		} else {
-			ir_fprintf(f, "{");
+			ir_write_str_lit(f, "{");
 			for (isize i = 0; i < t->Tuple.variable_count; i++) {
 				if (i > 0) {
-					ir_fprintf(f, ", ");
+					ir_write_str_lit(f, ", ");
 				}
 				ir_print_type(f, m, t->Tuple.variables[i]->type);
 			}
-			ir_fprintf(f, "}");
+			ir_write_str_lit(f, "}");
 		}
 		return;
 	case Type_Proc: {
 		if (t->Proc.result_count == 0) {
-			ir_fprintf(f, "void");
+			ir_write_str_lit(f, "void");
 		} else {
 			ir_print_type(f, m, t->Proc.results);
 		}
-		ir_fprintf(f, " (");
+		ir_write_str_lit(f, " (");
 		TypeTuple *params = &t->Proc.params->Tuple;
 		for (isize i = 0; i < t->Proc.param_count; i++) {
 			if (i > 0) {
-				ir_fprintf(f, ", ");
+				ir_write_str_lit(f, ", ");
 			}
 			ir_print_type(f, m, params->variables[i]->type);
 		}
-		ir_fprintf(f, ")*");
+		ir_write_str_lit(f, ")*");
 	} return;
 
 	case Type_Map: {
@@ -296,14 +387,31 @@ void ir_print_type(irFileBuffer *f, irModule *m, Type *t) {
 	}
 }
 
+// NOTE: Whilst printing procedures in parallel, the module must not be modified and the
+// names must not depend upon the order the threads get to them, so these are named after the
+// procedure and added to the module once every procedure has been printed
+irValue *ir_print_add_global_string_array(irFileBuffer *f, irModule *m, String string) {
+	if (f->global_strings == NULL) {
+		return ir_add_global_string_array(m, string);
+	}
+	gbAllocator a = heap_allocator();
+	isize max_len = 6+8+1+8+1;
+	u8 *str = cast(u8 *)gb_alloc_array(a, u8, max_len);
+	isize len = gb_snprintf(cast(char *)str, max_len, "__str$%x$%x",
+	                        cast(i32)f->global_string_proc_index, cast(i32)f->global_strings->count);
+	irValue *g = ir_make_global_string_array(a, make_string(str, len-1), string);
+	array_add(f->global_strings, g);
+	return g;
+}
+
 void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *type);
 
 void ir_print_compound_element(irFileBuffer *f, irModule *m, ExactValue v, Type *elem_type) {
 	ir_print_type(f, m, elem_type);
-	ir_fprintf(f, " ");
+	ir_write_str_lit(f, " ");
 
 	if (v.kind == ExactValue_Invalid || base_type(elem_type) == t_any) {
-		ir_fprintf(f, "zeroinitializer");
+		ir_write_str_lit(f, "zeroinitializer");
 	} else {
 		ir_print_exact_value(f, m, v, elem_type);
 	}
@@ -321,50 +429,58 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 
 	switch (value.kind) {
 	case ExactValue_Bool:
-		ir_fprintf(f, "%s", (value.value_bool ? "true" : "false"));
+		if (value.value_bool) {
+			ir_write_str_lit(f, "true");
+		} else {
+			ir_write_str_lit(f, "false");
+		}
 		break;
 	case ExactValue_String: {
 		String str = value.value_string;
 		if (str.len == 0) {
-			ir_fprintf(f, "zeroinitializer");
+			ir_write_str_lit(f, "zeroinitializer");
 			break;
 		}
 		if (!is_type_string(type)) {
 			GB_ASSERT(is_type_array(type));
-			ir_fprintf(f, "c\"");
+			ir_write_str_lit(f, "c\"");
 			ir_print_escape_string(f, str, false);
-			ir_fprintf(f, "\"");
+			ir_write_str_lit(f, "\"");
 		} else {
 			// HACK NOTE(bill): This is a hack but it works because strings are created at the very end
 			// of the .ll file
-			irValue *str_array = ir_add_global_string_array(m, str);
+			irValue *str_array = ir_print_add_global_string_array(f, m, str);
 
-			ir_fprintf(f, "{i8* getelementptr inbounds (");
+			ir_write_str_lit(f, "{i8* getelementptr inbounds (");
 			ir_print_type(f, m, str_array->Global.entity->type);
-			ir_fprintf(f, ", ");
+			ir_write_str_lit(f, ", ");
 			ir_print_type(f, m, str_array->Global.entity->type);
-			ir_fprintf(f, "* ");
+			ir_write_str_lit(f, "* ");
 			ir_print_encoded_global(f, str_array->Global.entity->token.string, false);
-			ir_fprintf(f, ", ");
+			ir_write_str_lit(f, ", ");
 			ir_print_type(f, m, t_int);
-			ir_fprintf(f, " 0, i32 0), ");
+			ir_write_str_lit(f, " 0, i32 0), ");
 			ir_print_type(f, m, t_int);
-			ir_fprintf(f, " %lld}", cast(i64)str.len);
+			ir_write_byte(f, ' ');
+			ir_write_i64(f, str.len);
+			ir_write_byte(f, '}');
 		}
 	} break;
 	case ExactValue_Integer: {
 		if (is_type_pointer(type)) {
 			if (value.value_integer == 0) {
-				ir_fprintf(f, "null");
+				ir_write_str_lit(f, "null");
 			} else {
-				ir_fprintf(f, "inttoptr (");
+				ir_write_str_lit(f, "inttoptr (");
 				ir_print_type(f, m, t_int);
-				ir_fprintf(f, " %llu to ", value.value_integer);
+				ir_write_byte(f, ' ');
+				ir_write_u64(f, cast(u64)value.value_integer);
+				ir_write_str_lit(f, " to ");
 				ir_print_type(f, m, t_rawptr);
-				ir_fprintf(f, ")");
+				ir_write_str_lit(f, ")");
 			}
 		} else {
-			ir_fprintf(f, "%lld", value.value_integer);
+			ir_write_i64(f, value.value_integer);
 		}
 	} break;
 	case ExactValue_Float: {
@@ -396,24 +512,24 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 		type = core_type(type);
 		if (is_type_quaternion(type)) {
 			Type *ft = base_quaternion_elem_type(type);
-			ir_fprintf(f, " {"); ir_print_type(f, m, ft); ir_fprintf(f, " ");
+			ir_write_str_lit(f, " {"); ir_print_type(f, m, ft); ir_write_str_lit(f, " ");
 			ir_print_exact_value(f, m, exact_value_float(value.value_complex.real), ft);
-			ir_fprintf(f, ", "); ir_print_type(f, m, ft); ir_fprintf(f, " ");
+			ir_write_str_lit(f, ", "); ir_print_type(f, m, ft); ir_write_str_lit(f, " ");
 			ir_print_exact_value(f, m, exact_value_float(value.value_complex.imag), ft);
-			ir_fprintf(f, ", "); ir_print_type(f, m, ft); ir_fprintf(f, " ");
+			ir_write_str_lit(f, ", "); ir_print_type(f, m, ft); ir_write_str_lit(f, " ");
 			ir_print_exact_value(f, m, exact_value_float(0), ft);
-			ir_fprintf(f, ", "); ir_print_type(f, m, ft); ir_fprintf(f, " ");
+			ir_write_str_lit(f, ", "); ir_print_type(f, m, ft); ir_write_str_lit(f, " ");
 			ir_print_exact_value(f, m, exact_value_float(0), ft);
-			ir_fprintf(f, "}");
+			ir_write_str_lit(f, "}");
 
 		} else {
 			GB_ASSERT_MSG(is_type_complex(type), "%s", type_to_string(type));
 			Type *ft = base_complex_elem_type(type);
-			ir_fprintf(f, " {"); ir_print_type(f, m, ft); ir_fprintf(f, " ");
+			ir_write_str_lit(f, " {"); ir_print_type(f, m, ft); ir_write_str_lit(f, " ");
 			ir_print_exact_value(f, m, exact_value_float(value.value_complex.real), ft);
-			ir_fprintf(f, ", "); ir_print_type(f, m, ft); ir_fprintf(f, " ");
+			ir_write_str_lit(f, ", "); ir_print_type(f, m, ft); ir_write_str_lit(f, " ");
 			ir_print_exact_value(f, m, exact_value_float(value.value_complex.imag), ft);
-			ir_fprintf(f, "}");
+			ir_write_str_lit(f, "}");
 		}
 	} break;
 
@@ -421,26 +537,28 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 		GB_ASSERT_MSG(is_type_quaternion(type), "%s", type_to_string(type));
 		type = core_type(type);
 		Type *ft = base_quaternion_elem_type(type);
-		ir_fprintf(f, " {"); ir_print_type(f, m, ft); ir_fprintf(f, " ");
+		ir_write_str_lit(f, " {"); ir_print_type(f, m, ft); ir_write_str_lit(f, " ");
 		ir_print_exact_value(f, m, exact_value_float(value.value_quaternion.real), ft);
-		ir_fprintf(f, ", "); ir_print_type(f, m, ft); ir_fprintf(f, " ");
+		ir_write_str_lit(f, ", "); ir_print_type(f, m, ft); ir_write_str_lit(f, " ");
 		ir_print_exact_value(f, m, exact_value_float(value.value_quaternion.imag), ft);
-		ir_fprintf(f, ", "); ir_print_type(f, m, ft); ir_fprintf(f, " ");
+		ir_write_str_lit(f, ", "); ir_print_type(f, m, ft); ir_write_str_lit(f, " ");
 		ir_print_exact_value(f, m, exact_value_float(value.value_quaternion.jmag), ft);
-		ir_fprintf(f, ", "); ir_print_type(f, m, ft); ir_fprintf(f, " ");
+		ir_write_str_lit(f, ", "); ir_print_type(f, m, ft); ir_write_str_lit(f, " ");
 		ir_print_exact_value(f, m, exact_value_float(value.value_quaternion.kmag), ft);
-		ir_fprintf(f, "}");
+		ir_write_str_lit(f, "}");
 	} break;
 
 	case ExactValue_Pointer:
 		if (value.value_pointer == 0) {
-			ir_fprintf(f, "null");
+			ir_write_str_lit(f, "null");
 		} else {
-			ir_fprintf(f, "inttoptr (");
+			ir_write_str_lit(f, "inttoptr (");
 			ir_print_type(f, m, t_int);
-			ir_fprintf(f, " %llu to ", cast(u64)cast(uintptr)value.value_pointer);
+			ir_write_byte(f, ' ');
+			ir_write_u64(f, cast(u64)cast(uintptr)value.value_pointer);
+			ir_write_str_lit(f, " to ");
 			ir_print_type(f, m, t_rawptr);
-			ir_fprintf(f, ")");
+			ir_write_str_lit(f, ")");
 		}
 		break;
 
@@ -450,16 +568,16 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 			ast_node(cl, CompoundLit, value.value_compound);
 			isize elem_count = cl->elems.count;
 			if (elem_count == 0) {
-				ir_fprintf(f, "zeroinitializer");
+				ir_write_str_lit(f, "zeroinitializer");
 				break;
 			}
 
-			ir_fprintf(f, "[");
+			ir_write_str_lit(f, "[");
 			Type *elem_type = type->Array.elem;
 
 			for (isize i = 0; i < elem_count; i++) {
 				if (i > 0) {
-					ir_fprintf(f, ", ");
+					ir_write_str_lit(f, ", ");
 				}
 				TypeAndValue *tav = type_and_value_of_expression(m->info, cl->elems.e[i]);
 				GB_ASSERT(tav != NULL);
@@ -467,28 +585,32 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 			}
 			for (isize i = elem_count; i < type->Array.count; i++) {
 				if (i >= elem_count) {
-					ir_fprintf(f, ", ");
+					ir_write_str_lit(f, ", ");
 				}
 				ir_print_type(f, m, elem_type);
-				ir_fprintf(f, " zeroinitializer");
+				ir_write_str_lit(f, " zeroinitializer");
 			}
 
-			ir_fprintf(f, "]");
+			ir_write_str_lit(f, "]");
 		} else if (is_type_vector(type)) {
 			ast_node(cl, CompoundLit, value.value_compound);
 			isize elem_count = cl->elems.count;
 			if (elem_count == 0) {
-				ir_fprintf(f, "zeroinitializer");
+				ir_write_str_lit(f, "zeroinitializer");
 				break;
 			}
 
-			i64 align = type_align_of(m->allocator, type);
+			i64 align = type_align_of(heap_allocator(), type);
 			i64 count = type->Vector.count;
 			Type *elem_type = type->Vector.elem;
 
-			ir_fprintf(f, "{[0 x <%lld x i8>] zeroinitializer, [%lld x ", align, count);
+			ir_write_str_lit(f, "{[0 x <");
+			ir_write_i64(f, align);
+			ir_write_str_lit(f, " x i8>] zeroinitializer, [");
+			ir_write_i64(f, count);
+			ir_write_str_lit(f, " x ");
 			ir_print_type(f, m, elem_type);
-			ir_fprintf(f, "][");
+			ir_write_str_lit(f, "][");
 
 			if (elem_count == 1 && type->Vector.count > 1) {
 				TypeAndValue *tav = type_and_value_of_expression(m->info, cl->elems.e[0]);
@@ -496,14 +618,14 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 
 				for (isize i = 0; i < type->Vector.count; i++) {
 					if (i > 0) {
-						ir_fprintf(f, ", ");
+						ir_write_str_lit(f, ", ");
 					}
 					ir_print_compound_element(f, m, tav->value, elem_type);
 				}
 			} else {
 				for (isize i = 0; i < elem_count; i++) {
 					if (i > 0) {
-						ir_fprintf(f, ", ");
+						ir_write_str_lit(f, ", ");
 					}
 					TypeAndValue *tav = type_and_value_of_expression(m->info, cl->elems.e[i]);
 					GB_ASSERT(tav != NULL);
@@ -511,20 +633,19 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 				}
 			}
 
-			ir_fprintf(f, "]}");
+			ir_write_str_lit(f, "]}");
 		} else if (is_type_struct(type)) {
-			gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&m->tmp_arena);
-
 			ast_node(cl, CompoundLit, value.value_compound);
 
 			if (cl->elems.count == 0) {
-				ir_fprintf(f, "zeroinitializer");
+				ir_write_str_lit(f, "zeroinitializer");
 				break;
 			}
 
+			gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&f->tmp_arena);
 
 			isize value_count = type->Record.field_count;
-			ExactValue *values = gb_alloc_array(m->tmp_allocator, ExactValue, value_count);
+			ExactValue *values = gb_alloc_array(f->tmp_allocator, ExactValue, value_count);
 
 
 			if (cl->elems.e[0]->kind == AstNode_FieldValue) {
@@ -536,8 +657,8 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 					TypeAndValue *tav = type_and_value_of_expression(m->info, fv->value);
 					GB_ASSERT(tav != NULL);
 
-					Selection sel = lookup_field(m->allocator, type, name, false);
-					Entity *f = type->Record.fields[sel.index.e[0]];
+					Selection sel = lookup_field(heap_allocator(), type, name, false);
+					Entity *f = type->Record.fields[selection_index(&sel, 0)];
 
 					values[f->Variable.field_index] = tav->value;
 				}
@@ -555,14 +676,14 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 
 
 			if (type->Record.is_packed) {
-				ir_fprintf(f, "<");
+				ir_write_str_lit(f, "<");
 			}
-			ir_fprintf(f, "{");
+			ir_write_str_lit(f, "{");
 
 
 			for (isize i = 0; i < value_count; i++) {
 				if (i > 0) {
-					ir_fprintf(f, ", ");
+					ir_write_str_lit(f, ", ");
 				}
 				Type *elem_type = type->Record.fields[i]->type;
 
@@ -570,20 +691,20 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 			}
 
 
-			ir_fprintf(f, "}");
+			ir_write_str_lit(f, "}");
 			if (type->Record.is_packed) {
-				ir_fprintf(f, ">");
+				ir_write_str_lit(f, ">");
 			}
 
 			gb_temp_arena_memory_end(tmp);
 		} else {
-			ir_fprintf(f, "zeroinitializer");
+			ir_write_str_lit(f, "zeroinitializer");
 		}
 
 	} break;
 
 	default:
-		ir_fprintf(f, "zeroinitializer");
+		ir_write_str_lit(f, "zeroinitializer");
 		// GB_PANIC("Invalid ExactValue: %d", value.kind);
 		break;
 	}
@@ -592,9 +713,10 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 void ir_print_block_name(irFileBuffer *f, irBlock *b) {
 	if (b != NULL) {
 		ir_print_escape_string(f, b->label, false);
-		ir_fprintf(f, "-%td", b->index);
+		ir_write_byte(f, '-');
+		ir_write_i64(f, b->index);
 	} else {
-		ir_fprintf(f, "<INVALID-BLOCK>");
+		ir_write_str_lit(f, "<INVALID-BLOCK>");
 	}
 }
 
@@ -615,7 +737,7 @@ bool ir_print_is_proc_global(irModule *m, irProcedure *proc) {
 
 void ir_print_value(irFileBuffer *f, irModule *m, irValue *value, Type *type_hint) {
 	if (value == NULL) {
-		ir_fprintf(f, "!!!NULL_VALUE");
+		ir_write_str_lit(f, "!!!NULL_VALUE");
 		return;
 	}
 	switch (value->kind) {
@@ -628,28 +750,30 @@ void ir_print_value(irFileBuffer *f, irModule *m, irValue *value, Type *type_hin
 	case irValue_ConstantSlice: {
 		irValueConstantSlice *cs = &value->ConstantSlice;
 		if (cs->backing_array == NULL || cs->count == 0) {
-			ir_fprintf(f, "zeroinitializer");
+			ir_write_str_lit(f, "zeroinitializer");
 		} else {
 			Type *at = base_type(type_deref(ir_type(cs->backing_array)));
 			Type *et = at->Array.elem;
-			ir_fprintf(f, "{");
+			ir_write_str_lit(f, "{");
 			ir_print_type(f, m, et);
-			ir_fprintf(f, "* getelementptr inbounds (");
+			ir_write_str_lit(f, "* getelementptr inbounds (");
 			ir_print_type(f, m, at);
-			ir_fprintf(f, ", ");
+			ir_write_str_lit(f, ", ");
 			ir_print_type(f, m, at);
-			ir_fprintf(f, "* ");
+			ir_write_str_lit(f, "* ");
 			ir_print_value(f, m, cs->backing_array, at);
-			ir_fprintf(f, ", ");
+			ir_write_str_lit(f, ", ");
 			ir_print_type(f, m, t_int);
-			ir_fprintf(f, " 0, i32 0), ");
+			ir_write_str_lit(f, " 0, i32 0), ");
 			ir_print_type(f, m, t_int);
-			ir_fprintf(f, " %lld}", cs->count);
+			ir_write_byte(f, ' ');
+			ir_write_i64(f, cs->count);
+			ir_write_byte(f, '}');
 		}
 	} break;
 
 	case irValue_Nil:
-		ir_fprintf(f, "zeroinitializer");
+		ir_write_str_lit(f, "zeroinitializer");
 		break;
 
 	case irValue_TypeName:
@@ -670,17 +794,17 @@ void ir_print_value(irFileBuffer *f, irModule *m, irValue *value, Type *type_hin
 		ir_print_encoded_global(f, value->Proc.name, ir_print_is_proc_global(m, &value->Proc));
 		break;
 	case irValue_Instr:
-		ir_fprintf(f, "%%%d", value->index);
+		ir_write_register(f, value->index);
 		break;
 	}
 }
 
 void ir_print_calling_convention(irFileBuffer *f, irModule *m, ProcCallingConvention cc) {
 	switch (cc) {
-	case ProcCC_Odin: ir_fprintf(f, "");       break;
-	case ProcCC_C:    ir_fprintf(f, "ccc ");   break;
-	case ProcCC_Std:  ir_fprintf(f, "cc 64 "); break;
-	case ProcCC_Fast: ir_fprintf(f, "cc 65 "); break;
+	case ProcCC_Odin: ir_write_str_lit(f, "");       break;
+	case ProcCC_C:    ir_write_str_lit(f, "ccc ");   break;
+	case ProcCC_Std:  ir_write_str_lit(f, "cc 64 "); break;
+	case ProcCC_Fast: ir_write_str_lit(f, "cc 65 "); break;
 	default: GB_PANIC("unknown calling convention: %d", cc);
 	}
 }
@@ -689,7 +813,7 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 	GB_ASSERT(value->kind == irValue_Instr);
 	irInstr *instr = &value->Instr;
 
-	ir_fprintf(f, "\t");
+	ir_write_str_lit(f, "\t");
 
 	switch (instr->kind) {
 	default: {
@@ -698,83 +822,95 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 	} break;
 
 	case irInstr_StartupRuntime: {
-		ir_fprintf(f, "call void ");
+		ir_write_str_lit(f, "call void ");
 		ir_print_encoded_global(f, str_lit(IR_STARTUP_RUNTIME_PROC_NAME), false);
-		ir_fprintf(f, "()\n");
+		ir_write_str_lit(f, "()\n");
 	} break;
 
 	case irInstr_Comment:
-		ir_fprintf(f, "; %.*s\n", LIT(instr->Comment.text));
+		ir_write_str_lit(f, "; ");
+		ir_write_string(f, instr->Comment.text);
+		ir_write_byte(f, '\n');
 		break;
 
 	case irInstr_Local: {
 		Type *type = instr->Local.entity->type;
-		ir_fprintf(f, "%%%d = alloca ", value->index);
+		ir_write_register(f, value->index);
+		ir_write_str_lit(f, " = alloca ");
 		ir_print_type(f, m, type);
-		ir_fprintf(f, ", align %lld\n", type_align_of(m->allocator, type));
+		ir_write_str_lit(f, ", align ");
+		ir_write_i64(f, type_align_of(heap_allocator(), type));
+		ir_write_byte(f, '\n');
 	} break;
 
 	case irInstr_ZeroInit: {
 		Type *type = type_deref(ir_type(instr->ZeroInit.address));
-		ir_fprintf(f, "store ");
+		ir_write_str_lit(f, "store ");
 		ir_print_type(f, m, type);
-		ir_fprintf(f, " zeroinitializer, ");
+		ir_write_str_lit(f, " zeroinitializer, ");
 		ir_print_type(f, m, type);
-		ir_fprintf(f, "* %%%d\n", instr->ZeroInit.address->index);
+		ir_write_str_lit(f, "* ");
+		ir_write_register(f, instr->ZeroInit.address->index);
+		ir_write_byte(f, '\n');
 	} break;
 
 	case irInstr_Store: {
 		Type *type = type_deref(ir_type(instr->Store.address));
-		ir_fprintf(f, "store ");
+		ir_write_str_lit(f, "store ");
 		ir_print_type(f, m, type);
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		ir_print_value(f, m, instr->Store.value, type);
-		ir_fprintf(f, ", ");
+		ir_write_str_lit(f, ", ");
 		ir_print_type(f, m, type);
-		ir_fprintf(f, "* ");
+		ir_write_str_lit(f, "* ");
 		ir_print_value(f, m, instr->Store.address, type);
-		ir_fprintf(f, "\n");
+		ir_write_str_lit(f, "\n");
 	} break;
 
 	case irInstr_Load: {
 		Type *type = instr->Load.type;
-		ir_fprintf(f, "%%%d = load ", value->index);
+		ir_write_register(f, value->index);
+		ir_write_str_lit(f, " = load ");
 		ir_print_type(f, m, type);
-		ir_fprintf(f, ", ");
+		ir_write_str_lit(f, ", ");
 		ir_print_type(f, m, type);
-		ir_fprintf(f, "* ");
+		ir_write_str_lit(f, "* ");
 		ir_print_value(f, m, instr->Load.address, type);
-		ir_fprintf(f, ", align %lld\n", type_align_of(m->allocator, type));
+		ir_write_str_lit(f, ", align ");
+		ir_write_i64(f, type_align_of(heap_allocator(), type));
+		ir_write_byte(f, '\n');
 	} break;
 
 	case irInstr_ArrayElementPtr: {
 		Type *et = ir_type(instr->ArrayElementPtr.address);
-		ir_fprintf(f, "%%%d = getelementptr inbounds ", value->index);
+		ir_write_register(f, value->index);
+		ir_write_str_lit(f, " = getelementptr inbounds ");
 
 		ir_print_type(f, m, type_deref(et));
-		ir_fprintf(f, ", ");
+		ir_write_str_lit(f, ", ");
 		ir_print_type(f, m, et);
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		ir_print_value(f, m, instr->ArrayElementPtr.address, et);
-		ir_fprintf(f, ", ");
+		ir_write_str_lit(f, ", ");
 		ir_print_type(f, m, t_int);
-		ir_fprintf(f, " 0, ");
+		ir_write_str_lit(f, " 0, ");
 		if (is_type_vector(type_deref(et))) {
 			ir_print_type(f, m, t_i32);
-			ir_fprintf(f, " 1, ");
+			ir_write_str_lit(f, " 1, ");
 		}
 
 		irValue *index =instr->ArrayElementPtr.elem_index;
 		Type *t = ir_type(index);
 		ir_print_type(f, m, t);
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		ir_print_value(f, m, index, t);
-		ir_fprintf(f, "\n");
+		ir_write_str_lit(f, "\n");
 	} break;
 
 	case irInstr_StructElementPtr: {
 		Type *et = ir_type(instr->StructElementPtr.address);
-		ir_fprintf(f, "%%%d = getelementptr inbounds ", value->index);
+		ir_write_register(f, value->index);
+		ir_write_str_lit(f, " = getelementptr inbounds ");
 		i32 index = instr->StructElementPtr.elem_index;
 		Type *st = base_type(type_deref(et));
 		if (is_type_struct(st)) {
@@ -784,44 +920,47 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 		}
 
 		ir_print_type(f, m, type_deref(et));
-		ir_fprintf(f, ", ");
+		ir_write_str_lit(f, ", ");
 		ir_print_type(f, m, et);
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		ir_print_value(f, m, instr->StructElementPtr.address, et);
-		ir_fprintf(f, ", ");
+		ir_write_str_lit(f, ", ");
 		ir_print_type(f, m, t_int);
-		ir_fprintf(f, " 0, ");
+		ir_write_str_lit(f, " 0, ");
 		ir_print_type(f, m, t_i32);
-		ir_fprintf(f, " %d", index);
-		ir_fprintf(f, "\n");
+		ir_write_byte(f, ' ');
+		ir_write_i64(f, index);
+		ir_write_byte(f, '\n');
 	} break;
 
 	case irInstr_PtrOffset: {
 		Type *pt = ir_type(instr->PtrOffset.address);
-		ir_fprintf(f, "%%%d = getelementptr inbounds ", value->index);
+		ir_write_register(f, value->index);
+		ir_write_str_lit(f, " = getelementptr inbounds ");
 		ir_print_type(f, m, type_deref(pt));
-		ir_fprintf(f, ", ");
+		ir_write_str_lit(f, ", ");
 		ir_print_type(f, m, pt);
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		ir_print_value(f, m, instr->PtrOffset.address, pt);
 
 		irValue *offset = instr->PtrOffset.offset;
 		Type *t = ir_type(offset);
-		ir_fprintf(f, ", ");
+		ir_write_str_lit(f, ", ");
 		ir_print_type(f, m, t);
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		ir_print_value(f, m, offset, t);
-		ir_fprintf(f, "\n");
+		ir_write_str_lit(f, "\n");
 	} break;
 
 	case irInstr_Phi: {
-		ir_fprintf(f, "%%%d = phi ", value->index);
+		ir_write_register(f, value->index);
+		ir_write_str_lit(f, " = phi ");
 		ir_print_type(f, m, instr->Phi.type);
-		ir_fprintf(f, " ", value->index);
+		ir_write_str_lit(f, " ");
 
 		for (isize i = 0; i < instr->Phi.edges.count; i++) {
 			if (i > 0) {
-				ir_fprintf(f, ", ");
+				ir_write_str_lit(f, ", ");
 			}
 
 			irValue *edge = instr->Phi.edges.e[i];
@@ -831,18 +970,19 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 				block = instr->parent->preds.e[i];
 			}
 
-			ir_fprintf(f, "[ ");
+			ir_write_str_lit(f, "[ ");
 			ir_print_value(f, m, edge, instr->Phi.type);
-			ir_fprintf(f, ", %%");
+			ir_write_str_lit(f, ", %");
 			ir_print_block_name(f, block);
-			ir_fprintf(f, " ]");
+			ir_write_str_lit(f, " ]");
 		}
-		ir_fprintf(f, "\n");
+		ir_write_str_lit(f, "\n");
 	} break;
 
 	case irInstr_StructExtractValue: {
 		Type *et = ir_type(instr->StructExtractValue.address);
-		ir_fprintf(f, "%%%d = extractvalue ", value->index);
+		ir_write_register(f, value->index);
+		ir_write_str_lit(f, " = extractvalue ");
 		i32 index = instr->StructExtractValue.index;
 		Type *st = base_type(et);
 		if (is_type_struct(st)) {
@@ -853,88 +993,95 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 
 
 		ir_print_type(f, m, et);
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		ir_print_value(f, m, instr->StructExtractValue.address, et);
-		ir_fprintf(f, ", %d\n", index);
+		ir_write_str_lit(f, ", ");
+		ir_write_i64(f, index);
+		ir_write_byte(f, '\n');
 	} break;
 
 	case irInstr_UnionTagPtr: {
 		Type *et = ir_type(instr->UnionTagPtr.address);
-		ir_fprintf(f, "%%%d = getelementptr inbounds ", value->index);
+		ir_write_register(f, value->index);
+		ir_write_str_lit(f, " = getelementptr inbounds ");
 
 		ir_print_type(f, m, type_deref(et));
-		ir_fprintf(f, ", ");
+		ir_write_str_lit(f, ", ");
 		ir_print_type(f, m, et);
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		ir_print_value(f, m, instr->UnionTagPtr.address, et);
-		ir_fprintf(f, ", ");
+		ir_write_str_lit(f, ", ");
 		ir_print_type(f, m, t_int);
-		ir_fprintf(f, " 0, ");
+		ir_write_str_lit(f, " 0, ");
 		ir_print_type(f, m, t_i32);
-		ir_fprintf(f, " %d", 2);
-		ir_fprintf(f, " ; UnionTagPtr");
-		ir_fprintf(f, "\n");
+		ir_write_str_lit(f, " 2");
+		ir_write_str_lit(f, " ; UnionTagPtr");
+		ir_write_str_lit(f, "\n");
 	} break;
 
 	case irInstr_UnionTagValue: {
 		Type *et = ir_type(instr->UnionTagValue.address);
-		ir_fprintf(f, "%%%d = extractvalue ", value->index);
+		ir_write_register(f, value->index);
+		ir_write_str_lit(f, " = extractvalue ");
 
 		ir_print_type(f, m, et);
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		ir_print_value(f, m, instr->UnionTagValue.address, et);
-		ir_fprintf(f, ", %d", 2);
-		ir_fprintf(f, " ; UnionTagValue");
-		ir_fprintf(f, "\n");
+		ir_write_str_lit(f, ", 2");
+		ir_write_str_lit(f, " ; UnionTagValue");
+		ir_write_str_lit(f, "\n");
 	} break;
 
 	case irInstr_Jump: {;
-		ir_fprintf(f, "br label %%");
+		ir_write_str_lit(f, "br label %");
 		ir_print_block_name(f, instr->Jump.block);
-		ir_fprintf(f, "\n");
+		ir_write_str_lit(f, "\n");
 	} break;
 
 	case irInstr_If: {;
-		ir_fprintf(f, "br ");
+		ir_write_str_lit(f, "br ");
 		ir_print_type(f, m, t_bool);
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		ir_print_value(f, m, instr->If.cond, t_bool);
-		ir_fprintf(f, ", ", instr->If.cond->index);
-		ir_fprintf(f, "label %%");   ir_print_block_name(f, instr->If.true_block);
-		ir_fprintf(f, ", label %%"); ir_print_block_name(f, instr->If.false_block);
-		ir_fprintf(f, "\n");
+		ir_write_str_lit(f, ", ");
+		ir_write_str_lit(f, "label %");   ir_print_block_name(f, instr->If.true_block);
+		ir_write_str_lit(f, ", label %"); ir_print_block_name(f, instr->If.false_block);
+		ir_write_str_lit(f, "\n");
 	} break;
 
 	case irInstr_Return: {
 		irInstrReturn *ret = &instr->Return;
-		ir_fprintf(f, "ret ");
+		ir_write_str_lit(f, "ret ");
 		if (ret->value == NULL) {
-			ir_fprintf(f, "void");
+			ir_write_str_lit(f, "void");
 		} else {
 			Type *t = ir_type(ret->value);
 			ir_print_type(f, m, t);
-			ir_fprintf(f, " ");
+			ir_write_str_lit(f, " ");
 			ir_print_value(f, m, ret->value, t);
 		}
 
-		ir_fprintf(f, "\n");
+		ir_write_str_lit(f, "\n");
 
 	} break;
 
 	case irInstr_Conv: {
 		irInstrConv *c = &instr->Conv;
-		ir_fprintf(f, "%%%d = %.*s ", value->index, LIT(ir_conv_strings[c->kind]));
+		ir_write_register(f, value->index);
+		ir_write_str_lit(f, " = ");
+		ir_write_string(f, ir_conv_strings[c->kind]);
+		ir_write_byte(f, ' ');
 		ir_print_type(f, m, c->from);
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		ir_print_value(f, m, c->value, c->from);
-		ir_fprintf(f, " to ");
+		ir_write_str_lit(f, " to ");
 		ir_print_type(f, m, c->to);
-		ir_fprintf(f, "\n");
+		ir_write_str_lit(f, "\n");
 
 	} break;
 
 	case irInstr_Unreachable: {
-		ir_fprintf(f, "unreachable\n");
+		ir_write_str_lit(f, "unreachable\n");
 	} break;
 
 	case irInstr_UnaryOp: {
@@ -945,45 +1092,46 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 			elem_type = base_type(elem_type->Vector.elem);
 		}
 
-		ir_fprintf(f, "%%%d = ", value->index);
+		ir_write_register(f, value->index);
+		ir_write_str_lit(f, " = ");
 		switch (uo->op) {
 		case Token_Sub:
 			if (is_type_float(elem_type)) {
-				ir_fprintf(f, "fsub");
+				ir_write_str_lit(f, "fsub");
 			} else {
-				ir_fprintf(f, "sub");
+				ir_write_str_lit(f, "sub");
 			}
 			break;
 		case Token_Xor:
 		case Token_Not:
 			GB_ASSERT(is_type_integer(type) || is_type_boolean(type));
-			ir_fprintf(f, "xor");
+			ir_write_str_lit(f, "xor");
 			break;
 		default:
 			GB_PANIC("Unknown unary operator");
 			break;
 		}
 
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		ir_print_type(f, m, type);
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		switch (uo->op) {
 		case Token_Sub:
 			if (is_type_float(elem_type)) {
 				ir_print_exact_value(f, m, exact_value_float(0), elem_type);
 			} else {
-				ir_fprintf(f, "0");
+				ir_write_str_lit(f, "0");
 			}
 			break;
 		case Token_Xor:
 		case Token_Not:
 			GB_ASSERT(is_type_integer(type) || is_type_boolean(type));
-			ir_fprintf(f, "-1");
+			ir_write_str_lit(f, "-1");
 			break;
 		}
-		ir_fprintf(f, ", ");
+		ir_write_str_lit(f, ", ");
 		ir_print_value(f, m, uo->expr, type);
-		ir_fprintf(f, "\n");
+		ir_write_str_lit(f, "\n");
 	} break;
 
 	case irInstr_BinaryOp: {
@@ -995,11 +1143,12 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 			elem_type = base_type(elem_type->Vector.elem);
 		}
 
-		ir_fprintf(f, "%%%d = ", value->index);
+		ir_write_register(f, value->index);
+		ir_write_str_lit(f, " = ");
 
 		if (gb_is_between(bo->op, Token__ComparisonBegin+1, Token__ComparisonEnd-1)) {
 			if (is_type_string(elem_type)) {
-				ir_fprintf(f, "call ");
+				ir_write_str_lit(f, "call ");
 				ir_print_calling_convention(f, m, ProcCC_Odin);
 				ir_print_type(f, m, t_bool);
 				char *runtime_proc = "";
@@ -1012,35 +1161,35 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 				case Token_GtEq:  runtime_proc = "__string_gt"; break;
 				}
 
-				ir_fprintf(f, " ");
+				ir_write_str_lit(f, " ");
 				ir_print_encoded_global(f, make_string_c(runtime_proc), false);
-				ir_fprintf(f, "(");
+				ir_write_str_lit(f, "(");
 				ir_print_type(f, m, type);
-				ir_fprintf(f, " ");
+				ir_write_str_lit(f, " ");
 				ir_print_value(f, m, bo->left, type);
-				ir_fprintf(f, ", ");
+				ir_write_str_lit(f, ", ");
 				ir_print_type(f, m, type);
-				ir_fprintf(f, " ");
+				ir_write_str_lit(f, " ");
 				ir_print_value(f, m, bo->right, type);
-				ir_fprintf(f, ")\n");
+				ir_write_str_lit(f, ")\n");
 				return;
 
 			} else if (is_type_float(elem_type)) {
-				ir_fprintf(f, "fcmp ");
+				ir_write_str_lit(f, "fcmp ");
 				switch (bo->op) {
-				case Token_CmpEq: ir_fprintf(f, "oeq"); break;
-				case Token_NotEq: ir_fprintf(f, "one"); break;
-				case Token_Lt:    ir_fprintf(f, "olt"); break;
-				case Token_Gt:    ir_fprintf(f, "ogt"); break;
-				case Token_LtEq:  ir_fprintf(f, "ole"); break;
-				case Token_GtEq:  ir_fprintf(f, "oge"); break;
+				case Token_CmpEq: ir_write_str_lit(f, "oeq"); break;
+				case Token_NotEq: ir_write_str_lit(f, "one"); break;
+				case Token_Lt:    ir_write_str_lit(f, "olt"); break;
+				case Token_Gt:    ir_write_str_lit(f, "ogt"); break;
+				case Token_LtEq:  ir_write_str_lit(f, "ole"); break;
+				case Token_GtEq:  ir_write_str_lit(f, "oge"); break;
 				}
 			} else if (is_type_complex(elem_type)) {
-				ir_fprintf(f, "call ");
+				ir_write_str_lit(f, "call ");
 				ir_print_calling_convention(f, m, ProcCC_Odin);
 				ir_print_type(f, m, t_bool);
 				char *runtime_proc = "";
-				i64 sz = 8*type_size_of(m->allocator, elem_type);
+				i64 sz = 8*type_size_of(heap_allocator(), elem_type);
 				switch (sz) {
 				case 64:
 					switch (bo->op) {
@@ -1056,24 +1205,24 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 					break;
 				}
 
-				ir_fprintf(f, " ");
+				ir_write_str_lit(f, " ");
 				ir_print_encoded_global(f, make_string_c(runtime_proc), false);
-				ir_fprintf(f, "(");
+				ir_write_str_lit(f, "(");
 				ir_print_type(f, m, type);
-				ir_fprintf(f, " ");
+				ir_write_str_lit(f, " ");
 				ir_print_value(f, m, bo->left, type);
-				ir_fprintf(f, ", ");
+				ir_write_str_lit(f, ", ");
 				ir_print_type(f, m, type);
-				ir_fprintf(f, " ");
+				ir_write_str_lit(f, " ");
 				ir_print_value(f, m, bo->right, type);
-				ir_fprintf(f, ")\n");
+				ir_write_str_lit(f, ")\n");
 				return;
 			} else if (is_type_quaternion(elem_type)) {
-				ir_fprintf(f, "call ");
+				ir_write_str_lit(f, "call ");
 				ir_print_calling_convention(f, m, ProcCC_Odin);
 				ir_print_type(f, m, t_bool);
 				char *runtime_proc = "";
-				i64 sz = 8*type_size_of(m->allocator, elem_type);
+				i64 sz = 8*type_size_of(heap_allocator(), elem_type);
 				switch (sz) {
 				case 128:
 					switch (bo->op) {
@@ -1089,80 +1238,80 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 					break;
 				}
 
-				ir_fprintf(f, " ");
+				ir_write_str_lit(f, " ");
 				ir_print_encoded_global(f, make_string_c(runtime_proc), false);
-				ir_fprintf(f, "(");
+				ir_write_str_lit(f, "(");
 				ir_print_type(f, m, type);
-				ir_fprintf(f, " ");
+				ir_write_str_lit(f, " ");
 				ir_print_value(f, m, bo->left, type);
-				ir_fprintf(f, ", ");
+				ir_write_str_lit(f, ", ");
 				ir_print_type(f, m, type);
-				ir_fprintf(f, " ");
+				ir_write_str_lit(f, " ");
 				ir_print_value(f, m, bo->right, type);
-				ir_fprintf(f, ")\n");
+				ir_write_str_lit(f, ")\n");
 				return;
 			} else {
-				ir_fprintf(f, "icmp ");
+				ir_write_str_lit(f, "icmp ");
 				if (bo->op != Token_CmpEq &&
 				    bo->op != Token_NotEq) {
 					if (is_type_unsigned(elem_type)) {
-						ir_fprintf(f, "u");
+						ir_write_str_lit(f, "u");
 					} else {
-						ir_fprintf(f, "s");
+						ir_write_str_lit(f, "s");
 					}
 				}
 				switch (bo->op) {
-				case Token_CmpEq: ir_fprintf(f, "eq"); break;
-				case Token_NotEq: ir_fprintf(f, "ne"); break;
-				case Token_Lt:    ir_fprintf(f, "lt"); break;
-				case Token_Gt:    ir_fprintf(f, "gt"); break;
-				case Token_LtEq:  ir_fprintf(f, "le"); break;
-				case Token_GtEq:  ir_fprintf(f, "ge"); break;
+				case Token_CmpEq: ir_write_str_lit(f, "eq"); break;
+				case Token_NotEq: ir_write_str_lit(f, "ne"); break;
+				case Token_Lt:    ir_write_str_lit(f, "lt"); break;
+				case Token_Gt:    ir_write_str_lit(f, "gt"); break;
+				case Token_LtEq:  ir_write_str_lit(f, "le"); break;
+				case Token_GtEq:  ir_write_str_lit(f, "ge"); break;
 				default: GB_PANIC("invalid comparison");break;
 				}
 			}
 		} else {
 			if (is_type_float(elem_type)) {
-				ir_fprintf(f, "f");
+				ir_write_str_lit(f, "f");
 			}
 
 			switch (bo->op) {
-			case Token_Add:    ir_fprintf(f, "add");  break;
-			case Token_Sub:    ir_fprintf(f, "sub");  break;
-			case Token_And:    ir_fprintf(f, "and");  break;
-			case Token_Or:     ir_fprintf(f, "or");   break;
-			case Token_Xor:    ir_fprintf(f, "xor");  break;
-			case Token_Shl:    ir_fprintf(f, "shl");  break;
-			case Token_Shr:    ir_fprintf(f, "lshr"); break;
-			case Token_Mul:    ir_fprintf(f, "mul");  break;
-			case Token_Not:    ir_fprintf(f, "xor");  break;
+			case Token_Add:    ir_write_str_lit(f, "add");  break;
+			case Token_Sub:    ir_write_str_lit(f, "sub");  break;
+			case Token_And:    ir_write_str_lit(f, "and");  break;
+			case Token_Or:     ir_write_str_lit(f, "or");   break;
+			case Token_Xor:    ir_write_str_lit(f, "xor");  break;
+			case Token_Shl:    ir_write_str_lit(f, "shl");  break;
+			case Token_Shr:    ir_write_str_lit(f, "lshr"); break;
+			case Token_Mul:    ir_write_str_lit(f, "mul");  break;
+			case Token_Not:    ir_write_str_lit(f, "xor");  break;
 
 			case Token_AndNot: GB_PANIC("Token_AndNot Should never be called");
 
 			default: {
 				if (!is_type_float(elem_type)) {
 					if (is_type_unsigned(elem_type)) {
-						ir_fprintf(f, "u");
+						ir_write_str_lit(f, "u");
 					} else {
-						ir_fprintf(f, "s");
+						ir_write_str_lit(f, "s");
 					}
 				}
 
 				switch (bo->op) {
-				case Token_Quo: ir_fprintf(f, "div"); break;
-				case Token_Mod: ir_fprintf(f, "rem"); break;
+				case Token_Quo: ir_write_str_lit(f, "div"); break;
+				case Token_Mod: ir_write_str_lit(f, "rem"); break;
 				}
 			} break;
 			}
 		}
 
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		ir_print_type(f, m, type);
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		ir_print_value(f, m, bo->left, type);
-		ir_fprintf(f, ", ");
+		ir_write_str_lit(f, ", ");
 		ir_print_value(f, m, bo->right, type);
-		ir_fprintf(f, "\n");
+		ir_write_str_lit(f, "\n");
 	} break;
 
 	case irInstr_Call: {
@@ -1171,20 +1320,21 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 		GB_ASSERT(is_type_proc(proc_type));
 		Type *result_type = call->type;
 		if (result_type) {
-			ir_fprintf(f, "%%%d = ", value->index);
+			ir_write_register(f, value->index);
+			ir_write_str_lit(f, " = ");
 		}
-		ir_fprintf(f, "call ");
+		ir_write_str_lit(f, "call ");
 		ir_print_calling_convention(f, m, proc_type->Proc.calling_convention);
 		if (result_type) {
 			ir_print_type(f, m, result_type);
 		} else {
-			ir_fprintf(f, "void");
+			ir_write_str_lit(f, "void");
 		}
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		ir_print_value(f, m, call->value, call->type);
 
 
-		ir_fprintf(f, "(");
+		ir_write_str_lit(f, "(");
 		if (call->arg_count > 0) {
 			Type *proc_type = base_type(ir_type(call->value));
 			GB_ASSERT(proc_type->kind == Type_Proc);
@@ -1194,33 +1344,34 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 				GB_ASSERT(e != NULL);
 				Type *t = e->type;
 				if (i > 0) {
-					ir_fprintf(f, ", ");
+					ir_write_str_lit(f, ", ");
 				}
 				ir_print_type(f, m, t);
 				if (e->flags&EntityFlag_NoAlias) {
-					ir_fprintf(f, " noalias");
+					ir_write_str_lit(f, " noalias");
 				}
-				ir_fprintf(f, " ");
+				ir_write_str_lit(f, " ");
 				irValue *arg = call->args[i];
 				ir_print_value(f, m, arg, t);
 			}
 		}
-		ir_fprintf(f, ")\n");
+		ir_write_str_lit(f, ")\n");
 
 	} break;
 
 	case irInstr_Select: {
-		ir_fprintf(f, "%%%d = select i1 ", value->index);
+		ir_write_register(f, value->index);
+		ir_write_str_lit(f, " = select i1 ");
 		ir_print_value(f, m, instr->Select.cond, t_bool);
-		ir_fprintf(f, ", ");
+		ir_write_str_lit(f, ", ");
 		ir_print_type(f, m, ir_type(instr->Select.true_value));
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		ir_print_value(f, m, instr->Select.true_value, ir_type(instr->Select.true_value));
-		ir_fprintf(f, ", ");
+		ir_write_str_lit(f, ", ");
 		ir_print_type(f, m, ir_type(instr->Select.false_value));
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		ir_print_value(f, m, instr->Select.false_value, ir_type(instr->Select.false_value));
-		ir_fprintf(f, "\n");
+		ir_write_str_lit(f, "\n");
 	} break;
 
 	// case irInstr_VectorExtractElement: {
@@ -1288,74 +1439,74 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 
 	case irInstr_BoundsCheck: {
 		irInstrBoundsCheck *bc = &instr->BoundsCheck;
-		ir_fprintf(f, "call void ");
+		ir_write_str_lit(f, "call void ");
 		ir_print_encoded_global(f, str_lit("__bounds_check_error"), false);
-		ir_fprintf(f, "(");
-		ir_print_compound_element(f, m, exact_value_string(bc->pos.file), t_string);
-		ir_fprintf(f, ", ");
+		ir_write_str_lit(f, "(");
+		ir_print_compound_element(f, m, exact_value_string(token_pos_file(bc->pos)), t_string);
+		ir_write_str_lit(f, ", ");
 
 		ir_print_type(f, m, t_int);
-		ir_fprintf(f, " ");
-		ir_print_exact_value(f, m, exact_value_integer(bc->pos.line), t_int);
-		ir_fprintf(f, ", ");
+		ir_write_str_lit(f, " ");
+		ir_print_exact_value(f, m, exact_value_integer(token_pos_line(bc->pos)), t_int);
+		ir_write_str_lit(f, ", ");
 
 		ir_print_type(f, m, t_int);
-		ir_fprintf(f, " ");
-		ir_print_exact_value(f, m, exact_value_integer(bc->pos.column), t_int);
-		ir_fprintf(f, ", ");
+		ir_write_str_lit(f, " ");
+		ir_print_exact_value(f, m, exact_value_integer(token_pos_column(bc->pos)), t_int);
+		ir_write_str_lit(f, ", ");
 
 		ir_print_type(f, m, t_int);
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		ir_print_value(f, m, bc->index, t_int);
-		ir_fprintf(f, ", ");
+		ir_write_str_lit(f, ", ");
 
 		ir_print_type(f, m, t_int);
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		ir_print_value(f, m, bc->len, t_int);
 
-		ir_fprintf(f, ")\n");
+		ir_write_str_lit(f, ")\n");
 	} break;
 
 	case irInstr_SliceBoundsCheck: {
 		irInstrSliceBoundsCheck *bc = &instr->SliceBoundsCheck;
-		ir_fprintf(f, "call void ");
+		ir_write_str_lit(f, "call void ");
 		if (bc->is_substring) {
 			ir_print_encoded_global(f, str_lit("__substring_expr_error"), false);
 		} else {
 			ir_print_encoded_global(f, str_lit("__slice_expr_error"), false);
 		}
 
-		ir_fprintf(f, "(");
-		ir_print_compound_element(f, m, exact_value_string(bc->pos.file), t_string);
-		ir_fprintf(f, ", ");
+		ir_write_str_lit(f, "(");
+		ir_print_compound_element(f, m, exact_value_string(token_pos_file(bc->pos)), t_string);
+		ir_write_str_lit(f, ", ");
 
 		ir_print_type(f, m, t_int);
-		ir_fprintf(f, " ");
-		ir_print_exact_value(f, m, exact_value_integer(bc->pos.line), t_int);
-		ir_fprintf(f, ", ");
+		ir_write_str_lit(f, " ");
+		ir_print_exact_value(f, m, exact_value_integer(token_pos_line(bc->pos)), t_int);
+		ir_write_str_lit(f, ", ");
 
 		ir_print_type(f, m, t_int);
-		ir_fprintf(f, " ");
-		ir_print_exact_value(f, m, exact_value_integer(bc->pos.column), t_int);
-		ir_fprintf(f, ", ");
+		ir_write_str_lit(f, " ");
+		ir_print_exact_value(f, m, exact_value_integer(token_pos_column(bc->pos)), t_int);
+		ir_write_str_lit(f, ", ");
 
 		ir_print_type(f, m, t_int);
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		ir_print_value(f, m, bc->low, t_int);
-		ir_fprintf(f, ", ");
+		ir_write_str_lit(f, ", ");
 
 		ir_print_type(f, m, t_int);
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		ir_print_value(f, m, bc->high, t_int);
 
 		if (!bc->is_substring) {
-			ir_fprintf(f, ", ");
+			ir_write_str_lit(f, ", ");
 			ir_print_type(f, m, t_int);
-			ir_fprintf(f, " ");
+			ir_write_str_lit(f, " ");
 			ir_print_value(f, m, bc->max, t_int);
 		}
 
-		ir_fprintf(f, ")\n");
+		ir_write_str_lit(f, ")\n");
 	} break;
 
 	case irInstr_DebugDeclare: {
@@ -1373,10 +1524,10 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 		ir_print_value(f, m, dd->value, vt);
 		ir_fprintf(f, ", metadata !DILocalVariable(name: \"");
 		ir_print_escape_string(f, name, false);
-		ir_fprintf(f, "\", scope: !%d, line: %td)", di->id, pos.line);
+		ir_fprintf(f, "\", scope: !%d, line: %td)", di->id, token_pos_line(pos));
 		ir_fprintf(f, ", metadata !DIExpression()");
 		ir_fprintf(f, ")");
-		ir_fprintf(f, ", !dbg !DILocation(line: %td, column: %td, scope: !%d)", pos.line, pos.column, di->id);
+		ir_fprintf(f, ", !dbg !DILocation(line: %td, column: %td, scope: !%d)", token_pos_line(pos), token_pos_column(pos), di->id);
 
 		ir_fprintf(f, "\n"); */
 	} break;
@@ -1386,17 +1537,17 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 
 void ir_print_proc(irFileBuffer *f, irModule *m, irProcedure *proc) {
 	if (proc->body == NULL) {
-		ir_fprintf(f, "declare ");
+		ir_write_str_lit(f, "declare ");
 		// if (proc->tags & ProcTag_dll_import) {
 			// ir_fprintf(f, "dllimport ");
 		// }
 	} else {
-		ir_fprintf(f, "\n");
-		ir_fprintf(f, "define ");
+		ir_write_str_lit(f, "\n");
+		ir_write_str_lit(f, "define ");
 		if (build_context.is_dll) {
 			// if (proc->tags & (ProcTag_export|ProcTag_dll_export)) {
 			if (proc->tags & (ProcTag_export)) {
-				ir_fprintf(f, "dllexport ");
+				ir_write_str_lit(f, "dllexport ");
 			}
 		}
 	}
@@ -1406,44 +1557,46 @@ void ir_print_proc(irFileBuffer *f, irModule *m, irProcedure *proc) {
 	ir_print_calling_convention(f, m, proc_type->calling_convention);
 
 	if (proc_type->result_count == 0) {
-		ir_fprintf(f, "void");
+		ir_write_str_lit(f, "void");
 	} else {
 		ir_print_type(f, m, proc_type->results);
 	}
 
-	ir_fprintf(f, " ");
+	ir_write_str_lit(f, " ");
 	ir_print_encoded_global(f, proc->name, ir_print_is_proc_global(m, proc));
-	ir_fprintf(f, "(");
+	ir_write_str_lit(f, "(");
 
 	if (proc_type->param_count > 0) {
 		TypeTuple *params = &proc_type->params->Tuple;
 		for (isize i = 0; i < params->variable_count; i++) {
 			Entity *e = params->variables[i];
 			if (i > 0) {
-				ir_fprintf(f, ", ");
+				ir_write_str_lit(f, ", ");
 			}
 			ir_print_type(f, m, e->type);
 			if (e->flags&EntityFlag_NoAlias) {
-				ir_fprintf(f, " noalias");
+				ir_write_str_lit(f, " noalias");
 			}
 			if (proc->body != NULL) {
 				if (!str_eq(e->token.string, str_lit("")) &&
 				    !str_eq(e->token.string, str_lit("_"))) {
-					ir_fprintf(f, " %%%.*s", LIT(e->token.string));
+					ir_write_str_lit(f, " %");
+					ir_write_string(f, e->token.string);
 				} else {
-					ir_fprintf(f, " %%_.param_%td", i);
+					ir_write_str_lit(f, " %_.param_");
+					ir_write_i64(f, i);
 				}
 			}
 		}
 	}
 
-	ir_fprintf(f, ") ");
+	ir_write_str_lit(f, ") ");
 
 	if (proc->tags & ProcTag_inline) {
-		ir_fprintf(f, "alwaysinline ");
+		ir_write_str_lit(f, "alwaysinline ");
 	}
 	if (proc->tags & ProcTag_no_inline) {
-		ir_fprintf(f, "noinline ");
+		ir_write_str_lit(f, "noinline ");
 	}
 
 
@@ -1462,22 +1615,22 @@ void ir_print_proc(irFileBuffer *f, irModule *m, irProcedure *proc) {
 	if (proc->body != NULL) {
 		// ir_fprintf(f, "nounwind uwtable {\n");
 
-		ir_fprintf(f, "{\n");
+		ir_write_str_lit(f, "{\n");
 		for_array(i, proc->blocks) {
 			irBlock *block = proc->blocks.e[i];
 
-			if (i > 0) ir_fprintf(f, "\n");
+			if (i > 0) ir_write_str_lit(f, "\n");
 			ir_print_block_name(f, block);
-			ir_fprintf(f, ":\n");
+			ir_write_str_lit(f, ":\n");
 
 			for_array(j, block->instrs) {
 				irValue *value = block->instrs.e[j];
 				ir_print_instr(f, m, value);
 			}
 		}
-		ir_fprintf(f, "}\n");
+		ir_write_str_lit(f, "}\n");
 	} else {
-		ir_fprintf(f, "\n");
+		ir_write_str_lit(f, "\n");
 	}
 
 	for_array(i, proc->children) {
@@ -1492,41 +1645,247 @@ void ir_print_type_name(irFileBuffer *f, irModule *m, irValue *v) {
 		return;
 	}
 	ir_print_encoded_local(f, v->TypeName.name);
-	ir_fprintf(f, " = type ");
+	ir_write_str_lit(f, " = type ");
 	ir_print_type(f, m, base_type(v->TypeName.type));
-	ir_fprintf(f, "\n");
+	ir_write_str_lit(f, "\n");
+}
+
+// NOTE: Layouts are cached on a type the first time they are asked for, which would be a race
+// between the printing threads, so every type reachable from a procedure is done before they start
+void ir_print_cache_type_layouts(Type *t, MapBool *seen) {
+	if (t == NULL || map_bool_get(seen, hash_pointer(t)) != NULL) {
+		return;
+	}
+	map_bool_set(seen, hash_pointer(t), true);
+	if (is_type_typed(t)) {
+		type_size_of(heap_allocator(), t);
+		type_align_of(heap_allocator(), t);
+	}
+
+	switch (t->kind) {
+	case Type_Named:        ir_print_cache_type_layouts(t->Named.base,        seen); break;
+	case Type_Pointer:      ir_print_cache_type_layouts(t->Pointer.elem,      seen); break;
+	case Type_Array:        ir_print_cache_type_layouts(t->Array.elem,        seen); break;
+	case Type_DynamicArray: ir_print_cache_type_layouts(t->DynamicArray.elem, seen); break;
+	case Type_Vector:       ir_print_cache_type_layouts(t->Vector.elem,       seen); break;
+	case Type_Slice:        ir_print_cache_type_layouts(t->Slice.elem,        seen); break;
+	case Type_Record:
+		for (isize i = 0; i < t->Record.field_count; i++) {
+			ir_print_cache_type_layouts(t->Record.fields[i]->type, seen);
+		}
+		for (isize i = 0; i < t->Record.variant_count; i++) {
+			ir_print_cache_type_layouts(t->Record.variants[i]->type, seen);
+		}
+		ir_print_cache_type_layouts(t->Record.enum_base_type, seen);
+		break;
+	case Type_Tuple:
+		for (isize i = 0; i < t->Tuple.variable_count; i++) {
+			ir_print_cache_type_layouts(t->Tuple.variables[i]->type, seen);
+		}
+		type_set_offsets(heap_allocator(), t);
+		break;
+	case Type_Proc:
+		ir_print_cache_type_layouts(t->Proc.params,  seen);
+		ir_print_cache_type_layouts(t->Proc.results, seen);
+		break;
+	case Type_Map:
+		ir_print_cache_type_layouts(t->Map.key,                   seen);
+		ir_print_cache_type_layouts(t->Map.value,                 seen);
+		ir_print_cache_type_layouts(t->Map.entry_type,            seen);
+		ir_print_cache_type_layouts(t->Map.generated_struct_type, seen);
+		ir_print_cache_type_layouts(t->Map.lookup_result_type,    seen);
+		break;
+	default: break;
+	}
+}
+
+void ir_print_cache_proc_layouts(irProcedure *proc, MapBool *seen, irValueRefArray *ops) {
+	ir_print_cache_type_layouts(proc->type, seen);
+	for_array(i, proc->blocks) {
+		irBlock *b = proc->blocks.e[i];
+		for_array(j, b->instrs) {
+			irValue *value = b->instrs.e[j];
+			irInstr *instr = &value->Instr;
+			if (instr->kind == irInstr_Local) {
+				ir_print_cache_type_layouts(instr->Local.entity->type, seen);
+			}
+			ir_print_cache_type_layouts(ir_type(value), seen);
+
+			array_clear(ops);
+			ir_opt_add_operand_refs(ops, instr);
+			for_array(k, *ops) {
+				irValue *op = *ops->e[k];
+				if (op != NULL) {
+					ir_print_cache_type_layouts(ir_type(op), seen);
+				}
+			}
+		}
+	}
+	for_array(i, proc->children) {
+		ir_print_cache_proc_layouts(proc->children.e[i], seen, ops);
+	}
+}
+
+// NOTE: Printing a procedure only reads the module, so procedures are printed on
+// `build_context.thread_count` threads, each into its own growing buffer. Where each one ended up
+// is recorded so that they are written out in the same order as printing them one by one would.
+typedef struct irPrintProcQueue {
+	irModule *      module;
+	irProcedure **  procs;
+	isize           proc_count;
+	gbAtomic32      next_index;
+	irFileBuffer ** buffers; // Index: procs
+	isize *         offsets; // Index: procs
+	isize *         lengths; // Index: procs
+	irValueArray *  global_strings; // Index: procs
+} irPrintProcQueue;
+
+typedef struct irPrintProcWorker {
+	irPrintProcQueue *queue;
+	irFileBuffer      buf;
+} irPrintProcWorker;
+
+GB_THREAD_PROC(ir_print_proc_worker_proc) {
+	irPrintProcWorker *w = cast(irPrintProcWorker *)data;
+	irPrintProcQueue *q = w->queue;
+	for (;;) {
+		isize index = gb_atomic32_fetch_add(&q->next_index, 1);
+		if (index >= q->proc_count) {
+			break;
+		}
+		isize offset = w->buf.offset;
+		array_init(&q->global_strings[index], heap_allocator());
+		w->buf.global_strings = &q->global_strings[index];
+		w->buf.global_string_proc_index = index;
+		ir_print_proc(&w->buf, q->module, q->procs[index]);
+		w->buf.global_strings = NULL;
+		// NOTE: Store the offset as the buffer may move whilst it grows
+		q->buffers[index] = &w->buf;
+		q->offsets[index] = offset;
+		q->lengths[index] = w->buf.offset - offset;
+	}
+}
+
+void ir_print_procs_parallel(irFileBuffer *f, irModule *m) {
+	gbAllocator a = heap_allocator();
+	irPrintProcQueue q = {0};
+	q.module = m;
+	q.procs = gb_alloc_array(a, irProcedure *, m->members.entries.count);
+
+	// NOTE: Foreign procedures first, then those with a body
+	for (isize pass = 0; pass < 2; pass++) {
+		for_array(member_index, m->members.entries) {
+			MapIrValueEntry *entry = &m->members.entries.e[member_index];
+			irValue *v = entry->value;
+			if (v->kind != irValue_Proc) {
+				continue;
+			}
+			if ((v->Proc.body != NULL) == (pass == 1)) {
+				q.procs[q.proc_count++] = &v->Proc;
+			}
+		}
+	}
+
+	if (q.proc_count == 0) {
+		gb_free(a, q.procs);
+		return;
+	}
+
+	{
+		MapBool seen = {0}; // Key: Type *
+		irValueRefArray ops = {0};
+		map_bool_init(&seen, a);
+		array_init(&ops, a);
+		for (isize i = 0; i < q.proc_count; i++) {
+			ir_print_cache_proc_layouts(q.procs[i], &seen, &ops);
+		}
+		array_free(&ops);
+		map_bool_destroy(&seen);
+	}
+	type_layouts_are_frozen = true;
+
+	q.buffers = gb_alloc_array(a, irFileBuffer *, q.proc_count);
+	q.offsets = gb_alloc_array(a, isize, q.proc_count);
+	q.lengths = gb_alloc_array(a, isize, q.proc_count);
+	q.global_strings = gb_alloc_array(a, irValueArray, q.proc_count);
+	gb_atomic32_store(&q.next_index, 0);
+
+	// NOTE: The calling thread is a worker too
+	isize thread_count = gb_clamp(build_context.thread_count, 1, q.proc_count);
+	irPrintProcWorker *workers = gb_alloc_array(a, irPrintProcWorker, thread_count);
+	gbThread *threads = gb_alloc_array(a, gbThread, thread_count);
+	for (isize i = 0; i < thread_count; i++) {
+		workers[i].queue = &q;
+		ir_file_buffer_init(&workers[i].buf, NULL);
+	}
+
+	for (isize i = 1; i < thread_count; i++) {
+		gb_thread_init(&threads[i]);
+		gb_thread_start(&threads[i], ir_print_proc_worker_proc, &workers[i]);
+	}
+	ir_print_proc_worker_proc(&workers[0]);
+	for (isize i = 1; i < thread_count; i++) {
+		gb_thread_join(&threads[i]);
+		gb_thread_destory(&threads[i]);
+	}
+	type_layouts_are_frozen = false;
+
+	for (isize i = 0; i < q.proc_count; i++) {
+		u8 *data = cast(u8 *)q.buffers[i]->vm.data;
+		ir_file_buffer_write(f, data + q.offsets[i], q.lengths[i]);
+
+		irValueArray *strings = &q.global_strings[i];
+		for_array(j, *strings) {
+			irValue *g = strings->e[j];
+			ir_module_add_value(m, g->Global.entity, g);
+			map_ir_value_set(&m->members, hash_string(g->Global.entity->token.string), g);
+		}
+		array_free(strings);
+	}
+
+	for (isize i = 0; i < thread_count; i++) {
+		ir_file_buffer_destroy(&workers[i].buf);
+	}
+	gb_free(a, threads);
+	gb_free(a, workers);
+	gb_free(a, q.global_strings);
+	gb_free(a, q.lengths);
+	gb_free(a, q.offsets);
+	gb_free(a, q.buffers);
+	gb_free(a, q.procs);
 }
 
 void print_llvm_ir(irGen *ir) {
 	irModule *m = &ir->module;
 	irFileBuffer buf = {0}, *f = &buf;
+	u64 start = time_stamp_time_now();
 	ir_file_buffer_init(f, &ir->output_file);
 
 	ir_print_encoded_local(f, str_lit("..string"));
-	ir_fprintf(f, " = type {i8*, ");
+	ir_write_str_lit(f, " = type {i8*, ");
 	ir_print_type(f, m, t_int);
-	ir_fprintf(f, "} ; Basic_string\n");
+	ir_write_str_lit(f, "} ; Basic_string\n");
 	ir_print_encoded_local(f, str_lit("..rawptr"));
-	ir_fprintf(f, " = type i8* ; Basic_rawptr\n");
+	ir_write_str_lit(f, " = type i8* ; Basic_rawptr\n");
 
 	ir_print_encoded_local(f, str_lit("..complex64"));
-	ir_fprintf(f, " = type {float, float} ; Basic_complex64\n");
+	ir_write_str_lit(f, " = type {float, float} ; Basic_complex64\n");
 	ir_print_encoded_local(f, str_lit("..complex128"));
-	ir_fprintf(f, " = type {double, double} ; Basic_complex128\n");
+	ir_write_str_lit(f, " = type {double, double} ; Basic_complex128\n");
 	ir_print_encoded_local(f, str_lit("..quaternion128"));
-	ir_fprintf(f, " = type {float, float, float, float} ; Basic_quaternion128\n");
+	ir_write_str_lit(f, " = type {float, float, float, float} ; Basic_quaternion128\n");
 	ir_print_encoded_local(f, str_lit("..quaternion256"));
-	ir_fprintf(f, " = type {double, double, double, double} ; Basic_quaternion256\n");
+	ir_write_str_lit(f, " = type {double, double, double, double} ; Basic_quaternion256\n");
 
 
 	ir_print_encoded_local(f, str_lit("..any"));
-	ir_fprintf(f, " = type {");
+	ir_write_str_lit(f, " = type {");
 	ir_print_type(f, m, t_type_info_ptr);
-	ir_fprintf(f, ", ");
+	ir_write_str_lit(f, ", ");
 	ir_print_type(f, m, t_rawptr);
-	ir_fprintf(f, "} ; Basic_any\n");
+	ir_write_str_lit(f, "} ; Basic_any\n");
 
-	ir_fprintf(f, "declare void @llvm.dbg.declare(metadata, metadata, metadata) nounwind readnone \n");
+	ir_write_str_lit(f, "declare void @llvm.dbg.declare(metadata, metadata, metadata) nounwind readnone \n");
 
 
 	for_array(member_index, m->members.entries) {
@@ -1538,33 +1897,11 @@ void print_llvm_ir(irGen *ir) {
 		ir_print_type_name(f, m, v);
 	}
 
-	ir_fprintf(f, "\n");
+	ir_write_str_lit(f, "\n");
 
 	bool dll_main_found = false;
 
-	for_array(member_index, m->members.entries) {
-		MapIrValueEntry *entry = &m->members.entries.e[member_index];
-		irValue *v = entry->value;
-		if (v->kind != irValue_Proc) {
-			continue;
-		}
-
-		if (v->Proc.body == NULL) {
-			ir_print_proc(f, m, &v->Proc);
-		}
-	}
-
-	for_array(member_index, m->members.entries) {
-		MapIrValueEntry *entry = &m->members.entries.e[member_index];
-		irValue *v = entry->value;
-		if (v->kind != irValue_Proc) {
-			continue;
-		}
-
-		if (v->Proc.body != NULL) {
-			ir_print_proc(f, m, &v->Proc);
-		}
-	}
+	ir_print_procs_parallel(f, m);
 
 	for_array(member_index, m->members.entries) {
 		MapIrValueEntry *entry = &m->members.entries.e[member_index];
@@ -1579,37 +1916,37 @@ void print_llvm_ir(irGen *ir) {
 			in_global_scope = scope->is_global || scope->is_init;
 		}
 		ir_print_encoded_global(f, g->entity->token.string, in_global_scope);
-		ir_fprintf(f, " = ");
+		ir_write_str_lit(f, " = ");
 		if (g->is_foreign) {
-			ir_fprintf(f, "external ");
+			ir_write_str_lit(f, "external ");
 		}
 		if (g->is_thread_local) {
-			ir_fprintf(f, "thread_local ");
+			ir_write_str_lit(f, "thread_local ");
 		}
 
 		if (g->is_private) {
-			ir_fprintf(f, "private ");
+			ir_write_str_lit(f, "private ");
 		}
 		if (g->is_constant) {
 			if (g->is_unnamed_addr) {
-				ir_fprintf(f, "unnamed_addr ");
+				ir_write_str_lit(f, "unnamed_addr ");
 			}
-			ir_fprintf(f, "constant ");
+			ir_write_str_lit(f, "constant ");
 		} else {
-			ir_fprintf(f, "global ");
+			ir_write_str_lit(f, "global ");
 		}
 
 
 		ir_print_type(f, m, g->entity->type);
-		ir_fprintf(f, " ");
+		ir_write_str_lit(f, " ");
 		if (!g->is_foreign) {
 			if (g->value != NULL) {
 				ir_print_value(f, m, g->value, g->entity->type);
 			} else {
-				ir_fprintf(f, "zeroinitializer");
+				ir_write_str_lit(f, "zeroinitializer");
 			}
 		}
-		ir_fprintf(f, "\n");
+		ir_write_str_lit(f, "\n");
 	}
 
 
@@ -1667,7 +2004,7 @@ void print_llvm_ir(irGen *ir) {
 				            ")",
 				            LIT(di->Proc.name),
 				            di->Proc.file->id,
-				            di->Proc.pos.line);
+				            token_pos_line(di->Proc.pos));
 				break;
 
 			case irDebugInfo_AllProcs:
@@ -1686,4 +2023,7 @@ void print_llvm_ir(irGen *ir) {
 	}
 #endif
 	ir_file_buffer_destroy(f);
+
+	m->print_byte_count = f->written;
+	m->print_time = time_stamp_time_now() - start;
 }
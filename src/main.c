@@ -14,6 +14,7 @@ extern "C" {
 #include "ir.c"
 #include "ir_opt.c"
 #include "ir_print.c"
+#include "ir_bitcode.c"
 // #include "vm.c"
 
 #if defined(GB_SYSTEM_WINDOWS)
@@ -129,6 +130,123 @@ void usage(char *argv0) {
 	print_usage_line(1, "build_dll    compile .odin file as dll");
 	print_usage_line(1, "run          compile and run .odin file");
 	print_usage_line(1, "version      print version");
+	print_usage_line(0, "Flags (after the file):");
+	print_usage_line(1, "-show-timings  print the time spent in each stage of the compiler");
+	print_usage_line(1, "-show-memory   print the memory reserved and used by each stage of the compiler");
+	print_usage_line(1, "-parallel-check  type check procedure bodies on multiple threads");
+	print_usage_line(1, "-thread-count:N  use N threads for parsing and -parallel-check, 1 to do everything on one thread");
+	print_usage_line(1, "-emit-llvm-text  print the LLVM IR as text (.ll) rather than writing bitcode, for debugging");
+}
+
+// NOTE: Returns false if any of the flags are unknown
+bool parse_build_flags(char **flags, isize flag_count) {
+	bool ok = true;
+	for (isize i = 0; i < flag_count; i++) {
+		String flag = make_string_c(flags[i]);
+		if (str_eq(flag, str_lit("-show-timings"))) {
+			build_context.show_timings = true;
+		} else if (str_eq(flag, str_lit("-show-memory"))) {
+			build_context.show_memory = true;
+		} else if (str_eq(flag, str_lit("-parallel-check"))) {
+			build_context.parallel_check = true;
+		} else if (str_eq(flag, str_lit("-emit-llvm-text"))) {
+			build_context.emit_llvm_text = true;
+		} else if (str_has_prefix(flag, str_lit("-thread-count:"))) {
+			char *count_str = flags[i] + gb_size_of("-thread-count:")-1;
+			char *end = NULL;
+			i64 count = gb_str_to_i64(count_str, &end, 10);
+			if (end == count_str || *end != '\0' || count < 1) {
+				gb_printf_err("Invalid thread count in `%.*s`, expected a number greater than 0\n", LIT(flag));
+				ok = false;
+			} else {
+				build_context.thread_count = cast(isize)count;
+			}
+		} else {
+			gb_printf_err("Unknown flag: `%.*s`\n", LIT(flag));
+			ok = false;
+		}
+	}
+	return ok;
+}
+
+void show_timings(Parser *p, Checker *c, irModule *m, Timings *t) {
+	timings_print_all(t);
+
+	f64 tokenize_ms = 1000.0 * cast(f64)p->total_tokenize_time / cast(f64)t->freq;
+	f64 tokens_per_second = 0;
+	if (p->total_tokenize_time > 0) {
+		tokens_per_second = 1000.0 * cast(f64)p->total_token_count / tokenize_ms;
+	}
+	gb_printf("\n");
+	gb_printf("files     - %td\n", p->files.count);
+	gb_printf("lines     - %td\n", p->total_line_count);
+	gb_printf("tokens    - %td\n", p->total_token_count);
+	gb_printf("tokenizer - %.3f ms (%.0f tokens/s)\n", tokenize_ms, tokens_per_second);
+	// NOTE: Every selection path used to be a heap allocation, now only the long ones are
+	gb_printf("selection paths - %td (%td heap allocations)\n",
+	          selection_stats.path_count, selection_stats.heap_alloc_count);
+
+	OverloadCache *oc = &c->overload_cache;
+	isize overload_calls = oc->hits + oc->misses;
+	gb_printf("overload resolutions - %td (%td cached, %.1f%% hit rate)\n",
+	          overload_calls, oc->hits,
+	          overload_calls > 0 ? 100.0 * cast(f64)oc->hits / cast(f64)overload_calls : 0.0);
+
+	// NOTE: Mostly the allocas, loads, and stores removed by `ir_opt_mem2reg`
+	gb_printf("ir instructions - %td before opt, %td after (%.1f%%)\n",
+	          m->instr_count_before_opt, m->instr_count_after_opt,
+	          m->instr_count_before_opt > 0 ? 100.0 * cast(f64)m->instr_count_after_opt / cast(f64)m->instr_count_before_opt : 0.0);
+
+	f64 print_ms = 1000.0 * cast(f64)m->print_time / cast(f64)t->freq;
+	gb_printf("%s - %lld bytes in %.3f ms (%.1f MB/s)\n",
+	          build_context.emit_llvm_text ? "ir print" : "ir bitcode write",
+	          cast(long long)m->print_byte_count, print_ms,
+	          print_ms > 0 ? cast(f64)m->print_byte_count / (1000.0 * print_ms) : 0.0);
+}
+
+void show_memory_line(String label, isize reserved, isize used) {
+	char const SPACES[] = "                ";
+	GB_ASSERT(label.len <= gb_size_of(SPACES)-1);
+	gb_printf("%.*s%.*s - %.3f MB reserved, %.3f MB used\n",
+	          LIT(label), cast(int)(gb_size_of(SPACES)-1-label.len), SPACES,
+	          cast(f64)reserved / cast(f64)gb_megabytes(1),
+	          cast(f64)used     / cast(f64)gb_megabytes(1));
+}
+
+void show_memory(Parser *p, Checker *c, irModule *m) {
+	isize source_size  = 0;
+	isize token_size   = 0;
+	isize ast_reserved = 0;
+	isize ast_used     = 0;
+	for_array(i, p->files) {
+		AstFile *f = &p->files.e[i];
+		source_size  += f->tokenizer.end - f->tokenizer.start;
+		token_size   += gb_size_of(f->token_buffer);
+		ast_reserved += f->arena.total_reserved;
+		ast_used     += f->arena.total_used;
+	}
+
+	show_memory_line(str_lit("source files"),   source_size, source_size);
+	show_memory_line(str_lit("tokens"),         token_size, token_size);
+	show_memory_line(str_lit("ast arenas"),     ast_reserved, ast_used);
+	show_memory_line(str_lit("checker arena"),  c->arena.total_size, c->arena.total_allocated);
+	show_memory_line(str_lit("checker temp"),   c->tmp_arena.total_size, c->tmp_arena.total_allocated);
+	show_memory_line(str_lit("node infos"),     c->info.nodes->page_count*AST_NODE_INFO_PAGE_SIZE*gb_size_of(AstNodeInfo),
+	                                            ast_node_id_count()*gb_size_of(AstNodeInfo));
+	if (c->worker_arenas.count > 0) {
+		isize worker_reserved = 0;
+		isize worker_used     = 0;
+		for_array(i, c->worker_arenas) {
+			worker_reserved += c->worker_arenas.e[i].total_reserved;
+			worker_used     += c->worker_arenas.e[i].total_used;
+		}
+		show_memory_line(str_lit("checker workers"), worker_reserved, worker_used);
+	}
+	show_memory_line(str_lit("interned strings"), string_interner.total_reserved, string_interner.total_used);
+	show_memory_line(str_lit("interned types"), type_intern_table.arena.total_reserved, type_intern_table.arena.total_used);
+	show_memory_line(str_lit("ir arena"),       m->arena.total_size, m->arena.total_allocated);
+	show_memory_line(str_lit("ir temp"),        m->tmp_arena.total_size, m->tmp_arena.total_allocated);
+	show_memory_line(str_lit("string buffers"), string_buffer_arena.total_size, string_buffer_arena.total_allocated);
 }
 
 int main(int argc, char **argv) {
@@ -143,6 +261,10 @@ int main(int argc, char **argv) {
 	init_string_buffer_memory();
 	init_scratch_memory(gb_megabytes(10));
 	init_global_error_collector();
+	init_keyword_hash_table();
+	init_global_source_files();
+	init_string_interner();
+	init_type_intern_table();
 
 
 #if 1
@@ -155,21 +277,21 @@ int main(int argc, char **argv) {
 	bool run_output = false;
 	String arg1 = make_string_c(argv[1]);
 	if (str_eq(arg1, str_lit("run"))) {
-		if (argc != 3) {
+		if (argc < 3 || !parse_build_flags(argv+3, argc-3)) {
 			usage(argv[0]);
 			return 1;
 		}
 		init_filename = argv[2];
 		run_output = true;
 	} else if (str_eq(arg1, str_lit("build_dll"))) {
-		if (argc != 3) {
+		if (argc < 3 || !parse_build_flags(argv+3, argc-3)) {
 			usage(argv[0]);
 			return 1;
 		}
 		init_filename = argv[2];
 		build_context.is_dll = true;
 	} else if (str_eq(arg1, str_lit("build"))) {
-		if (argc != 3) {
+		if (argc < 3 || !parse_build_flags(argv+3, argc-3)) {
 			usage(argv[0]);
 			return 1;
 		}
@@ -234,8 +356,17 @@ int main(int argc, char **argv) {
 	timings_start_section(&timings, str_lit("llvm ir opt tree"));
 	ir_opt_tree(&ir_gen);
 
-	timings_start_section(&timings, str_lit("llvm ir print"));
-	print_llvm_ir(&ir_gen);
+	if (build_context.emit_llvm_text) {
+		timings_start_section(&timings, str_lit("llvm ir print"));
+		print_llvm_ir(&ir_gen);
+	} else {
+		timings_start_section(&timings, str_lit("llvm bitcode write"));
+		write_llvm_bitcode(&ir_gen);
+	}
+
+	if (build_context.show_memory) {
+		show_memory(&parser, &checker, &ir_gen.module);
+	}
 
 	// prof_print_all();
 
@@ -243,8 +374,7 @@ int main(int argc, char **argv) {
 	timings_start_section(&timings, str_lit("llvm-opt"));
 
 	char const *output_name = ir_gen.output_file.filename;
-	isize base_name_len = gb_path_extension(output_name)-1 - output_name;
-	String output = make_string(cast(u8 *)output_name, base_name_len);
+	String output = ir_gen.output_base;
 
 	i32 optimization_level = 0;
 	optimization_level = gb_clamp(optimization_level, 0, 3);
@@ -319,10 +449,12 @@ int main(int argc, char **argv) {
 		return exit_code;
 	}
 
-	// timings_print_all(&timings);
+	if (build_context.show_timings) {
+		show_timings(&parser, &checker, &ir_gen.module, &timings);
+	}
 
 	if (run_output) {
-		system_exec_command_line_app("odin run", false, "%.*s.exe", cast(int)base_name_len, output_name);
+		system_exec_command_line_app("odin run", false, "%.*s.exe", LIT(output));
 	}
 
 	#else
@@ -43,7 +43,13 @@ gb_inline HashKey hashing_proc(void const *data, isize len) {
 }
 
 gb_inline HashKey hash_string(String s) {
-	HashKey h = hashing_proc(s.text, s.len);
+	HashKey h = {HashKey_Default};
+	InternedString *is = interned_string_of(s);
+	if (is != NULL) {
+		h.key = is->hash;
+	} else {
+		h = hashing_proc(s.text, s.len);
+	}
 	h.kind = HashKey_String;
 	h.string = s;
 	return h;
@@ -0,0 +1,179 @@
+// NOTE: A micro-benchmark of `Map` ("map.c") against `OpenMap` ("open_map.c") with workloads
+// shaped like the checker's use of them:
+//   - Pointer keys (AstNode *, Entity *) which are set once and then looked up many times
+//   - Identifier keys (scope lookups) where a lot of the lookups miss and go to the parent scope
+//   - Small per scope maps which are made and destroyed constantly
+//
+// It is not part of the compiler and is built on its own, e.g.
+//   cl -nologo -O2 -TC "src\map_bench.c" -link -OUT:map_bench.exe
+
+#include "common.c"
+
+#define MAP_TYPE isize
+#define MAP_PROC bench_chain_
+#define MAP_NAME BenchChain
+#include "map.c"
+
+#define MAP_TYPE isize
+#define MAP_PROC bench_open_
+#define MAP_NAME BenchOpen
+#include "open_map.c"
+
+typedef struct BenchRng {
+	u64 state;
+} BenchRng;
+
+u64 bench_rng_next(BenchRng *r) {
+	// NOTE: xorshift64* so that every run is given the same keys
+	u64 x = r->state;
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	r->state = x;
+	return x * 0x2545f4914f6cdd1dull;
+}
+
+typedef struct BenchKeys {
+	HashKey *pointers;
+	isize    pointer_count;
+	HashKey *idents;
+	isize    ident_count;
+	HashKey *missing; // NOTE: Identifiers which are never inserted
+	isize    missing_count;
+	u8 *     node_memory;
+} BenchKeys;
+
+void bench_keys_init(BenchKeys *k, gbAllocator a, isize pointer_count, isize ident_count) {
+	isize i;
+	BenchRng rng = {0x9e3779b97f4a7c15ull};
+	isize const node_size = 64; // NOTE: Roughly the size of a small AstNode
+
+	k->pointer_count = pointer_count;
+	k->pointers      = gb_alloc_array(a, HashKey, pointer_count);
+	k->node_memory   = gb_alloc_array(a, u8, node_size*pointer_count);
+	for (i = 0; i < pointer_count; i++) {
+		k->pointers[i] = hash_pointer(k->node_memory + i*node_size);
+	}
+	// NOTE: Shuffle them so that the lookups are not in allocation order
+	for (i = pointer_count-1; i > 0; i--) {
+		isize j = cast(isize)(bench_rng_next(&rng) % cast(u64)(i+1));
+		HashKey tmp = k->pointers[i];
+		k->pointers[i] = k->pointers[j];
+		k->pointers[j] = tmp;
+	}
+
+	k->ident_count   = ident_count;
+	k->missing_count = ident_count;
+	k->idents  = gb_alloc_array(a, HashKey, ident_count);
+	k->missing = gb_alloc_array(a, HashKey, ident_count);
+	for (i = 0; i < ident_count; i++) {
+		char buf[32] = {0};
+		isize len;
+		String s;
+
+		len = gb_snprintf(buf, gb_size_of(buf), "ident_%td", i) - 1;
+		s = make_string(gb_alloc_copy(a, buf, len), len);
+		k->idents[i] = hash_string(s);
+
+		len = gb_snprintf(buf, gb_size_of(buf), "outer_%td", i) - 1;
+		s = make_string(gb_alloc_copy(a, buf, len), len);
+		k->missing[i] = hash_string(s);
+	}
+}
+
+// NOTE: The same workloads for both kinds of map, `sink` stops them being optimized away
+#define BENCH_WORKLOADS(Name, prefix) \
+f64 GB_JOIN2(bench_pointers_, prefix)(BenchKeys *k, isize lookups_per_key, isize *sink) { \
+	isize i, j; \
+	Name m = {0}; \
+	f64 start = gb_time_now(); \
+	GB_JOIN2(prefix, init)(&m, heap_allocator()); \
+	for (i = 0; i < k->pointer_count; i++) { \
+		GB_JOIN2(prefix, set)(&m, k->pointers[i], i); \
+	} \
+	for (j = 0; j < lookups_per_key; j++) { \
+		for (i = k->pointer_count-1; i >= 0; i--) { \
+			isize *found = GB_JOIN2(prefix, get)(&m, k->pointers[i]); \
+			*sink += *found; \
+		} \
+	} \
+	GB_JOIN2(prefix, destroy)(&m); \
+	return gb_time_now() - start; \
+} \
+f64 GB_JOIN2(bench_idents_, prefix)(BenchKeys *k, isize lookups_per_key, isize *sink) { \
+	isize i, j; \
+	Name m = {0}; \
+	f64 start = gb_time_now(); \
+	GB_JOIN2(prefix, init)(&m, heap_allocator()); \
+	for (i = 0; i < k->ident_count; i++) { \
+		GB_JOIN2(prefix, set)(&m, k->idents[i], i); \
+	} \
+	for (j = 0; j < lookups_per_key; j++) { \
+		for (i = 0; i < k->ident_count; i++) { \
+			if (GB_JOIN2(prefix, get)(&m, k->idents[i]) != NULL) { \
+				*sink += 1; \
+			} \
+			if (GB_JOIN2(prefix, get)(&m, k->missing[i]) != NULL) { \
+				*sink += 1; \
+			} \
+		} \
+	} \
+	GB_JOIN2(prefix, destroy)(&m); \
+	return gb_time_now() - start; \
+} \
+f64 GB_JOIN2(bench_scopes_, prefix)(BenchKeys *k, isize scope_count, isize *sink) { \
+	isize i, j; \
+	f64 start = gb_time_now(); \
+	for (j = 0; j < scope_count; j++) { \
+		Name m = {0}; \
+		isize count = 1 + j%16; \
+		isize offset = (j*7) % (k->ident_count - 16); \
+		GB_JOIN2(prefix, init)(&m, heap_allocator()); \
+		for (i = 0; i < count; i++) { \
+			GB_JOIN2(prefix, set)(&m, k->idents[offset+i], i); \
+		} \
+		for (i = 0; i < 2*count; i++) { \
+			if (GB_JOIN2(prefix, get)(&m, k->idents[offset+i]) != NULL) { \
+				*sink += 1; \
+			} \
+		} \
+		GB_JOIN2(prefix, destroy)(&m); \
+	} \
+	return gb_time_now() - start; \
+}
+
+BENCH_WORKLOADS(BenchChain, bench_chain_)
+BENCH_WORKLOADS(BenchOpen,  bench_open_)
+
+#undef BENCH_WORKLOADS
+
+void bench_print(char *name, f64 chain, f64 open) {
+	gb_printf("%s: map.c %.3f ms, open_map.c %.3f ms (%.2fx)\n",
+	          name, chain*1000.0, open*1000.0, open > 0 ? chain/open : 0.0);
+}
+
+int main(int argc, char **argv) {
+	BenchKeys keys = {0};
+	isize sink = 0;
+	isize run;
+	isize const run_count = 5;
+	f64 chain[3] = {0};
+	f64 open[3]  = {0};
+
+	bench_keys_init(&keys, heap_allocator(), 1<<18, 1<<14);
+
+	for (run = 0; run < run_count; run++) {
+		chain[0] += bench_pointers_bench_chain_(&keys, 4, &sink);
+		open[0]  += bench_pointers_bench_open_ (&keys, 4, &sink);
+		chain[1] += bench_idents_bench_chain_  (&keys, 8, &sink);
+		open[1]  += bench_idents_bench_open_   (&keys, 8, &sink);
+		chain[2] += bench_scopes_bench_chain_  (&keys, 1<<16, &sink);
+		open[2]  += bench_scopes_bench_open_   (&keys, 1<<16, &sink);
+	}
+
+	gb_printf("Average of %td runs (sink %td)\n", run_count, sink);
+	bench_print("pointers", chain[0]/run_count, open[0]/run_count);
+	bench_print("idents",   chain[1]/run_count, open[1]/run_count);
+	bench_print("scopes",   chain[2]/run_count, open[2]/run_count);
+	return 0;
+}
@@ -0,0 +1,339 @@
+/*
+	Example of usage:
+
+	#define MAP_TYPE String
+	#define MAP_PROC map_string_
+	#define MAP_NAME MapString
+	#include "open_map.c"
+*/
+// An `OpenMap` is a drop in replacement for a `Map` (see "map.c") which uses open addressing.
+// The entries are still stored densely in `entries` so they can be iterated in exactly the
+// same way, but the table itself is a power of two array of slots which is probed linearly.
+// Each slot stores the low 32 bits of the mixed hash of its key so a probe only has to touch
+// an entry (and compare the `HashKey`) once the hashes match. Storing the full 64-bit hash
+// would make a slot 12 bytes (16 with padding), so only 32 bits are kept and the slots stay
+// at 8 bytes. More of the table stays in the cache that way, which is what most lookups that
+// miss are bound by.
+//
+// NOTE: The `multi_*` procedures find values in the order they were inserted, whereas
+// a `Map` finds the most recently inserted value first
+// NOTE: "map.c" must have been included before this as it defines `HashKey`
+
+#ifndef OPEN_MAP_UTIL_STUFF
+#define OPEN_MAP_UTIL_STUFF
+// NOTE: This util stuff is the same for every `OpenMap`
+typedef struct OpenMapSlot {
+	u32 hash;  // NOTE: The low 32 bits of the mixed hash, which is also where the home slot comes from
+	i32 index; // NOTE: Index into `entries`, -1 if the slot is empty
+} OpenMapSlot;
+
+u64 open_map_mix_hash(u64 x) {
+	// NOTE: Pointer keys are used directly as their hash and their low bits are zero
+	// because of alignment, so the bits need to be mixed before they can be masked
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdull;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ull;
+	x ^= x >> 33;
+	return x;
+}
+
+u32 open_map_slot_hash(HashKey key) {
+	// NOTE: String keys are already hashed with fnv64a so only the other kinds need mixing
+	if (key.kind == HashKey_String) {
+		return cast(u32)key.key;
+	}
+	return cast(u32)open_map_mix_hash(key.key);
+}
+
+isize open_map_home_slot(u32 hash, isize mask) {
+	return cast(isize)hash & mask;
+}
+#endif
+
+#define _J2_IND(a, b) a##b
+#define _J2(a, b) _J2_IND(a, b)
+
+/*
+MAP_TYPE - Entry type
+MAP_PROC - Function prefix (e.g. entity_map_)
+MAP_NAME - Name of Map (e.g. EntityMap)
+*/
+#define MAP_ENTRY _J2(MAP_NAME,Entry)
+
+typedef struct MAP_ENTRY {
+	HashKey  key;
+	MAP_TYPE value;
+} MAP_ENTRY;
+
+typedef struct MAP_NAME {
+	Array(OpenMapSlot) slots; // NOTE: `count` is always zero or a power of two
+	Array(MAP_ENTRY)   entries;
+} MAP_NAME;
+
+void      _J2(MAP_PROC,init)             (MAP_NAME *h, gbAllocator a);
+void      _J2(MAP_PROC,init_with_reserve)(MAP_NAME *h, gbAllocator a, isize capacity);
+void      _J2(MAP_PROC,destroy)          (MAP_NAME *h);
+MAP_TYPE *_J2(MAP_PROC,get)              (MAP_NAME *h, HashKey key);
+void      _J2(MAP_PROC,set)              (MAP_NAME *h, HashKey key, MAP_TYPE value);
+void      _J2(MAP_PROC,remove)           (MAP_NAME *h, HashKey key);
+void      _J2(MAP_PROC,clear)            (MAP_NAME *h);
+void      _J2(MAP_PROC,grow)             (MAP_NAME *h);
+void      _J2(MAP_PROC,rehash)           (MAP_NAME *h, isize new_count);
+
+// Mutlivalued map procedure
+MAP_ENTRY *_J2(MAP_PROC,multi_find_first)(MAP_NAME *h, HashKey key);
+MAP_ENTRY *_J2(MAP_PROC,multi_find_next) (MAP_NAME *h, MAP_ENTRY *e);
+
+isize _J2(MAP_PROC,multi_count)     (MAP_NAME *h, HashKey key);
+void  _J2(MAP_PROC,multi_get_all)   (MAP_NAME *h, HashKey key, MAP_TYPE *items);
+void  _J2(MAP_PROC,multi_insert)    (MAP_NAME *h, HashKey key, MAP_TYPE value);
+void  _J2(MAP_PROC,multi_remove)    (MAP_NAME *h, HashKey key, MAP_ENTRY *e);
+void  _J2(MAP_PROC,multi_remove_all)(MAP_NAME *h, HashKey key);
+
+
+
+void _J2(MAP_PROC,init)(MAP_NAME *h, gbAllocator a) {
+	array_init(&h->slots,   a);
+	array_init(&h->entries, a);
+}
+
+void _J2(MAP_PROC,init_with_reserve)(MAP_NAME *h, gbAllocator a, isize capacity) {
+	array_init(&h->slots, a);
+	array_init_reserve(&h->entries, a, capacity);
+	_J2(MAP_PROC,rehash)(h, capacity + capacity/2);
+}
+
+void _J2(MAP_PROC,destroy)(MAP_NAME *h) {
+	array_free(&h->entries);
+	array_free(&h->slots);
+}
+
+gb_internal void _J2(MAP_PROC,_insert_slot)(MAP_NAME *h, u32 hash, isize index) {
+	isize mask = h->slots.count-1;
+	isize i = open_map_home_slot(hash, mask);
+	while (h->slots.e[i].index >= 0) {
+		i = (i+1) & mask;
+	}
+	h->slots.e[i].hash  = hash;
+	h->slots.e[i].index = cast(i32)index;
+}
+
+gb_internal isize _J2(MAP_PROC,_find_slot)(MAP_NAME *h, HashKey key) {
+	if (h->slots.count > 0) {
+		isize mask = h->slots.count-1;
+		u32   hash = open_map_slot_hash(key);
+		isize i = open_map_home_slot(hash, mask);
+		for (;;) {
+			OpenMapSlot *s = &h->slots.e[i];
+			if (s->index < 0) {
+				break;
+			}
+			if (s->hash == hash && hash_key_equal(h->entries.e[s->index].key, key)) {
+				return i;
+			}
+			i = (i+1) & mask;
+		}
+	}
+	return -1;
+}
+
+gb_internal isize _J2(MAP_PROC,_find_slot_of_entry)(MAP_NAME *h, isize index) {
+	if (h->slots.count > 0) {
+		isize mask = h->slots.count-1;
+		isize i = open_map_home_slot(open_map_slot_hash(h->entries.e[index].key), mask);
+		for (;;) {
+			OpenMapSlot *s = &h->slots.e[i];
+			if (s->index < 0) {
+				break;
+			}
+			if (s->index == index) {
+				return i;
+			}
+			i = (i+1) & mask;
+		}
+	}
+	return -1;
+}
+
+gb_internal bool _J2(MAP_PROC,_needs_grow)(MAP_NAME *h) {
+	// NOTE: Keep the load factor at most 3/4 so there is always an empty slot to end a probe
+	return 0.75f * h->slots.count <= h->entries.count+1;
+}
+
+void _J2(MAP_PROC,grow)(MAP_NAME *h) {
+	isize new_count = ARRAY_GROW_FORMULA(h->entries.count);
+	_J2(MAP_PROC,rehash)(h, new_count);
+}
+
+void _J2(MAP_PROC,rehash)(MAP_NAME *h, isize new_count) {
+	isize i;
+	isize count = 8;
+	while (count < new_count || 0.75f * count <= h->entries.count+1) {
+		count <<= 1;
+	}
+	GB_ASSERT_MSG(count <= I32_MAX, "An OpenMap can only index 2^31 entries");
+	array_resize(&h->slots, count);
+	for (i = 0; i < count; i++) {
+		h->slots.e[i].hash  = 0;
+		h->slots.e[i].index = -1;
+	}
+	for (i = 0; i < h->entries.count; i++) {
+		_J2(MAP_PROC,_insert_slot)(h, open_map_slot_hash(h->entries.e[i].key), i);
+	}
+}
+
+gb_internal isize _J2(MAP_PROC,_add_entry)(MAP_NAME *h, HashKey key, MAP_TYPE value) {
+	MAP_ENTRY e = {0};
+	isize index;
+	if (_J2(MAP_PROC,_needs_grow)(h)) {
+		_J2(MAP_PROC,grow)(h);
+	}
+	e.key   = key;
+	e.value = value;
+	array_add(&h->entries, e);
+	index = h->entries.count-1;
+	_J2(MAP_PROC,_insert_slot)(h, open_map_slot_hash(key), index);
+	return index;
+}
+
+MAP_TYPE *_J2(MAP_PROC,get)(MAP_NAME *h, HashKey key) {
+	isize slot = _J2(MAP_PROC,_find_slot)(h, key);
+	if (slot >= 0) {
+		return &h->entries.e[h->slots.e[slot].index].value;
+	}
+	return NULL;
+}
+
+void _J2(MAP_PROC,set)(MAP_NAME *h, HashKey key, MAP_TYPE value) {
+	isize slot = _J2(MAP_PROC,_find_slot)(h, key);
+	if (slot >= 0) {
+		h->entries.e[h->slots.e[slot].index].value = value;
+		return;
+	}
+	_J2(MAP_PROC,_add_entry)(h, key, value);
+}
+
+
+
+void _J2(MAP_PROC,_erase)(MAP_NAME *h, isize slot) {
+	isize mask  = h->slots.count-1;
+	isize index = h->slots.e[slot].index;
+	isize last  = h->entries.count-1;
+	isize i = slot;
+	isize j = slot;
+
+	// NOTE: Backward shift deletion so that no tombstones are needed. Any slot further
+	// along the probe sequence whose home is not within (i, j] is moved back into the hole.
+	for (;;) {
+		isize home;
+		j = (j+1) & mask;
+		if (h->slots.e[j].index < 0) {
+			break;
+		}
+		home = open_map_home_slot(h->slots.e[j].hash, mask);
+		if (i <= j ? (i < home && home <= j) : (i < home || home <= j)) {
+			continue;
+		}
+		h->slots.e[i] = h->slots.e[j];
+		i = j;
+	}
+	h->slots.e[i].hash  = 0;
+	h->slots.e[i].index = -1;
+
+	// NOTE: Keep the entries dense by moving the last entry into the removed one
+	if (index != last) {
+		isize last_slot = _J2(MAP_PROC,_find_slot_of_entry)(h, last);
+		GB_ASSERT(last_slot >= 0);
+		h->slots.e[last_slot].index = cast(i32)index;
+		h->entries.e[index] = h->entries.e[last];
+	}
+	array_pop(&h->entries);
+}
+
+void _J2(MAP_PROC,remove)(MAP_NAME *h, HashKey key) {
+	isize slot = _J2(MAP_PROC,_find_slot)(h, key);
+	if (slot >= 0) {
+		_J2(MAP_PROC,_erase)(h, slot);
+	}
+}
+
+void _J2(MAP_PROC,clear)(MAP_NAME *h) {
+	array_clear(&h->slots);
+	array_clear(&h->entries);
+}
+
+
+#if 1
+MAP_ENTRY *_J2(MAP_PROC,multi_find_first)(MAP_NAME *h, HashKey key) {
+	isize slot = _J2(MAP_PROC,_find_slot)(h, key);
+	if (slot < 0) {
+		return NULL;
+	}
+	return &h->entries.e[h->slots.e[slot].index];
+}
+
+MAP_ENTRY *_J2(MAP_PROC,multi_find_next)(MAP_NAME *h, MAP_ENTRY *e) {
+	isize mask = h->slots.count-1;
+	u32   hash = open_map_slot_hash(e->key);
+	isize i = _J2(MAP_PROC,_find_slot_of_entry)(h, e - h->entries.e);
+	if (i < 0) {
+		return NULL;
+	}
+	for (;;) {
+		OpenMapSlot *s;
+		i = (i+1) & mask;
+		s = &h->slots.e[i];
+		if (s->index < 0) {
+			break;
+		}
+		if (s->hash == hash && hash_key_equal(h->entries.e[s->index].key, e->key)) {
+			return &h->entries.e[s->index];
+		}
+	}
+	return NULL;
+}
+
+isize _J2(MAP_PROC,multi_count)(MAP_NAME *h, HashKey key) {
+	isize count = 0;
+	MAP_ENTRY *e = _J2(MAP_PROC,multi_find_first)(h, key);
+	while (e != NULL) {
+		count++;
+		e = _J2(MAP_PROC,multi_find_next)(h, e);
+	}
+	return count;
+}
+
+void _J2(MAP_PROC,multi_get_all)(MAP_NAME *h, HashKey key, MAP_TYPE *items) {
+	isize i = 0;
+	MAP_ENTRY *e = _J2(MAP_PROC,multi_find_first)(h, key);
+	while (e != NULL) {
+		items[i++] = e->value;
+		e = _J2(MAP_PROC,multi_find_next)(h, e);
+	}
+}
+
+void _J2(MAP_PROC,multi_insert)(MAP_NAME *h, HashKey key, MAP_TYPE value) {
+	_J2(MAP_PROC,_add_entry)(h, key, value);
+}
+
+void _J2(MAP_PROC,multi_remove)(MAP_NAME *h, HashKey key, MAP_ENTRY *e) {
+	isize slot = _J2(MAP_PROC,_find_slot_of_entry)(h, e - h->entries.e);
+	if (slot >= 0) {
+		_J2(MAP_PROC,_erase)(h, slot);
+	}
+}
+
+void _J2(MAP_PROC,multi_remove_all)(MAP_NAME *h, HashKey key) {
+	while (_J2(MAP_PROC,get)(h, key) != NULL) {
+		_J2(MAP_PROC,remove)(h, key);
+	}
+}
+#endif
+
+
+#undef _J2
+#undef MAP_TYPE
+#undef MAP_PROC
+#undef MAP_NAME
+#undef MAP_ENTRY
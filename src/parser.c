@@ -17,15 +17,29 @@ typedef enum ParseFileError {
 
 typedef Array(AstNode *) AstNodeArray;
 
+// NOTE: The size of a file's AST is unknown up front as tokens are streamed, so the arena
+// starts small and each new block is sized from the tokens read so far
+#define AST_ARENA_MIN_BLOCK_SIZE gb_kilobytes(4)
+#define AST_ARENA_MAX_BLOCK_SIZE gb_megabytes(1)
+
 typedef struct AstFile {
 	i32            id;
-	gbArena        arena;
+	Arena          arena;
 	Tokenizer      tokenizer;
-	Array(Token)   tokens;
-	isize          curr_token_index;
 	Token          curr_token;
 	Token          prev_token; // previous non-comment
 
+	// NOTE: The parser pulls tokens from the tokenizer on demand through this ring
+	// buffer rather than tokenizing the whole file up front, so only the lookahead is kept
+	// in memory. Comments are dropped as they are read as the parser never looks at them.
+#define AST_FILE_TOKEN_BUFFER_COUNT 16
+	Token          token_buffer[AST_FILE_TOKEN_BUFFER_COUNT];
+	isize          token_read;    // Stream index of `curr_token`
+	isize          token_write;   // Stream index of the next token to be read from the tokenizer
+	isize          token_count;   // Total number of tokens produced, including comments
+	bool           token_eof;
+	bool           token_invalid; // NOTE: An invalid token was found and replaced with an EOF
+
 	// >= 0: In Expression
 	// <  0: In Control Clause
 	// NOTE(bill): Used to prevent type literals in control clauses
@@ -43,6 +57,8 @@ typedef struct AstFile {
 #define PARSER_MAX_FIX_COUNT 6
 	isize    fix_count;
 	TokenPos fix_prev_pos;
+
+	u64      tokenize_time; // NOTE: In `time_stamp__freq` units
 } AstFile;
 
 typedef struct ImportedFile {
@@ -51,13 +67,27 @@ typedef struct ImportedFile {
 	TokenPos pos; // #import
 } ImportedFile;
 
+// NOTE: The messages reported whilst parsing a file, printed once every file has been parsed
+typedef struct ImportedFileErrors {
+	String            path;
+	ParseFileError    error;
+	ErrorMessageArray messages;
+} ImportedFileErrors;
+
 typedef struct Parser {
 	String              init_fullpath;
 	Array(AstFile)      files;
 	Array(ImportedFile) imports;
-	gbAtomic32          import_index;
+	gbAtomic32          import_index; // NOTE: Next entry in `imports` to be claimed by a worker
+	isize               init_import_count;
+	isize               busy_worker_count;
+	isize               idle_worker_count; // NOTE: Workers waiting on `work` for more imports
+	gbSemaphore         work;
+	ParseFileError      error;
+	Array(ImportedFileErrors) file_errors;
 	isize               total_token_count;
 	isize               total_line_count;
+	u64                 total_tokenize_time; // NOTE: Summed over all files (and threads)
 	gbMutex             mutex;
 } Parser;
 
@@ -410,6 +440,7 @@ String const ast_node_strings[] = {
 
 typedef struct AstNode {
 	AstNodeKind kind;
+	i32 id; // NOTE: Dense index into the checker's `AstNodeInfo` table, 0 is never used
 	u32 stmt_state_flags;
 	union {
 #define AST_NODE_KIND(_kind_name_, name, ...) GB_JOIN2(AstNode, _kind_name_) _kind_name_;
@@ -419,6 +450,16 @@ typedef struct AstNode {
 } AstNode;
 
 
+// NOTE: A node is only allocated with room for its own kind's payload rather than the
+// whole union. A node must never be read as or changed into a different kind once made.
+gb_global isize const ast_node_sizes[AstNode_Count] = {
+	gb_offset_of(AstNode, BadExpr),
+#define AST_NODE_KIND(_kind_name_, name, ...) gb_offset_of(AstNode, _kind_name_) + gb_size_of(GB_JOIN2(AstNode, _kind_name_)),
+	AST_NODE_KINDS
+#undef AST_NODE_KIND
+};
+
+
 #define ast_node(n_, Kind_, node_) GB_JOIN2(AstNode, Kind_) *n_ = &(node_)->Kind_; GB_ASSERT((node_)->kind == GB_JOIN2(AstNode_, Kind_))
 #define case_ast_node(n_, Kind_, node_) case GB_JOIN2(AstNode_, Kind_): { ast_node(n_, Kind_, node_);
 #ifndef case_end
@@ -568,15 +609,53 @@ bool ast_node_expect(AstNode *node, AstNodeKind kind) {
 }
 
 
+#define AST_NODE_ID_BLOCK_SIZE 1024
+gb_global gbAtomic32 global_ast_node_id = {0}; // NOTE: The last id handed out
+// NOTE: Each thread claims ids from `global_ast_node_id` in blocks so that files being parsed
+// in parallel do not contend on every node. The block belongs to the thread and not to the
+// file, so no two threads can ever be handed the same id.
+gb_global gb_thread_local i32 thread_next_ast_node_id = 0;
+gb_global gb_thread_local i32 thread_last_ast_node_id = 0;
+
+i32 ast_node_id_count(void) {
+	return gb_atomic32_load(&global_ast_node_id)+1;
+}
+
 // NOTE(bill): And this below is why is I/we need a new language! Discriminated unions are a pain in C/C++
+// NOTE: Enough for the rest of the file if the tokens left come at the same rate per byte, and
+// use as much of the arena each, as the ones read so far
+isize ast_file_arena_block_size(AstFile *f) {
+	isize read = f->tokenizer.curr - f->tokenizer.start;
+	isize left = f->tokenizer.end  - f->tokenizer.curr;
+	if (read <= 0 || f->token_count <= 0) {
+		return AST_ARENA_MIN_BLOCK_SIZE;
+	}
+	isize tokens_left     = f->token_count * left / read;
+	isize bytes_per_token = f->arena.total_used / f->token_count;
+	return gb_clamp(tokens_left*bytes_per_token, AST_ARENA_MIN_BLOCK_SIZE, AST_ARENA_MAX_BLOCK_SIZE);
+}
+
 AstNode *make_ast_node(AstFile *f, AstNodeKind kind) {
-	gbArena *arena = &f->arena;
-	if (gb_arena_size_remaining(arena, GB_DEFAULT_MEMORY_ALIGNMENT) <= gb_size_of(AstNode)) {
-		// NOTE(bill): If a syntax error is so bad, just quit!
-		gb_exit(1);
+	ArenaBlock *b = f->arena.curr;
+	if (b == NULL || b->size - b->used < ast_node_sizes[kind] + gb_align_of(AstNode)) {
+		f->arena.block_size = ast_file_arena_block_size(f);
+	}
+	gbAllocator a = arena_allocator(&f->arena);
+	AstNode *node = cast(AstNode *)gb_alloc_align(a, ast_node_sizes[kind], gb_align_of(AstNode));
+	node->kind = kind;
+	if (thread_next_ast_node_id == thread_last_ast_node_id) {
+		thread_next_ast_node_id = gb_atomic32_fetch_add(&global_ast_node_id, AST_NODE_ID_BLOCK_SIZE)+1;
+		thread_last_ast_node_id = thread_next_ast_node_id + AST_NODE_ID_BLOCK_SIZE;
 	}
-	AstNode *node = gb_alloc_item(gb_arena_allocator(arena), AstNode);
+	node->id = thread_next_ast_node_id++;
+	return node;
+}
+
+// NOTE: For nodes which are made outside of the parser (e.g. by the checker)
+AstNode *alloc_ast_node(gbAllocator a, AstNodeKind kind) {
+	AstNode *node = cast(AstNode *)gb_alloc_align(a, ast_node_sizes[kind], gb_align_of(AstNode));
 	node->kind = kind;
+	node->id = gb_atomic32_fetch_add(&global_ast_node_id, 1)+1;
 	return node;
 }
 
@@ -1157,18 +1236,50 @@ AstNode *ast_label_decl(AstFile *f, Token token, AstNode *name) {
 }
 
 
-bool next_token(AstFile *f) {
-	Token prev = f->curr_token;
-	if (f->curr_token_index+1 < f->tokens.count) {
-		if (f->curr_token.kind != Token_Comment) {
-			f->prev_token = f->curr_token;
+void fill_token_buffer(AstFile *f) {
+	if (f->token_eof) {
+		return;
+	}
+	u64 start = time_stamp_time_now();
+	while (f->token_write - f->token_read < AST_FILE_TOKEN_BUFFER_COUNT) {
+		Token token = tokenizer_get_token(&f->tokenizer);
+		f->token_count++;
+		if (token.kind == Token_Comment) {
+			continue;
+		}
+		if (token.kind == Token_Invalid) {
+			// NOTE: The tokenizer has already reported it, just stop parsing here
+			f->token_invalid = true;
+			token.kind = Token_EOF;
+		}
+		f->token_buffer[f->token_write % AST_FILE_TOKEN_BUFFER_COUNT] = token;
+		f->token_write++;
+		if (token.kind == Token_EOF) {
+			f->token_eof = true;
+			break;
 		}
+	}
+	f->tokenize_time += time_stamp_time_now() - start;
+}
 
-		f->curr_token_index++;
-		f->curr_token = f->tokens.e[f->curr_token_index];
-		if (f->curr_token.kind == Token_Comment) {
-			return next_token(f);
+// NOTE: Returns the `amount`th token after `curr_token`, or the EOF token if past the end
+Token peek_token(AstFile *f, isize amount) {
+	GB_ASSERT(0 < amount && amount < AST_FILE_TOKEN_BUFFER_COUNT);
+	isize index = f->token_read + amount;
+	if (index >= f->token_write) {
+		fill_token_buffer(f);
+		if (index >= f->token_write) {
+			index = f->token_write-1;
 		}
+	}
+	return f->token_buffer[index % AST_FILE_TOKEN_BUFFER_COUNT];
+}
+
+bool next_token(AstFile *f) {
+	if (f->curr_token.kind != Token_EOF) {
+		f->prev_token = f->curr_token;
+		f->curr_token = peek_token(f, 1);
+		f->token_read++;
 		return true;
 	}
 	syntax_error(f->curr_token, "Token is EOF");
@@ -1177,17 +1288,7 @@ bool next_token(AstFile *f) {
 
 TokenKind look_ahead_token_kind(AstFile *f, isize amount) {
 	GB_ASSERT(amount > 0);
-
-	TokenKind kind = Token_Invalid;
-	isize index = f->curr_token_index;
-	while (amount > 0) {
-		index++;
-		kind = f->tokens.e[index].kind;
-		if (kind != Token_Comment) {
-			amount--;
-		}
-	}
-	return kind;
+	return peek_token(f, amount).kind;
 }
 
 Token expect_token(AstFile *f, TokenKind kind) {
@@ -1358,7 +1459,11 @@ void expect_semicolon(AstFile *f, AstNode *s) {
 	}
 
 	if (s != NULL) {
-		if (prev_token.pos.line != f->curr_token.pos.line) {
+		// NOTE: Look for a newline between the two tokens rather than comparing line
+		// numbers, which would need the file's line table
+		u8 *gap = f->tokenizer.start + prev_token.pos.offset;
+		isize gap_len = f->curr_token.pos.offset - prev_token.pos.offset;
+		if (gap_len > 0 && gb_memchr(gap, '\n', gap_len) != NULL) {
 			if (is_semicolon_optional_for_node(f, s)) {
 				return;
 			}
@@ -1648,7 +1753,7 @@ AstNode *convert_stmt_to_expr(AstFile *f, AstNode *statement, String kind) {
 	}
 
 	syntax_error(f->curr_token, "Expected `%.*s`, found a simple statement.", LIT(kind));
-	return ast_bad_expr(f, f->curr_token, f->tokens.e[f->curr_token_index+1]);
+	return ast_bad_expr(f, f->curr_token, peek_token(f, 1));
 }
 
 
@@ -1709,12 +1814,12 @@ AstNode *convert_stmt_to_expr(AstFile *f, AstNode *statement, String kind) {
 // 			break;
 // 		default:
 // 			syntax_error(f->curr_token, "Expected if expression block statement");
-// 			else_expr = ast_bad_expr(f, f->curr_token, f->tokens.e[f->curr_token_index+1]);
+// 			else_expr = ast_bad_expr(f, f->curr_token, peek_token(f, 1));
 // 			break;
 // 		}
 // 	} else {
 // 		syntax_error(f->curr_token, "An if expression must have an else clause");
-// 		return ast_bad_stmt(f, f->curr_token, f->tokens.e[f->curr_token_index+1]);
+// 		return ast_bad_stmt(f, f->curr_token, peek_token(f, 1));
 // 	}
 
 // 	return ast_if_expr(f, token, init, cond, body, else_expr);
@@ -1851,7 +1956,7 @@ AstNode *parse_operand(AstFile *f, bool lhs) {
 			// TODO(bill): Is this correct???
 			// NOTE(bill): Sanity check as identifiers should be handled already
 			TokenPos pos = ast_node_token(type).pos;
-			GB_ASSERT_MSG(type->kind != AstNode_Ident, "Type cannot be identifier %.*s(%td:%td)", LIT(pos.file), pos.line, pos.column);
+			GB_ASSERT_MSG(type->kind != AstNode_Ident, "Type cannot be identifier %.*s(%td:%td)", LIT(token_pos_file(pos)), token_pos_line(pos), token_pos_column(pos));
 			return type;
 		}
 		break;
@@ -1890,7 +1995,7 @@ AstNode *parse_call_expr(AstFile *f, AstNode *operand) {
 
 	while (f->curr_token.kind != Token_CloseParen &&
 	       f->curr_token.kind != Token_EOF &&
-	       ellipsis.pos.line == 0) {
+	       !token_pos_is_valid(ellipsis.pos)) {
 		if (f->curr_token.kind == Token_Comma) {
 			syntax_error(f->curr_token, "Expected an expression not a ,");
 		}
@@ -2920,7 +3025,7 @@ AstNode *parse_if_stmt(AstFile *f) {
 			break;
 		default:
 			syntax_error(f->curr_token, "Expected if statement block statement");
-			else_stmt = ast_bad_stmt(f, f->curr_token, f->tokens.e[f->curr_token_index+1]);
+			else_stmt = ast_bad_stmt(f, f->curr_token, peek_token(f, 1));
 			break;
 		}
 	}
@@ -2957,7 +3062,7 @@ AstNode *parse_when_stmt(AstFile *f) {
 			break;
 		default:
 			syntax_error(f->curr_token, "Expected when statement block statement");
-			else_stmt = ast_bad_stmt(f, f->curr_token, f->tokens.e[f->curr_token_index+1]);
+			else_stmt = ast_bad_stmt(f, f->curr_token, peek_token(f, 1));
 			break;
 		}
 	}
@@ -3593,29 +3698,12 @@ ParseFileError init_ast_file(AstFile *f, String fullpath) {
 	}
 	TokenizerInitError err = init_tokenizer(&f->tokenizer, fullpath);
 	if (err == TokenizerInit_None) {
-		array_init(&f->tokens, heap_allocator());
-		{
-			for (;;) {
-				Token token = tokenizer_get_token(&f->tokenizer);
-				if (token.kind == Token_Invalid) {
-					return ParseFile_InvalidToken;
-				}
-				array_add(&f->tokens, token);
+		fill_token_buffer(f);
+		f->token_read = 0;
+		f->prev_token = f->token_buffer[0];
+		f->curr_token = f->token_buffer[0];
 
-				if (token.kind == Token_EOF) {
-					break;
-				}
-			}
-		}
-
-		f->curr_token_index = 0;
-		f->prev_token = f->tokens.e[f->curr_token_index];
-		f->curr_token = f->tokens.e[f->curr_token_index];
-
-		// NOTE(bill): Is this big enough or too small?
-		isize arena_size = gb_size_of(AstNode);
-		arena_size *= 2*f->tokens.count;
-		gb_arena_init_from_allocator(&f->arena, heap_allocator(), arena_size);
+		arena_init(&f->arena, heap_allocator(), AST_ARENA_MIN_BLOCK_SIZE);
 
 		f->curr_proc = NULL;
 
@@ -3635,8 +3723,7 @@ ParseFileError init_ast_file(AstFile *f, String fullpath) {
 }
 
 void destroy_ast_file(AstFile *f) {
-	gb_arena_free(&f->arena);
-	array_free(&f->tokens);
+	arena_free(&f->arena);
 	gb_free(heap_allocator(), f->tokenizer.fullpath.text);
 	destroy_tokenizer(&f->tokenizer);
 }
@@ -3644,7 +3731,9 @@ void destroy_ast_file(AstFile *f) {
 bool init_parser(Parser *p) {
 	array_init(&p->files, heap_allocator());
 	array_init(&p->imports, heap_allocator());
+	array_init(&p->file_errors, heap_allocator());
 	gb_mutex_init(&p->mutex);
+	gb_semaphore_init(&p->work);
 	return true;
 }
 
@@ -3660,6 +3749,8 @@ void destroy_parser(Parser *p) {
 #endif
 	array_free(&p->files);
 	array_free(&p->imports);
+	array_free(&p->file_errors);
+	gb_semaphore_destroy(&p->work);
 	gb_mutex_destroy(&p->mutex);
 }
 
@@ -3673,6 +3764,7 @@ bool try_add_import_path(Parser *p, String path, String rel_path, TokenPos pos)
 	for_array(i, p->imports) {
 		String import = p->imports.e[i].path;
 		if (str_eq(import, path)) {
+			gb_mutex_unlock(&p->mutex);
 			return false;
 		}
 	}
@@ -3683,6 +3775,12 @@ bool try_add_import_path(Parser *p, String path, String rel_path, TokenPos pos)
 	item.pos = pos;
 	array_add(&p->imports, item);
 
+	if (p->idle_worker_count > 0) {
+		// NOTE: Wake a waiting worker to parse it
+		p->idle_worker_count--;
+		gb_semaphore_release(&p->work);
+	}
+
 	gb_mutex_unlock(&p->mutex);
 
 	return true;
@@ -3796,15 +3894,236 @@ void parse_file(Parser *p, AstFile *f) {
 		base_dir.len--;
 	}
 
-	while (f->curr_token.kind == Token_Comment) {
-		next_token(f);
+	f->decls = parse_stmt_list(f);
+	if (!f->token_invalid) {
+		// NOTE: The file will be reported as failing to parse, so do not go on to its imports
+		parse_setup_file_decls(p, f, base_dir, f->decls);
 	}
+}
 
-	f->decls = parse_stmt_list(f);
-	parse_setup_file_decls(p, f, base_dir, f->decls);
+
+
+ParseFileError parse_imported_file(Parser *p, ImportedFile imported_file) {
+	String import_path = imported_file.path;
+	String import_rel_path = imported_file.rel_path;
+	TokenPos pos = imported_file.pos;
+	AstFile file = {0};
+	ErrorMessageArray messages = {0};
+	array_init(&messages, heap_allocator());
+
+	error_buffer = &messages;
+	ParseFileError err = init_ast_file(&file, import_path);
+	if (err == ParseFile_None) {
+		parse_file(p, &file);
+		if (file.token_invalid) {
+			// NOTE: Tokens are streamed so this is only known once the parser reaches it
+			err = ParseFile_InvalidToken;
+		}
+	}
+	bool parsed = err == ParseFile_None;
+
+	if (err == ParseFile_EmptyFile) {
+		// NOTE: Nothing to parse, so nothing to add
+		err = ParseFile_None;
+	} else if (err != ParseFile_None) {
+		String reason = {0};
+		switch (err) {
+		case ParseFile_WrongExtension:
+			reason = str_lit("Invalid file extension: File must have the extension `.odin`");
+			break;
+		case ParseFile_InvalidFile:
+			reason = str_lit("Invalid file or cannot be found");
+			break;
+		case ParseFile_Permission:
+			reason = str_lit("File permissions problem");
+			break;
+		case ParseFile_NotFound:
+			reason = str_lit("File cannot be found");
+			break;
+		case ParseFile_InvalidToken:
+			reason = str_lit("Invalid token found in file");
+			break;
+		default:
+			break;
+		}
+		if (token_pos_is_valid(pos)) {
+			report_error_raw("%.*s(%td:%td) ", LIT(token_pos_file(pos)), token_pos_line(pos), token_pos_column(pos));
+		}
+		if (err == ParseFile_NotFound) {
+			report_error_raw("Failed to parse file: %.*s\n\t%.*s (`%.*s`)\n", LIT(import_rel_path), LIT(reason), LIT(import_path));
+		} else {
+			report_error_raw("Failed to parse file: %.*s\n\t%.*s\n", LIT(import_rel_path), LIT(reason));
+		}
+	}
+	error_buffer = NULL;
+
+	gb_mutex_lock(&p->mutex);
+	if (messages.count > 0 || err != ParseFile_None) {
+		ImportedFileErrors fe = {0};
+		fe.path     = import_path;
+		fe.error    = err;
+		fe.messages = messages;
+		array_add(&p->file_errors, fe);
+	} else {
+		array_free(&messages);
+	}
+	if (parsed) {
+		array_add(&p->files, file);
+	}
+	gb_mutex_unlock(&p->mutex);
+
+	return err;
+}
+
+// NOTE: Each worker claims the next unparsed entry in `imports` and any `#import`/`#load` found
+// whilst parsing it is pushed back onto the end of the same queue. A worker may only stop once the
+// queue is drained and no other worker is still parsing, as that worker may yet add more files.
+// A file which fails to parse does not stop the other workers, so which files get parsed does not
+// depend on the order in which they finish (see `parser_report_errors`).
+GB_THREAD_PROC(parse_worker_proc) {
+	Parser *p = cast(Parser *)data;
+	for (;;) {
+		ImportedFile imported_file = {0};
+		bool claimed = false;
+		bool done = false;
+
+		gb_mutex_lock(&p->mutex);
+		i32 index = gb_atomic32_load(&p->import_index);
+		if (index < p->imports.count) {
+			imported_file = p->imports.e[index];
+			gb_atomic32_store(&p->import_index, index+1);
+			p->busy_worker_count++;
+			claimed = true;
+		} else if (p->busy_worker_count == 0) {
+			done = true;
+		} else {
+			// NOTE: A busy worker may still add more imports, wait for it
+			p->idle_worker_count++;
+		}
+		gb_mutex_unlock(&p->mutex);
+
+		if (done) {
+			break;
+		}
+		if (!claimed) {
+			gb_semaphore_wait(&p->work);
+			continue;
+		}
+
+		parse_imported_file(p, imported_file);
+
+		gb_mutex_lock(&p->mutex);
+		p->busy_worker_count--;
+		// NOTE: Wake every waiting worker once there is nothing left for them to do
+		if (p->idle_worker_count > 0 &&
+		    p->busy_worker_count == 0 && gb_atomic32_load(&p->import_index) == p->imports.count) {
+			gb_semaphore_post(&p->work, cast(i32)p->idle_worker_count);
+			p->idle_worker_count = 0;
+		}
+		gb_mutex_unlock(&p->mutex);
+	}
+}
+
+// NOTE: Files are finished in whatever order the workers get to them. Rebuild `imports` and `files`
+// in the order a serial breadth first walk of the import declarations would find them so that the
+// file ids (and everything that depends upon them) are the same for every build
+void parser_order_files(Parser *p) {
+	MapIsize file_indices = {0}; // Key: String (fullpath)
+	MapBool  seen         = {0}; // Key: String (fullpath)
+	Array(ImportedFile) imports = {0};
+	Array(AstFile) files = {0};
+
+	map_isize_init(&file_indices, heap_allocator());
+	map_bool_init(&seen, heap_allocator());
+	array_init_reserve(&imports, heap_allocator(), p->imports.count);
+	array_init_reserve(&files, heap_allocator(), p->files.count);
+
+	for_array(i, p->files) {
+		map_isize_set(&file_indices, hash_string(p->files.e[i].tokenizer.fullpath), i);
+	}
+	for (isize i = 0; i < p->init_import_count; i++) {
+		ImportedFile imported_file = p->imports.e[i];
+		array_add(&imports, imported_file);
+		map_bool_set(&seen, hash_string(imported_file.path), true);
+	}
+
+	p->total_line_count = 0;
+	for_array(i, imports) {
+		isize *found = map_isize_get(&file_indices, hash_string(imports.e[i].path));
+		if (found == NULL) {
+			continue; // NOTE: Empty file, or one which failed to parse
+		}
+		AstFile *f = &p->files.e[*found];
+		f->id = files.count;
+		array_add(&files, *f);
+		p->total_line_count += f->tokenizer.line_count;
+
+		for_array(j, f->decls) {
+			AstNode *node = f->decls.e[j];
+			if (node->kind != AstNode_ImportDecl) {
+				continue;
+			}
+			ast_node(id, ImportDecl, node);
+			ImportedFile imported_file = {0};
+			imported_file.path     = string_trim_whitespace(id->fullpath);
+			imported_file.rel_path = string_trim_whitespace(id->relpath.string);
+			imported_file.pos      = ast_node_token(node).pos;
+			HashKey key = hash_string(imported_file.path);
+			if (map_bool_get(&seen, key) == NULL) {
+				map_bool_set(&seen, key, true);
+				array_add(&imports, imported_file);
+			}
+		}
+	}
+	GB_ASSERT(files.count == p->files.count);
+
+	array_clear(&p->imports);
+	array_clear(&p->files);
+	for_array(i, imports) {
+		array_add(&p->imports, imports.e[i]);
+	}
+	for_array(i, files) {
+		array_add(&p->files, files.e[i]);
+	}
+
+	array_free(&files);
+	array_free(&imports);
+
+	map_bool_destroy(&seen);
+	map_isize_destroy(&file_indices);
 }
 
+// NOTE: Prints the messages of each file in the order of `imports` (see `parser_order_files`) up to
+// and including the first file which failed to parse, which is where a serial parse would have
+// stopped. That failure is the one returned.
+ParseFileError parser_report_errors(Parser *p) {
+	ParseFileError err = ParseFile_None;
+	MapIsize error_indices = {0}; // Key: String (fullpath)
+	map_isize_init(&error_indices, heap_allocator());
+	for_array(i, p->file_errors) {
+		map_isize_set(&error_indices, hash_string(p->file_errors.e[i].path), i);
+	}
+
+	for_array(i, p->imports) {
+		isize *found = map_isize_get(&error_indices, hash_string(p->imports.e[i].path));
+		if (found == NULL) {
+			continue;
+		}
+		ImportedFileErrors *fe = &p->file_errors.e[*found];
+		print_error_messages(&fe->messages);
+		if (fe->error != ParseFile_None) {
+			err = fe->error;
+			break;
+		}
+	}
 
+	for_array(i, p->file_errors) {
+		destroy_error_messages(&p->file_errors.e[i].messages);
+	}
+	array_clear(&p->file_errors);
+	map_isize_destroy(&error_indices);
+	return err;
+}
 
 ParseFileError parse_files(Parser *p, char *init_filename) {
 	char *fullpath_str = gb_path_get_full_name(heap_allocator(), init_filename);
@@ -3826,62 +4145,43 @@ ParseFileError parse_files(Parser *p, char *init_filename) {
 
 	array_add(&p->imports, init_imported_file);
 	p->init_fullpath = init_fullpath;
+	p->init_import_count = p->imports.count;
 
-	for_array(i, p->imports) {
-		ImportedFile imported_file = p->imports.e[i];
-		String import_path = imported_file.path;
-		String import_rel_path = imported_file.rel_path;
-		TokenPos pos = imported_file.pos;
-		AstFile file = {0};
-
-		ParseFileError err = init_ast_file(&file, import_path);
-
-		if (err != ParseFile_None) {
-			if (err == ParseFile_EmptyFile) {
-				return ParseFile_None;
-			}
+	gb_atomic32_store(&p->import_index, 0);
+	p->busy_worker_count = 0;
+	p->idle_worker_count = 0;
+	p->error = ParseFile_None;
 
-			if (pos.line != 0) {
-				gb_printf_err("%.*s(%td:%td) ", LIT(pos.file), pos.line, pos.column);
-			}
-			gb_printf_err("Failed to parse file: %.*s\n\t", LIT(import_rel_path));
-			switch (err) {
-			case ParseFile_WrongExtension:
-				gb_printf_err("Invalid file extension: File must have the extension `.odin`");
-				break;
-			case ParseFile_InvalidFile:
-				gb_printf_err("Invalid file or cannot be found");
-				break;
-			case ParseFile_Permission:
-				gb_printf_err("File permissions problem");
-				break;
-			case ParseFile_NotFound:
-				gb_printf_err("File cannot be found (`%.*s`)", LIT(import_path));
-				break;
-			case ParseFile_InvalidToken:
-				gb_printf_err("Invalid token found in file");
-				break;
-			}
-			gb_printf_err("\n");
-			return err;
+	{
+		// NOTE: The calling thread is a worker too
+		isize thread_count = gb_max(build_context.thread_count, 1);
+		isize worker_count = thread_count-1;
+		gbThread *workers = gb_alloc_array(heap_allocator(), gbThread, gb_max(worker_count, 1));
+
+		for (isize i = 0; i < worker_count; i++) {
+			gb_thread_init(&workers[i]);
+			gb_thread_start(&workers[i], parse_worker_proc, p);
 		}
-		parse_file(p, &file);
-
-		{
-			gb_mutex_lock(&p->mutex);
-			file.id = p->files.count;
-			array_add(&p->files, file);
-			p->total_line_count += file.tokenizer.line_count;
-			gb_mutex_unlock(&p->mutex);
+		parse_worker_proc(p);
+		for (isize i = 0; i < worker_count; i++) {
+			gb_thread_join(&workers[i]);
+			gb_thread_destory(&workers[i]);
 		}
+
+		gb_free(heap_allocator(), workers);
+	}
+
+	parser_order_files(p);
+	p->error = parser_report_errors(p);
+	if (p->error != ParseFile_None) {
+		return p->error;
 	}
 
 	for_array(i, p->files) {
-		p->total_token_count += p->files.e[i].tokens.count;
+		p->total_token_count   += p->files.e[i].token_count;
+		p->total_tokenize_time += p->files.e[i].tokenize_time;
 	}
 
 
 	return ParseFile_None;
 }
-
-
@@ -132,7 +132,7 @@ struct ssaModule {
 	gbAllocator        tmp_allocator;
 	gbArena            tmp_arena;
 
-	MapEntity          min_dep_map; // Key: Entity *
+	EntitySet          min_dep_set;
 	MapSsaValue        values;      // Key: Entity *
 	// List of registers for the specific architecture
 	Array(ssaRegister) registers;
@@ -478,9 +478,8 @@ ssaAddr ssa_add_local(ssaProc *p, Entity *e, AstNode *expr) {
 	return ssa_addr(addr);
 }
 ssaAddr ssa_add_local_for_ident(ssaProc *p, AstNode *name) {
-	Entity **found = map_entity_get(&p->module->info->definitions, hash_pointer(name));
-	if (found) {
-		Entity *e = *found;
+	Entity *e = entity_of_definition(p->module->info, name);
+	if (e != NULL) {
 		return ssa_add_local(p, e, name);
 	}
 
@@ -827,7 +826,7 @@ ssaValue *ssa_emit_deep_field_ptr_index(ssaProc *p, ssaValue *e, Selection sel)
 	Type *type = type_deref(e->type);
 
 	for_array(i, sel.index) {
-		i32 index = cast(i32)sel.index.e[i];
+		i32 index = selection_index(&sel, i);
 		if (is_type_pointer(type)) {
 			type = type_deref(type);
 			e = ssa_emit_load(p, e);
@@ -898,7 +897,7 @@ ssaValue *ssa_emit_deep_field_value_index(ssaProc *p, ssaValue *e, Selection sel
 	GB_ASSERT(can_ssa_type(e->type));
 
 	for_array(i, sel.index) {
-		i32 index = cast(i32)sel.index.e[i];
+		i32 index = selection_index(&sel, i);
 		if (is_type_pointer(type)) {
 			e = ssa_emit_load(p, e);
 		}
@@ -1362,7 +1361,7 @@ ssaValue *ssa_emit_logical_binary_expr(ssaProc *p, AstNode *expr) {
 ssaValue *ssa_build_expr(ssaProc *p, AstNode *expr) {
 	expr = unparen_expr(expr);
 
-	TypeAndValue *tv = map_tav_get(&p->module->info->types, hash_pointer(expr));
+	TypeAndValue *tv = type_and_value_of_expression(p->module->info, expr);
 	GB_ASSERT_NOT_NULL(tv);
 
 	if (tv->value.kind != ExactValue_Invalid) {
@@ -1410,16 +1409,16 @@ ssaValue *ssa_build_expr(ssaProc *p, AstNode *expr) {
 
 	case_ast_node(bd, BasicDirective, expr);
 		TokenPos pos = bd->token.pos;
-		GB_PANIC("Non-constant basic literal %.*s(%td:%td) - %.*s", LIT(pos.file), pos.line, pos.column, LIT(bd->name));
+		GB_PANIC("Non-constant basic literal %.*s(%td:%td) - %.*s", LIT(token_pos_file(pos)), token_pos_line(pos), token_pos_column(pos), LIT(bd->name));
 	case_end;
 
 	case_ast_node(i, Ident, expr);
-		Entity *e = *map_entity_get(&p->module->info->uses, hash_pointer(expr));
+		Entity *e = entity_of_use(p->module->info, expr);
 		if (e->kind == Entity_Builtin) {
 			Token token = ast_node_token(expr);
 			GB_PANIC("TODO(bill): ssa_build_expr Entity_Builtin `%.*s`\n"
 			         "\t at %.*s(%td:%td)", LIT(builtin_procs[e->Builtin.id].name),
-			         LIT(token.pos.file), token.pos.line, token.pos.column);
+			         LIT(token_pos_file(token.pos)), token_pos_line(token.pos), token_pos_column(token.pos));
 			return NULL;
 		} else if (e->kind == Entity_Nil) {
 			GB_PANIC("TODO(bill): nil");
@@ -2149,7 +2148,7 @@ bool ssa_generate(Parser *parser, CheckerInfo *info) {
 
 
 	m.entry_point_entity = entry_point;
-	m.min_dep_map = generate_minimum_dependency_map(info, entry_point);
+	m.min_dep_set = generate_minimum_dependency_set(info, entry_point);
 
 	for_array(i, info->entities.entries) {
 		MapDeclInfoEntry *entry = &info->entities.entries.e[i];
@@ -2162,7 +2161,7 @@ bool ssa_generate(Parser *parser, CheckerInfo *info) {
 			continue;
 		}
 
-		if (map_entity_get(&m.min_dep_map, hash_pointer(e)) == NULL) {
+		if (!entity_set_has(&m.min_dep_set, e)) {
 			// NOTE(bill): Nothing depends upon it so doesn't need to be built
 			continue;
 		}
@@ -2173,7 +2172,7 @@ bool ssa_generate(Parser *parser, CheckerInfo *info) {
 				// Handle later
 			} else if (scope->is_init && e->kind == Entity_Procedure && str_eq(name, str_lit("main"))) {
 			} else {
-				name = ssa_mangle_name(&m, e->token.pos.file, e);
+				name = ssa_mangle_name(&m, token_pos_file(e->token.pos), e);
 			}
 		}
 
@@ -2216,6 +2215,7 @@ bool ssa_generate(Parser *parser, CheckerInfo *info) {
 		}
 	}
 
+	entity_set_destroy(&m.min_dep_set, heap_allocator());
 	return true;
 }
 
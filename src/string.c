@@ -1,10 +1,12 @@
 gb_global gbArena string_buffer_arena = {0};
 gb_global gbAllocator string_buffer_allocator = {0};
+gb_global gbMutex     string_buffer_mutex = {0};
 
 void init_string_buffer_memory(void) {
 	// NOTE(bill): This should be enough memory for file systems
 	gb_arena_init_from_allocator(&string_buffer_arena, heap_allocator(), gb_megabytes(1));
 	string_buffer_allocator = gb_arena_allocator(&string_buffer_arena);
+	gb_mutex_init(&string_buffer_mutex);
 }
 
 
@@ -110,7 +112,7 @@ GB_COMPARE_PROC(string_cmp_proc) {
 	return string_compare(x, y);
 }
 
-gb_inline bool str_eq(String a, String b) { return a.len == b.len ? gb_memcompare(a.text, b.text, a.len) == 0 : false; }
+gb_inline bool str_eq(String a, String b) { return a.len == b.len ? (a.text == b.text || gb_memcompare(a.text, b.text, a.len) == 0) : false; }
 gb_inline bool str_ne(String a, String b) { return !str_eq(a, b);                }
 gb_inline bool str_lt(String a, String b) { return string_compare(a, b) < 0;     }
 gb_inline bool str_gt(String a, String b) { return string_compare(a, b) > 0;     }
@@ -119,7 +121,7 @@ gb_inline bool str_ge(String a, String b) { return string_compare(a, b) >= 0;
 
 gb_inline bool str_has_prefix(String s, String prefix) {
 	isize i;
-	if (prefix.len < s.len) {
+	if (prefix.len > s.len) {
 		return false;
 	}
 	for (i = 0; i < prefix.len; i++) {
@@ -487,3 +489,166 @@ i32 unquote_string(gbAllocator a, String *s_) {
 	}
 	return 2;
 }
+
+
+
+////////////////////////////////////////////////////////////////
+//
+// String Interning
+//
+////////////////////////////////////////////////////////////////
+
+// NOTE: Identifiers are interned by the tokenizer (and entity names by `alloc_entity`) so
+// equal names share the same memory. Each interned string is preceded by a header holding its
+// hash, so `hash_string` never has to rehash it, and an id which is unique to that string.
+// Interning can happen from any thread, the table is split into shards with their own lock.
+typedef struct InternedString {
+	u8 *text; // NOTE: Points just past this header, used to check a String really is interned
+	u64 hash; // NOTE: Same as `gb_fnv64a` of the text
+	i32 id;
+	i32 len;
+} InternedString;
+
+#define STRING_INTERN_SHARD_COUNT 16
+#define STRING_INTERN_BLOCK_SIZE  gb_megabytes(1)
+#define STRING_INTERN_MAX_BLOCKS  4096
+
+typedef struct StringInternBlock {
+	u8 *start;
+	u8 *end;
+} StringInternBlock;
+
+typedef struct StringInternShard {
+	gbMutex           mutex;
+	InternedString ** slots; // NOTE: Open addressing, `slot_count` is zero or a power of two
+	isize             slot_count;
+	isize             count;
+} StringInternShard;
+
+typedef struct StringInterner {
+	StringInternShard shards[STRING_INTERN_SHARD_COUNT];
+
+	gbMutex           block_mutex;
+	StringInternBlock blocks[STRING_INTERN_MAX_BLOCKS];
+	gbAtomic32        block_count; // NOTE: Only incremented once the block has been set
+	u8 *              block_curr;
+	isize             total_reserved;
+	isize             total_used;
+
+	gbAtomic32        id_count;
+} StringInterner;
+
+gb_global StringInterner string_interner = {0};
+
+void init_string_interner(void) {
+	for (isize i = 0; i < STRING_INTERN_SHARD_COUNT; i++) {
+		gb_mutex_init(&string_interner.shards[i].mutex);
+	}
+	gb_mutex_init(&string_interner.block_mutex);
+}
+
+// NOTE: Returns NULL if `s` was not returned by `intern_string`
+InternedString *interned_string_of(String s) {
+	i32 count = gb_atomic32_load(&string_interner.block_count);
+	for (i32 i = count-1; i >= 0; i--) {
+		StringInternBlock *b = &string_interner.blocks[i];
+		if (b->start+gb_size_of(InternedString) <= s.text && s.text < b->end) {
+			InternedString *is = cast(InternedString *)(s.text - gb_size_of(InternedString));
+			if (is->text == s.text && is->len == s.len) {
+				return is;
+			}
+			return NULL;
+		}
+	}
+	return NULL;
+}
+
+gb_internal InternedString *string_interner_alloc(isize len) {
+	isize size = gb_size_of(InternedString) + len + 1;
+	size = (size + gb_align_of(InternedString)-1) & ~cast(isize)(gb_align_of(InternedString)-1);
+
+	gb_mutex_lock(&string_interner.block_mutex);
+	i32 count = gb_atomic32_load(&string_interner.block_count);
+	if (count == 0 || string_interner.block_curr+size > string_interner.blocks[count-1].end) {
+		GB_ASSERT_MSG(count < STRING_INTERN_MAX_BLOCKS, "Too many interned strings");
+		isize block_size = gb_max(size, STRING_INTERN_BLOCK_SIZE);
+		u8 *block = cast(u8 *)gb_alloc_align(heap_allocator(), block_size, gb_align_of(InternedString));
+		string_interner.blocks[count].start = block;
+		string_interner.blocks[count].end   = block + block_size;
+		string_interner.block_curr = block;
+		string_interner.total_reserved += block_size;
+		gb_atomic32_store(&string_interner.block_count, count+1);
+	}
+	InternedString *is = cast(InternedString *)string_interner.block_curr;
+	string_interner.block_curr += size;
+	string_interner.total_used += size;
+	gb_mutex_unlock(&string_interner.block_mutex);
+	return is;
+}
+
+gb_internal void string_intern_shard_insert(StringInternShard *shard, InternedString *is) {
+	isize mask = shard->slot_count-1;
+	isize i = cast(isize)(is->hash >> 4) & mask;
+	while (shard->slots[i] != NULL) {
+		i = (i+1) & mask;
+	}
+	shard->slots[i] = is;
+}
+
+gb_internal void string_intern_shard_grow(StringInternShard *shard) {
+	InternedString **old_slots = shard->slots;
+	isize old_count = shard->slot_count;
+	shard->slot_count = old_count > 0 ? 2*old_count : 256;
+	shard->slots = gb_alloc_array(heap_allocator(), InternedString *, shard->slot_count);
+	gb_zero_size(shard->slots, gb_size_of(InternedString *)*shard->slot_count);
+	for (isize i = 0; i < old_count; i++) {
+		if (old_slots[i] != NULL) {
+			string_intern_shard_insert(shard, old_slots[i]);
+		}
+	}
+	if (old_slots != NULL) {
+		gb_free(heap_allocator(), old_slots);
+	}
+}
+
+String intern_string(String s) {
+	if (s.len == 0 || interned_string_of(s) != NULL) {
+		return s;
+	}
+	GB_ASSERT(s.len <= I32_MAX);
+	u64 hash = gb_fnv64a(s.text, s.len);
+	StringInternShard *shard = &string_interner.shards[hash % STRING_INTERN_SHARD_COUNT];
+	InternedString *found = NULL;
+
+	gb_mutex_lock(&shard->mutex);
+	if (shard->slot_count > 0) {
+		isize mask = shard->slot_count-1;
+		isize i = cast(isize)(hash >> 4) & mask;
+		while (shard->slots[i] != NULL) {
+			InternedString *is = shard->slots[i];
+			if (is->hash == hash && is->len == s.len &&
+			    gb_memcompare(is->text, s.text, s.len) == 0) {
+				found = is;
+				break;
+			}
+			i = (i+1) & mask;
+		}
+	}
+	if (found == NULL) {
+		if (4*(shard->count+1) >= 3*shard->slot_count) {
+			string_intern_shard_grow(shard);
+		}
+		found = string_interner_alloc(s.len);
+		found->text = cast(u8 *)(found+1);
+		found->hash = hash;
+		found->id   = gb_atomic32_fetch_add(&string_interner.id_count, 1);
+		found->len  = cast(i32)s.len;
+		gb_memcopy(found->text, s.text, s.len);
+		found->text[s.len] = 0;
+		string_intern_shard_insert(shard, found);
+		shard->count++;
+	}
+	gb_mutex_unlock(&shard->mutex);
+
+	return make_string(found->text, found->len);
+}
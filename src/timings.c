@@ -32,9 +32,10 @@ u64 win32_time_stamp__freq(void) {
 
 #include <time.h>
 
+// NOTE: Wall clock rather than process time as some stages run on multiple threads
 u64 unix_time_stamp_time_now(void) {
 	struct timespec ts;
-	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+	clock_gettime(CLOCK_MONOTONIC, &ts);
 
 	return (ts.tv_sec * 1000000000) + ts.tv_nsec;
 }
@@ -44,7 +45,7 @@ u64 unix_time_stamp__freq(void) {
 
 	if (freq == 0) {
 		struct timespec ts;
-		clock_getres(CLOCK_PROCESS_CPUTIME_ID, &ts);
+		clock_getres(CLOCK_MONOTONIC, &ts);
 
 		// that would be an absurd resolution (or lack thereof)
 		GB_ASSERT(ts.tv_sec == 0);
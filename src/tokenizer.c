@@ -130,22 +130,177 @@ String const token_strings[] = {
 };
 
 
+// NOTE: Keyword lookup table built from `token_strings` by `init_keyword_hash_table`. The hash
+// constants are chosen so that every current keyword gets its own slot; the probing only exists so that
+// adding a keyword can never break the lookup (it would just cost an extra comparison)
+#define KEYWORD_HASH_TABLE_COUNT (1<<7)
+#define KEYWORD_HASH_TABLE_MASK  (KEYWORD_HASH_TABLE_COUNT-1)
+
+gb_global TokenKind keyword_hash_table[KEYWORD_HASH_TABLE_COUNT] = {0};
+gb_global isize     keyword_max_len = 0;
+
+u32 keyword_hash(u8 const *text, isize len) {
+	return (cast(u32)text[0]*4 + cast(u32)text[len-1]*61 + cast(u32)len) & KEYWORD_HASH_TABLE_MASK;
+}
+
+void init_keyword_hash_table(void) {
+	for (i32 k = Token__KeywordBegin+1; k < Token__KeywordEnd; k++) {
+		String s = token_strings[k];
+		u32 index = keyword_hash(s.text, s.len);
+		while (keyword_hash_table[index] != Token_Invalid) {
+			index = (index+1) & KEYWORD_HASH_TABLE_MASK;
+		}
+		keyword_hash_table[index] = cast(TokenKind)k;
+		keyword_max_len = gb_max(keyword_max_len, s.len);
+	}
+}
+
+// NOTE: Returns Token_Ident if `s` is not a keyword
+TokenKind keyword_lookup(String s) {
+	if (s.len > 1 && s.len <= keyword_max_len) {
+		u32 index = keyword_hash(s.text, s.len);
+		for (;;) {
+			TokenKind k = keyword_hash_table[index];
+			if (k == Token_Invalid) {
+				break;
+			}
+			if (str_eq(s, token_strings[k])) {
+				return k;
+			}
+			index = (index+1) & KEYWORD_HASH_TABLE_MASK;
+		}
+	}
+	return Token_Ident;
+}
+
+
+// NOTE: A position is just a file id and a byte offset into that file. The line and
+// column are only needed when printing, so they are recovered from the file's table of
+// line starts which is built when the file is added.
 typedef struct TokenPos {
-	String file;
-	isize  line;
-	isize  column;
+	i32 file_id; // NOTE: 0 means no position
+	i32 offset;
 } TokenPos;
 
-i32 token_pos_cmp(TokenPos a, TokenPos b) {
-	if (a.line == b.line) {
-		if (a.column == b.column) {
-			isize min_len = gb_min(a.file.len, b.file.len);
-			return gb_memcompare(a.file.text, b.file.text, min_len);
+// NOTE: Entries are split into pages which are allocated when first needed and never move, and
+// a file's line table is built before it is added, so positions can be looked up without a lock
+#define SOURCE_FILE_PAGE_SHIFT 8
+#define SOURCE_FILE_PAGE_SIZE  (1<<SOURCE_FILE_PAGE_SHIFT)
+#define SOURCE_FILE_PAGE_COUNT (1<<12)
+
+typedef struct SourceFile {
+	String     fullpath;
+	Array(i32) line_starts; // NOTE: Offset of the start of each line
+} SourceFile;
+
+typedef struct SourceFileTable {
+	gbMutex       mutex; // NOTE: Only needed to add a file
+	gbAtomicPtr * pages; // NOTE: SourceFile *[SOURCE_FILE_PAGE_SIZE], indexed by file_id-1
+	gbAtomic32    count;
+} SourceFileTable;
+
+gb_global SourceFileTable global_source_files = {0};
+
+void init_global_source_files(void) {
+	gb_mutex_init(&global_source_files.mutex);
+	global_source_files.pages = gb_alloc_array(heap_allocator(), gbAtomicPtr, SOURCE_FILE_PAGE_COUNT);
+	gb_zero_size(global_source_files.pages, gb_size_of(gbAtomicPtr)*SOURCE_FILE_PAGE_COUNT);
+}
+
+i32 add_source_file(String fullpath, u8 *text, isize len) {
+	SourceFile *sf = gb_alloc_item(heap_allocator(), SourceFile);
+	GB_ASSERT_MSG(len <= I32_MAX, "%.*s is too large", LIT(fullpath));
+	sf->fullpath = fullpath;
+	array_init(&sf->line_starts, heap_allocator());
+	array_add(&sf->line_starts, 0);
+	for (u8 *p = text, *end = text+len; p < end; p++) {
+		p = cast(u8 *)memchr(p, '\n', end-p);
+		if (p == NULL) {
+			break;
 		}
-		return (a.column < b.column) ? -1 : +1;
+		array_add(&sf->line_starts, cast(i32)(p+1-text));
 	}
 
-	return (a.line < b.line) ? -1 : +1;
+	SourceFileTable *t = &global_source_files;
+	gb_mutex_lock(&t->mutex);
+	i32 index = gb_atomic32_load(&t->count);
+	isize page_index = index >> SOURCE_FILE_PAGE_SHIFT;
+	GB_ASSERT(page_index < SOURCE_FILE_PAGE_COUNT);
+	SourceFile **page = cast(SourceFile **)gb_atomic_ptr_load(&t->pages[page_index]);
+	if (page == NULL) {
+		page = gb_alloc_array(heap_allocator(), SourceFile *, SOURCE_FILE_PAGE_SIZE);
+		gb_zero_size(page, gb_size_of(SourceFile *)*SOURCE_FILE_PAGE_SIZE);
+		gb_atomic_ptr_store(&t->pages[page_index], page);
+	}
+	page[index & (SOURCE_FILE_PAGE_SIZE-1)] = sf;
+	gb_atomic32_store(&t->count, index+1);
+	gb_mutex_unlock(&t->mutex);
+	return index+1;
+}
+
+SourceFile *source_file__get(i32 file_id) {
+	SourceFileTable *t = &global_source_files;
+	if (file_id <= 0 || file_id > gb_atomic32_load(&t->count)) {
+		return NULL;
+	}
+	i32 index = file_id-1;
+	SourceFile **page = cast(SourceFile **)gb_atomic_ptr_load(&t->pages[index >> SOURCE_FILE_PAGE_SHIFT]);
+	return page[index & (SOURCE_FILE_PAGE_SIZE-1)];
+}
+
+// NOTE: Returns the 0 based line index of `pos` and the offset that line starts at
+isize source_file__line_index(TokenPos pos, i32 *line_start_) {
+	SourceFile *sf = source_file__get(pos.file_id);
+	if (sf == NULL) {
+		return -1;
+	}
+	i32 *starts = sf->line_starts.e;
+	isize lo = 0, hi = sf->line_starts.count-1;
+	while (lo < hi) {
+		isize mid = lo + (hi-lo+1)/2;
+		if (starts[mid] <= pos.offset) {
+			lo = mid;
+		} else {
+			hi = mid-1;
+		}
+	}
+	if (line_start_) *line_start_ = starts[lo];
+	return lo;
+}
+
+bool token_pos_is_valid(TokenPos pos) {
+	return pos.file_id != 0;
+}
+
+String token_pos_file(TokenPos pos) {
+	String file = {0};
+	SourceFile *sf = source_file__get(pos.file_id);
+	if (sf != NULL) {
+		file = sf->fullpath;
+	}
+	return file;
+}
+
+isize token_pos_line(TokenPos pos) {
+	return source_file__line_index(pos, NULL)+1;
+}
+
+isize token_pos_column(TokenPos pos) {
+	i32 line_start = 0;
+	if (source_file__line_index(pos, &line_start) < 0) {
+		return 0;
+	}
+	return pos.offset - line_start + 1;
+}
+
+i32 token_pos_cmp(TokenPos a, TokenPos b) {
+	if (a.file_id == b.file_id) {
+		if (a.offset == b.offset) {
+			return 0;
+		}
+		return (a.offset < b.offset) ? -1 : +1;
+	}
+	return (a.file_id < b.file_id) ? -1 : +1;
 }
 
 bool token_pos_eq(TokenPos a, TokenPos b) {
@@ -162,86 +317,162 @@ Token empty_token = {Token_Invalid};
 Token blank_token = {Token_Ident, {cast(u8 *)"_", 1}};
 
 Token make_token_ident(String s) {
-	Token t = {Token_Ident, s};
+	Token t = {Token_Ident, intern_string(s)};
 	return t;
 }
 
 
 typedef struct ErrorCollector {
-	TokenPos prev;
 	i64 count;
 	i64 warning_count;
 	gbMutex mutex;
 } ErrorCollector;
 
 gb_global ErrorCollector global_error_collector;
+// NOTE: Duplicates are only skipped within a thread, so a parallel worker never resets the position
+// another worker is comparing against
+gb_global gb_thread_local TokenPos error_prev_pos = {0};
+
+typedef enum ErrorMessageKind {
+	ErrorMessage_Warning,
+	ErrorMessage_Error,
+	ErrorMessage_SyntaxError,
+	ErrorMessage_SyntaxWarning,
+	ErrorMessage_Raw, // NOTE: Printed as it is, without a position
+} ErrorMessageKind;
+
+typedef struct ErrorMessage {
+	ErrorMessageKind kind;
+	TokenPos         pos;
+	String           text;
+} ErrorMessage;
+
+typedef Array(ErrorMessage) ErrorMessageArray;
+
+// NOTE: Whilst this is set, messages on this thread are kept here rather than printed. A parallel
+// stage sets it to a buffer per file or procedure and prints them all in a fixed order once its
+// workers have joined, so the output is the same as it would be for a serial run.
+gb_global gb_thread_local ErrorMessageArray *error_buffer = NULL;
 
 void init_global_error_collector(void) {
 	gb_mutex_init(&global_error_collector.mutex);
 }
 
-void warning_va(Token token, char *fmt, va_list va) {
-	gb_mutex_lock(&global_error_collector.mutex);
-	global_error_collector.warning_count++;
-	// NOTE(bill): Duplicate error, skip it
-	if (!token_pos_eq(global_error_collector.prev, token.pos)) {
-		global_error_collector.prev = token.pos;
-		gb_printf_err("%.*s(%td:%td) Warning: %s\n",
-		              LIT(token.pos.file), token.pos.line, token.pos.column,
-		              gb_bprintf_va(fmt, va));
+// NOTE: `global_error_collector.mutex` must be held
+void print_error_message(ErrorMessage *m) {
+	String prefix = {0};
+	switch (m->kind) {
+	case ErrorMessage_Raw:
+		gb_printf_err("%.*s", LIT(m->text));
+		return;
+	case ErrorMessage_Warning:       prefix = str_lit("Warning: ");        break;
+	case ErrorMessage_Error:         prefix = str_lit("");                 break;
+	case ErrorMessage_SyntaxError:   prefix = str_lit("Syntax Error: ");   break;
+	case ErrorMessage_SyntaxWarning: prefix = str_lit("Syntax Warning: "); break;
+	default: GB_PANIC("Unknown error message kind"); break;
 	}
 
-	gb_mutex_unlock(&global_error_collector.mutex);
+	// NOTE(bill): Duplicate error, skip it
+	if (!token_pos_eq(error_prev_pos, m->pos)) {
+		error_prev_pos = m->pos;
+		gb_printf_err("%.*s(%td:%td) %.*s%.*s\n",
+		              LIT(token_pos_file(m->pos)), token_pos_line(m->pos), token_pos_column(m->pos),
+		              LIT(prefix), LIT(m->text));
+	} else if (!token_pos_is_valid(m->pos)) {
+		switch (m->kind) {
+		case ErrorMessage_Error:
+		case ErrorMessage_SyntaxError:
+			gb_printf_err("Error: %.*s\n", LIT(m->text));
+			break;
+		case ErrorMessage_SyntaxWarning:
+			gb_printf_err("Warning: %.*s\n", LIT(m->text));
+			break;
+		default:
+			break;
+		}
+	}
 }
 
-void error_va(Token token, char *fmt, va_list va) {
+void print_error_messages(ErrorMessageArray *messages) {
 	gb_mutex_lock(&global_error_collector.mutex);
-	global_error_collector.count++;
-	// NOTE(bill): Duplicate error, skip it
-	if (!token_pos_eq(global_error_collector.prev, token.pos)) {
-		global_error_collector.prev = token.pos;
-		gb_printf_err("%.*s(%td:%td) %s\n",
-		              LIT(token.pos.file), token.pos.line, token.pos.column,
-		              gb_bprintf_va(fmt, va));
-	} else if (token.pos.line == 0) {
-		gb_printf_err("Error: %s\n", gb_bprintf_va(fmt, va));
+	for_array(i, *messages) {
+		print_error_message(&messages->e[i]);
 	}
-
 	gb_mutex_unlock(&global_error_collector.mutex);
 }
 
-void syntax_error_va(Token token, char *fmt, va_list va) {
-	gb_mutex_lock(&global_error_collector.mutex);
-	global_error_collector.count++;
-	// NOTE(bill): Duplicate error, skip it
-	if (!token_pos_eq(global_error_collector.prev, token.pos)) {
-		global_error_collector.prev = token.pos;
-		gb_printf_err("%.*s(%td:%td) Syntax Error: %s\n",
-		              LIT(token.pos.file), token.pos.line, token.pos.column,
-		              gb_bprintf_va(fmt, va));
-	} else if (token.pos.line == 0) {
-		gb_printf_err("Error: %s\n", gb_bprintf_va(fmt, va));
+void destroy_error_messages(ErrorMessageArray *messages) {
+	for_array(i, *messages) {
+		gb_free(heap_allocator(), messages->e[i].text.text);
 	}
+	array_free(messages);
+}
+
+void report_error_message(ErrorMessageKind kind, TokenPos pos, char *fmt, va_list va) {
+	char buf[4096] = {0};
+	isize len = gb_snprintf_va(buf, gb_size_of(buf), fmt, va);
+	len = gb_clamp(len-1, 0, gb_size_of(buf)-1); // NOTE: Without the NUL
+
+	ErrorMessage m = {0};
+	m.kind = kind;
+	m.pos  = pos;
 
+	gb_mutex_lock(&global_error_collector.mutex);
+	if (kind == ErrorMessage_Warning || kind == ErrorMessage_SyntaxWarning) {
+		global_error_collector.warning_count++;
+	} else {
+		global_error_collector.count++;
+	}
+	if (error_buffer != NULL) {
+		m.text = make_string(cast(u8 *)gb_alloc_str_len(heap_allocator(), buf, len), len);
+		array_add(error_buffer, m);
+	} else {
+		m.text = make_string(cast(u8 *)buf, len);
+		print_error_message(&m);
+	}
 	gb_mutex_unlock(&global_error_collector.mutex);
 }
 
-void syntax_warning_va(Token token, char *fmt, va_list va) {
+// NOTE: For messages which are not an error at a token (e.g. a file which cannot be parsed), these
+// are printed as they are and are not counted
+void report_error_raw(char *fmt, ...) {
+	char buf[4096] = {0};
+	va_list va;
+	va_start(va, fmt);
+	isize len = gb_snprintf_va(buf, gb_size_of(buf), fmt, va);
+	va_end(va);
+	len = gb_clamp(len-1, 0, gb_size_of(buf)-1); // NOTE: Without the NUL
+
+	ErrorMessage m = {0};
+	m.kind = ErrorMessage_Raw;
+
 	gb_mutex_lock(&global_error_collector.mutex);
-	global_error_collector.warning_count++;
-	// NOTE(bill): Duplicate error, skip it
-	if (!token_pos_eq(global_error_collector.prev, token.pos)) {
-		global_error_collector.prev = token.pos;
-		gb_printf_err("%.*s(%td:%td) Syntax Warning: %s\n",
-		              LIT(token.pos.file), token.pos.line, token.pos.column,
-		              gb_bprintf_va(fmt, va));
-	} else if (token.pos.line == 0) {
-		gb_printf_err("Warning: %s\n", gb_bprintf_va(fmt, va));
+	if (error_buffer != NULL) {
+		m.text = make_string(cast(u8 *)gb_alloc_str_len(heap_allocator(), buf, len), len);
+		array_add(error_buffer, m);
+	} else {
+		m.text = make_string(cast(u8 *)buf, len);
+		print_error_message(&m);
 	}
-
 	gb_mutex_unlock(&global_error_collector.mutex);
 }
 
+void warning_va(Token token, char *fmt, va_list va) {
+	report_error_message(ErrorMessage_Warning, token.pos, fmt, va);
+}
+
+void error_va(Token token, char *fmt, va_list va) {
+	report_error_message(ErrorMessage_Error, token.pos, fmt, va);
+}
+
+void syntax_error_va(Token token, char *fmt, va_list va) {
+	report_error_message(ErrorMessage_SyntaxError, token.pos, fmt, va);
+}
+
+void syntax_warning_va(Token token, char *fmt, va_list va) {
+	report_error_message(ErrorMessage_SyntaxWarning, token.pos, fmt, va);
+}
+
 
 
 void warning(Token token, char *fmt, ...) {
@@ -328,6 +559,7 @@ typedef struct TokenizerState {
 
 typedef struct Tokenizer {
 	String fullpath;
+	i32 file_id; // NOTE: Entry in `global_source_files`
 	u8 *start;
 	u8 *end;
 
@@ -339,6 +571,8 @@ typedef struct Tokenizer {
 
 	isize error_count;
 	Array(String) allocated_strings;
+
+	bool is_mapped; // NOTE: `start` points into a read only memory map rather than a heap copy
 } Tokenizer;
 
 
@@ -368,13 +602,12 @@ void tokenizer_err(Tokenizer *t, char *msg, ...) {
 		column = 1;
 	}
 
-	gb_printf_err("%.*s(%td:%td) Syntax error: ", LIT(t->fullpath), t->line_count, column);
-
+	char buf[4096] = {0};
 	va_start(va, msg);
-	gb_printf_err_va(msg, va);
+	gb_snprintf_va(buf, gb_size_of(buf), msg, va);
 	va_end(va);
 
-	gb_printf_err("\n");
+	report_error_raw("%.*s(%td:%td) Syntax error: %s\n", LIT(t->fullpath), t->line_count, column, buf);
 
 	t->error_count++;
 }
@@ -411,6 +644,34 @@ void advance_to_next_rune(Tokenizer *t) {
 	}
 }
 
+#if defined(GB_SYSTEM_UNIX) || defined(GB_SYSTEM_OSX)
+// NOTE: Returns false if the file cannot be mapped (e.g. it is empty) so that the caller can fall
+// back to reading the contents and reporting the error
+bool tokenizer_map_file(Tokenizer *t, char const *c_str) {
+	struct stat st = {0};
+	void *data = NULL;
+	int fd = open(c_str, O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		close(fd);
+		return false;
+	}
+	data = mmap(NULL, cast(size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		return false;
+	}
+	madvise(data, cast(size_t)st.st_size, MADV_SEQUENTIAL);
+
+	t->start = cast(u8 *)data;
+	t->end = t->start + st.st_size;
+	t->is_mapped = true;
+	return true;
+}
+#endif
+
 TokenizerInitError init_tokenizer(Tokenizer *t, String fullpath) {
 	TokenizerInitError err = TokenizerInit_None;
 
@@ -418,14 +679,22 @@ TokenizerInitError init_tokenizer(Tokenizer *t, String fullpath) {
 	memcpy(c_str, fullpath.text, fullpath.len);
 	c_str[fullpath.len] = '\0';
 
-	// TODO(bill): Memory map rather than copy contents
-	gbFileContents fc = gb_file_read_contents(heap_allocator(), true, c_str);
 	gb_zero_item(t);
-	if (fc.data != NULL) {
-		t->start = cast(u8 *)fc.data;
+#if defined(GB_SYSTEM_UNIX) || defined(GB_SYSTEM_OSX)
+	tokenizer_map_file(t, c_str);
+#endif
+	if (!t->is_mapped) {
+		gbFileContents fc = gb_file_read_contents(heap_allocator(), true, c_str);
+		if (fc.data != NULL) {
+			t->start = cast(u8 *)fc.data;
+			t->end = t->start + fc.size;
+		}
+	}
+
+	if (t->start != NULL) {
 		t->line = t->read_curr = t->curr = t->start;
-		t->end = t->start + fc.size;
 		t->fullpath = fullpath;
+		t->file_id = add_source_file(fullpath, t->start, t->end - t->start);
 		t->line_count = 1;
 
 		advance_to_next_rune(t);
@@ -456,7 +725,11 @@ TokenizerInitError init_tokenizer(Tokenizer *t, String fullpath) {
 }
 
 gb_inline void destroy_tokenizer(Tokenizer *t) {
-	if (t->start != NULL) {
+	if (t->is_mapped) {
+	#if defined(GB_SYSTEM_UNIX) || defined(GB_SYSTEM_OSX)
+		munmap(t->start, cast(size_t)(t->end - t->start));
+	#endif
+	} else if (t->start != NULL) {
 		gb_free(heap_allocator(), t->start);
 	}
 	for_array(i, t->allocated_strings) {
@@ -465,11 +738,85 @@ gb_inline void destroy_tokenizer(Tokenizer *t) {
 	array_free(&t->allocated_strings);
 }
 
+// NOTE: ASCII fast paths
+// The `tokenizer__skip_*` procedures move the tokenizer onto the last byte of a run of plain ASCII bytes,
+// leaving it in exactly the state that calling `advance_to_next_rune` for each of them would have. The run
+// starts at `read_curr` and stops before NUL, any byte >= 0x80, or anything the caller wants to look at, so
+// the next `advance_to_next_rune` deals with those (and reports any errors) as normal.
+
+#define TOKENIZER_SWAR_ONES  0x0101010101010101ull
+#define TOKENIZER_SWAR_HIGHS 0x8080808080808080ull
+
+u64 tokenizer__swar_zero_bytes(u64 x) {
+	return (x - TOKENIZER_SWAR_ONES) & ~x & TOKENIZER_SWAR_HIGHS;
+}
+
+u64 tokenizer__swar_stop_bytes(u64 x, u8 a, u8 b, u8 c) {
+	return tokenizer__swar_zero_bytes(x) |
+	       tokenizer__swar_zero_bytes(x ^ (TOKENIZER_SWAR_ONES*a)) |
+	       tokenizer__swar_zero_bytes(x ^ (TOKENIZER_SWAR_ONES*b)) |
+	       tokenizer__swar_zero_bytes(x ^ (TOKENIZER_SWAR_ONES*c)) |
+	       (x & TOKENIZER_SWAR_HIGHS);
+}
+
+// NOTE: Returns the first byte in [p, end) that is NUL, non-ASCII, `a`, `b`, or `c`
+u8 *tokenizer__find_stop_byte(u8 *p, u8 *end, u8 a, u8 b, u8 c) {
+	while (end-p >= 8) {
+		u64 x;
+		memcpy(&x, p, 8);
+		if (tokenizer__swar_stop_bytes(x, a, b, c) != 0) {
+			break;
+		}
+		p += 8;
+	}
+	while (p < end) {
+		u8 x = *p;
+		if (x == 0 || x >= 0x80 || x == a || x == b || x == c) {
+			break;
+		}
+		p++;
+	}
+	return p;
+}
+
+// NOTE: Every byte in [read_curr, stop) must be ASCII, not NUL, and not a newline, and the current
+// rune must not be a newline
+void tokenizer__skip_to(Tokenizer *t, u8 *stop) {
+	if (stop > t->read_curr) {
+		t->curr      = stop-1;
+		t->curr_rune = *t->curr;
+		t->read_curr = stop;
+	}
+}
+
+bool tokenizer__is_whitespace_byte(u8 c) {
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool tokenizer__is_ident_byte(u8 c) {
+	return gb_is_between(c, 'a', 'z') ||
+	       gb_is_between(c, 'A', 'Z') ||
+	       gb_is_between(c, '0', '9') ||
+	       c == '_';
+}
+
 void tokenizer_skip_whitespace(Tokenizer *t) {
 	while (t->curr_rune == ' ' ||
 	       t->curr_rune == '\t' ||
 	       t->curr_rune == '\n' ||
 	       t->curr_rune == '\r') {
+		// NOTE: Walk to the last whitespace byte, counting the newlines on the way
+		u8 *p = t->curr;
+		while (p+1 < t->end && tokenizer__is_whitespace_byte(p[1])) {
+			if (*p == '\n') {
+				t->line = p+1;
+				t->line_count++;
+			}
+			p++;
+		}
+		t->curr      = p;
+		t->curr_rune = *p;
+		t->read_curr = p+1;
 		advance_to_next_rune(t);
 	}
 }
@@ -495,9 +842,8 @@ Token scan_number_to_token(Tokenizer *t, bool seen_decimal_point) {
 	Token token = {0};
 	token.kind = Token_Integer;
 	token.string = make_string(t->curr, 1);
-	token.pos.file = t->fullpath;
-	token.pos.line = t->line_count;
-	token.pos.column = t->curr-t->line+1;
+	token.pos.file_id = t->file_id;
+	token.pos.offset  = cast(i32)(t->curr - t->start);
 
 	if (seen_decimal_point) {
 		token.kind = Token_Float;
@@ -746,27 +1092,29 @@ Token tokenizer_get_token(Tokenizer *t) {
 
 	Token token = {0};
 	token.string = make_string(t->curr, 1);
-	token.pos.file = t->fullpath;
-	token.pos.line = t->line_count;
-	token.pos.column = t->curr - t->line + 1;
+	token.pos.file_id = t->file_id;
+	token.pos.offset  = cast(i32)(t->curr - t->start);
 
 	Rune curr_rune = t->curr_rune;
 	if (rune_is_letter(curr_rune)) {
 		token.kind = Token_Ident;
 		while (rune_is_letter(t->curr_rune) || rune_is_digit(t->curr_rune)) {
+			u8 *p = t->read_curr;
+			while (p < t->end && tokenizer__is_ident_byte(*p)) {
+				p++;
+			}
+			tokenizer__skip_to(t, p);
 			advance_to_next_rune(t);
 		}
 
 		token.string.len = t->curr - token.string.text;
 
 		// NOTE(bill): All keywords are > 1
-		if (token.string.len > 1) {
-			for (i32 k = Token__KeywordBegin+1; k < Token__KeywordEnd; k++) {
-				if (str_eq(token.string, token_strings[k])) {
-					token.kind = cast(TokenKind)k;
-					break;
-				}
-			}
+		token.kind = keyword_lookup(token.string);
+		if (token.kind == Token_Ident) {
+			// NOTE: Return now as `text` no longer points into the file for the length below
+			token.string = intern_string(token.string);
+			return token;
 		}
 
 	} else if (gb_is_between(curr_rune, '0', '9')) {
@@ -809,8 +1157,11 @@ Token tokenizer_get_token(Tokenizer *t) {
 			token.string.len = t->curr - token.string.text;
 			success = unquote_string(heap_allocator(), &token.string);
 			if (success > 0) {
+				String unquoted = token.string;
+				token.string = intern_string(unquoted);
 				if (success == 2) {
-					array_add(&t->allocated_strings, token.string);
+					// NOTE: The interned copy is used from now on
+					gb_free(heap_allocator(), unquoted.text);
 				}
 				return token;
 			} else {
@@ -855,8 +1206,10 @@ Token tokenizer_get_token(Tokenizer *t) {
 			token.string.len = t->curr - token.string.text;
 			success = unquote_string(heap_allocator(), &token.string);
 			if (success > 0) {
+				String unquoted = token.string;
+				token.string = intern_string(unquoted);
 				if (success == 2) {
-					array_add(&t->allocated_strings, token.string);
+					gb_free(heap_allocator(), unquoted.text);
 				}
 				return token;
 			} else {
@@ -901,6 +1254,7 @@ Token tokenizer_get_token(Tokenizer *t) {
 		case '/': {
 			if (t->curr_rune == '/') {
 				while (t->curr_rune != '\n' && t->curr_rune != GB_RUNE_EOF) {
+					tokenizer__skip_to(t, tokenizer__find_stop_byte(t->read_curr, t->end, '\n', '\n', '\n'));
 					advance_to_next_rune(t);
 				}
 				token.kind = Token_Comment;
@@ -908,6 +1262,10 @@ Token tokenizer_get_token(Tokenizer *t) {
 				isize comment_scope = 1;
 				advance_to_next_rune(t);
 				while (comment_scope > 0) {
+					if (t->curr_rune == GB_RUNE_EOF) {
+						tokenizer_err(t, "Comment not terminated");
+						break;
+					}
 					if (t->curr_rune == '/') {
 						advance_to_next_rune(t);
 						if (t->curr_rune == '*') {
@@ -921,6 +1279,9 @@ Token tokenizer_get_token(Tokenizer *t) {
 							comment_scope--;
 						}
 					} else {
+						if (t->curr_rune != '\n') {
+							tokenizer__skip_to(t, tokenizer__find_stop_byte(t->read_curr, t->end, '\n', '/', '*'));
+						}
 						advance_to_next_rune(t);
 					}
 				}
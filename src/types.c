@@ -105,6 +105,8 @@ typedef struct TypeRecord {
 	Entity * enum_count;
 	Entity * enum_min_value;
 	Entity * enum_max_value;
+
+	gbAtomicPtr field_index; // NOTE: `RecordFieldIndex *`, made when the record is checked, see `record_field_index_build`
 } TypeRecord;
 
 #define TYPE_KINDS                                        \
@@ -173,31 +175,86 @@ typedef struct Type {
 #undef TYPE_KIND
 	};
 	bool failure;
+	bool canonical; // NOTE: Interned and so unique for its structure (see `intern_type`)
+	bool layout_cached; // NOTE: Only set once `type_layouts_are_final` (see `type_cache_layout`)
+	i64  cached_size;
+	i64  cached_align;
 } Type;
 
 
 // TODO(bill): Should I add extra information here specifying the kind of selection?
 // e.g. field, constant, vector field, type field, etc.
+
+// NOTE: Nearly every selection path is shorter than this so it is stored inline and
+// only paths through many `using` fields go to the heap
+#define SELECTION_INLINE_INDEX_COUNT 4
+
+typedef struct SelectionIndex {
+	isize count;
+	isize capacity; // NOTE: Only set once the indices are on the heap
+	i32 * heap;
+	i32   inline_e[SELECTION_INLINE_INDEX_COUNT];
+} SelectionIndex;
+
 typedef struct Selection {
-	Entity *  entity;
-	Array_i32 index;
-	bool      indirect; // Set if there was a pointer deref anywhere down the line
+	Entity *       entity;
+	SelectionIndex index;
+	bool           indirect; // Set if there was a pointer deref anywhere down the line
 } Selection;
 Selection empty_selection = {0};
 
-Selection make_selection(Entity *entity, Array_i32 index, bool indirect) {
-	Selection s = {entity, index, indirect};
+// NOTE: For `-show-timings`. These are per thread so counting is a plain add, the parallel
+// check workers add theirs to the calling thread's once they have joined
+typedef struct SelectionStats {
+	isize path_count;       // Selections with at least one index
+	isize heap_alloc_count;
+} SelectionStats;
+gb_global gb_thread_local SelectionStats selection_stats = {0};
+
+Selection make_selection(Entity *entity, bool indirect) {
+	Selection s = {0};
+	s.entity   = entity;
+	s.indirect = indirect;
 	return s;
 }
 
+i32 *selection_indices(Selection *s) {
+	return s->index.heap != NULL ? s->index.heap : s->index.inline_e;
+}
+
+i32 selection_index(Selection *s, isize i) {
+	GB_ASSERT(0 <= i && i < s->index.count);
+	return selection_indices(s)[i];
+}
+
 void selection_add_index(Selection *s, isize index) {
-	// IMPORTANT NOTE(bill): this requires a stretchy buffer/dynamic array so it requires some form
-	// of heap allocation
-	// TODO(bill): Find a way to use a backing buffer for initial use as the general case is probably .count<3
-	if (s->index.e == NULL) {
-		array_init(&s->index, heap_allocator());
+	SelectionIndex *si = &s->index;
+	if (si->count == 0) {
+		selection_stats.path_count++;
+	}
+	if (si->heap == NULL) {
+		if (si->count < SELECTION_INLINE_INDEX_COUNT) {
+			si->inline_e[si->count++] = cast(i32)index;
+			return;
+		}
+		si->capacity = 2*SELECTION_INLINE_INDEX_COUNT;
+		si->heap = gb_alloc_array(heap_allocator(), i32, si->capacity);
+		gb_memcopy(si->heap, si->inline_e, gb_size_of(i32)*si->count);
+		selection_stats.heap_alloc_count++;
+	} else if (si->count >= si->capacity) {
+		isize new_capacity = 2*si->capacity;
+		si->heap = cast(i32 *)gb_resize(heap_allocator(), si->heap, gb_size_of(i32)*si->capacity, gb_size_of(i32)*new_capacity);
+		si->capacity = new_capacity;
+		selection_stats.heap_alloc_count++;
 	}
-	array_add(&s->index, index);
+	si->heap[si->count++] = cast(i32)index;
+}
+
+void selection_destroy(Selection *s) {
+	if (s->index.heap != NULL) {
+		gb_free(heap_allocator(), s->index.heap);
+	}
+	s->index = empty_selection.index;
 }
 
 
@@ -415,36 +472,148 @@ Type *make_type_basic(gbAllocator a, BasicType basic) {
 	return t;
 }
 
-Type *make_type_pointer(gbAllocator a, Type *elem) {
-	Type *t = alloc_type(a, Type_Pointer);
-	t->Pointer.elem = elem;
+
+#define MAP_TYPE Type *
+#define MAP_PROC map_type_
+#define MAP_NAME MapType
+#include "map.c"
+
+#define TYPE_INTERN_ARENA_BLOCK_SIZE gb_kilobytes(64)
+
+// NOTE: Pointer, array, slice, dynamic array, vector, and map types are interned so that
+// there is only ever one `Type` for each. Named and record types are never interned as every
+// declaration of one is distinct.
+typedef struct TypeInternTable {
+	gbMutex mutex;
+	MapType types; // Key: hash of the kind and fields, with multiple values on collision
+	Arena   arena;
+} TypeInternTable;
+
+gb_global TypeInternTable type_intern_table = {0};
+
+void init_type_intern_table(void) {
+	gb_mutex_init(&type_intern_table.mutex);
+	map_type_init(&type_intern_table.types, heap_allocator());
+	arena_init(&type_intern_table.arena, heap_allocator(), TYPE_INTERN_ARENA_BLOCK_SIZE);
+}
+
+// NOTE: Two different canonical types are never identical
+bool is_type_canonical(Type *t) {
+	switch (t->kind) {
+	case Type_Basic:
+		return t == &basic_types[t->Basic.kind];
+	case Type_Named:
+		return t->Named.type_name != NULL && t->Named.type_name->type == t;
+	case Type_Record:
+		return t->Record.kind == TypeRecord_Enum;
+	default:
+		break;
+	}
+	return t->canonical;
+}
+
+HashKey hash_interned_type(Type *t) {
+	struct {
+		TypeKind kind;
+		Type *   elem;
+		Type *   value;
+		i64      count;
+	} key;
+	gb_zero_item(&key); // NOTE: Padding is hashed too
+	key.kind = t->kind;
+	switch (t->kind) {
+	case Type_Pointer:      key.elem = t->Pointer.elem;                                                  break;
+	case Type_Array:        key.elem = t->Array.elem;        key.count = t->Array.count;                 break;
+	case Type_DynamicArray: key.elem = t->DynamicArray.elem;                                             break;
+	case Type_Vector:       key.elem = t->Vector.elem;       key.count = t->Vector.count;                break;
+	case Type_Slice:        key.elem = t->Slice.elem;                                                    break;
+	case Type_Map:          key.elem = t->Map.key;           key.value = t->Map.value; key.count = t->Map.count; break;
+	default: GB_PANIC("Type kind cannot be interned");
+	}
+	return hashing_proc(&key, gb_size_of(key));
+}
+
+bool are_interned_types_equal(Type *x, Type *y) {
+	if (x->kind != y->kind) {
+		return false;
+	}
+	switch (x->kind) {
+	case Type_Pointer:      return x->Pointer.elem == y->Pointer.elem;
+	case Type_Array:        return x->Array.elem == y->Array.elem && x->Array.count == y->Array.count;
+	case Type_DynamicArray: return x->DynamicArray.elem == y->DynamicArray.elem;
+	case Type_Vector:       return x->Vector.elem == y->Vector.elem && x->Vector.count == y->Vector.count;
+	case Type_Slice:        return x->Slice.elem == y->Slice.elem;
+	case Type_Map:          return x->Map.key == y->Map.key && x->Map.value == y->Map.value && x->Map.count == y->Map.count;
+	default:                break;
+	}
+	return false;
+}
+
+// NOTE: Returns the unique `Type` with the same structure as `proto`
+Type *intern_type(Type *proto) {
+	HashKey key = hash_interned_type(proto);
+	Type *t = NULL;
+
+	gb_mutex_lock(&type_intern_table.mutex);
+	MapTypeEntry *e = map_type_multi_find_first(&type_intern_table.types, key);
+	while (e != NULL) {
+		if (are_interned_types_equal(e->value, proto)) {
+			t = e->value;
+			break;
+		}
+		e = map_type_multi_find_next(&type_intern_table.types, e);
+	}
+	if (t == NULL) {
+		t = gb_alloc_item(arena_allocator(&type_intern_table.arena), Type);
+		*t = *proto;
+		switch (t->kind) {
+		case Type_Map:
+			t->canonical = (t->Map.key == NULL || is_type_canonical(t->Map.key)) &&
+			               (t->Map.value == NULL || is_type_canonical(t->Map.value));
+			break;
+		default:
+			// NOTE: All of the other kinds store their element first
+			t->canonical = t->Pointer.elem != NULL && is_type_canonical(t->Pointer.elem);
+			break;
+		}
+		map_type_multi_insert(&type_intern_table.types, key, t);
+	}
+	gb_mutex_unlock(&type_intern_table.mutex);
 	return t;
 }
 
+
+// NOTE: The allocator is unused for interned types as they live in `type_intern_table`
+Type *make_type_pointer(gbAllocator a, Type *elem) {
+	Type t = {Type_Pointer};
+	t.Pointer.elem = elem;
+	return intern_type(&t);
+}
+
 Type *make_type_array(gbAllocator a, Type *elem, i64 count) {
-	Type *t = alloc_type(a, Type_Array);
-	t->Array.elem = elem;
-	t->Array.count = count;
-	return t;
+	Type t = {Type_Array};
+	t.Array.elem = elem;
+	t.Array.count = count;
+	return intern_type(&t);
 }
 
 Type *make_type_dynamic_array(gbAllocator a, Type *elem) {
-	Type *t = alloc_type(a, Type_DynamicArray);
-	t->DynamicArray.elem = elem;
-	return t;
+	Type t = {Type_DynamicArray};
+	t.DynamicArray.elem = elem;
+	return intern_type(&t);
 }
 
 Type *make_type_vector(gbAllocator a, Type *elem, i64 count) {
-	Type *t = alloc_type(a, Type_Vector);
-	t->Vector.elem = elem;
-	t->Vector.count = count;
-	return t;
+	Type t = {Type_Vector};
+	t.Vector.elem = elem;
+	t.Vector.count = count;
+	return intern_type(&t);
 }
 
 Type *make_type_slice(gbAllocator a, Type *elem) {
-	Type *t = alloc_type(a, Type_Slice);
-	t->Array.elem = elem;
-	return t;
+	Type t = {Type_Slice};
+	t.Slice.elem = elem;
+	return intern_type(&t);
 }
 
 
@@ -517,14 +686,14 @@ Type *make_type_proc(gbAllocator a, Scope *scope, Type *params, isize param_coun
 bool is_type_valid_for_keys(Type *t);
 
 Type *make_type_map(gbAllocator a, i64 count, Type *key, Type *value) {
-	Type *t = alloc_type(a, Type_Map);
+	Type t = {Type_Map};
 	if (key != NULL) {
 		GB_ASSERT(is_type_valid_for_keys(key));
 	}
-	t->Map.count = count;
-	t->Map.key   = key;
-	t->Map.value = value;
-	return t;
+	t.Map.count = count;
+	t.Map.key   = key;
+	t.Map.value = value;
+	return intern_type(&t);
 }
 
 
@@ -882,6 +1051,11 @@ bool are_types_identical(Type *x, Type *y) {
 		return false;
 	}
 
+	if (is_type_canonical(x) && is_type_canonical(y)) {
+		// NOTE: Otherwise `x == y` above
+		return false;
+	}
+
 	switch (x->kind) {
 	case Type_Basic:
 		if (y->kind == Type_Basic) {
@@ -1000,6 +1174,103 @@ bool are_types_identical(Type *x, Type *y) {
 }
 
 
+u64 type_hash_combine(u64 h, u64 x) {
+	return (h ^ x) * 0x100000001b3ull; // NOTE: FNV-1a prime
+}
+
+// NOTE: A structural hash which agrees with `are_types_identical`, i.e. identical types
+// always have the same hash
+u64 type_hash(Type *t) {
+	if (t == NULL) {
+		return 0;
+	}
+
+	u64 h = type_hash_combine(0xcbf29ce484222325ull, t->kind);
+	switch (t->kind) {
+	case Type_Basic:
+		h = type_hash_combine(h, t->Basic.kind);
+		break;
+	case Type_Pointer:
+		h = type_hash_combine(h, type_hash(t->Pointer.elem));
+		break;
+	case Type_Array:
+		h = type_hash_combine(h, cast(u64)t->Array.count);
+		h = type_hash_combine(h, type_hash(t->Array.elem));
+		break;
+	case Type_DynamicArray:
+		h = type_hash_combine(h, type_hash(t->DynamicArray.elem));
+		break;
+	case Type_Vector:
+		h = type_hash_combine(h, cast(u64)t->Vector.count);
+		h = type_hash_combine(h, type_hash(t->Vector.elem));
+		break;
+	case Type_Slice:
+		h = type_hash_combine(h, type_hash(t->Slice.elem));
+		break;
+
+	case Type_Record:
+		h = type_hash_combine(h, t->Record.kind);
+		if (t->Record.kind == TypeRecord_Enum) {
+			// NOTE: All enums are unique
+			h = type_hash_combine(h, cast(u64)cast(uintptr)t);
+			break;
+		}
+		h = type_hash_combine(h, t->Record.field_count);
+		h = type_hash_combine(h, t->Record.variant_count);
+		h = type_hash_combine(h, t->Record.is_packed);
+		h = type_hash_combine(h, t->Record.is_ordered);
+		h = type_hash_combine(h, cast(u64)t->Record.custom_align);
+		for (isize i = 0; i < t->Record.field_count; i++) {
+			Entity *f = t->Record.fields[i];
+			h = type_hash_combine(h, type_hash(f->type));
+			h = type_hash_combine(h, gb_fnv64a(f->token.string.text, f->token.string.len));
+		}
+		for (isize i = 1; i < t->Record.variant_count; i++) {
+			Entity *v = t->Record.variants[i];
+			h = type_hash_combine(h, type_hash(v->type));
+			h = type_hash_combine(h, gb_fnv64a(v->token.string.text, v->token.string.len));
+		}
+		break;
+
+	case Type_Named:
+		// NOTE: Named types are identical only if they are from the same declaration
+		h = type_hash_combine(h, cast(u64)cast(uintptr)t->Named.type_name);
+		break;
+
+	case Type_Tuple:
+		h = type_hash_combine(h, t->Tuple.variable_count);
+		for (isize i = 0; i < t->Tuple.variable_count; i++) {
+			h = type_hash_combine(h, type_hash(t->Tuple.variables[i]->type));
+		}
+		break;
+
+	case Type_Proc:
+		h = type_hash_combine(h, t->Proc.calling_convention);
+		h = type_hash_combine(h, t->Proc.variadic);
+		h = type_hash_combine(h, type_hash(t->Proc.params));
+		h = type_hash_combine(h, type_hash(t->Proc.results));
+		break;
+
+	case Type_Map:
+		h = type_hash_combine(h, cast(u64)t->Map.count);
+		h = type_hash_combine(h, type_hash(t->Map.key));
+		h = type_hash_combine(h, type_hash(t->Map.value));
+		break;
+
+	default:
+		break;
+	}
+	return h;
+}
+
+HashKey hash_type_structure(Type *t) {
+	HashKey h = {HashKey_Default};
+	h.key = type_hash(t);
+	h.ptr = t;
+	return h;
+}
+
+
 Type *default_type(Type *type) {
 	if (type == NULL) {
 		return t_invalid;
@@ -1167,6 +1438,96 @@ gb_global Entity *entity__dynamic_map_capacity  = NULL;
 gb_global Entity *entity__dynamic_map_allocator = NULL;
 
 Selection lookup_field_with_selection(gbAllocator a, Type *type_, String field_name, bool is_type, Selection sel);
+Selection lookup_record_field(gbAllocator a, Type *type, String field_name, bool is_type);
+
+
+// NOTE: The lookup of every field of a record, including the fields promoted through `using`, is
+// made along with its full path once the record has been checked, so a selector does not need to
+// walk the fields (and the fields of every anonymous field). The index is never changed after it
+// is published, so it is read without a lock. A name which is not in it is looked up the slow way.
+typedef struct RecordFieldLookup {
+	Entity *entity;
+	i32 *   index;
+	i32     index_count;
+	bool    indirect;
+} RecordFieldLookup;
+
+#define MAP_TYPE RecordFieldLookup
+#define MAP_PROC map_record_field_lookup_
+#define MAP_NAME MapRecordFieldLookup
+#include "open_map.c"
+
+typedef struct RecordFieldIndex {
+	Entity **            fields;  // NOTE: The `Record.fields` these lookups were made with
+	MapRecordFieldLookup lookups; // Key: String
+} RecordFieldIndex;
+
+bool record_field_index_get(Type *record, String field_name, RecordFieldLookup *lookup_) {
+	RecordFieldIndex *fi = cast(RecordFieldIndex *)gb_atomic_ptr_load(&record->Record.field_index);
+	// NOTE: The fields may have been changed since the index was made
+	if (fi != NULL && fi->fields == record->Record.fields) {
+		RecordFieldLookup *lookup = map_record_field_lookup_get(&fi->lookups, hash_string(field_name));
+		if (lookup != NULL) {
+			*lookup_ = *lookup;
+			return true;
+		}
+	}
+	return false;
+}
+
+void record_field_index_add(RecordFieldIndex *fi, Type *record, String field_name) {
+	gbAllocator a = heap_allocator();
+	HashKey key = hash_string(field_name);
+	if (str_eq(field_name, str_lit("_")) || map_record_field_lookup_get(&fi->lookups, key) != NULL) {
+		return;
+	}
+	Selection sel = lookup_record_field(a, record, field_name, false);
+	if (sel.entity != NULL) {
+		RecordFieldLookup lookup = {0};
+		lookup.entity      = sel.entity;
+		lookup.index_count = cast(i32)sel.index.count;
+		lookup.indirect    = sel.indirect;
+		if (sel.index.count > 0) {
+			lookup.index = gb_alloc_array(a, i32, sel.index.count);
+			gb_memcopy(lookup.index, selection_indices(&sel), gb_size_of(i32)*sel.index.count);
+		}
+		map_record_field_lookup_set(&fi->lookups, key, lookup);
+	}
+	selection_destroy(&sel);
+}
+
+// NOTE: Called once the fields of `record` are final. Names promoted from an anonymous field are
+// only in the index if that field's record was indexed first, which is the usual case.
+void record_field_index_build(Type *record) {
+	gbAllocator a = heap_allocator();
+	GB_ASSERT(record->kind == Type_Record);
+	RecordFieldIndex *fi = gb_alloc_item(a, RecordFieldIndex);
+	fi->fields = record->Record.fields;
+	map_record_field_lookup_init_with_reserve(&fi->lookups, a, record->Record.field_count);
+
+	for (isize i = 0; i < record->Record.field_count; i++) {
+		Entity *f = record->Record.fields[i];
+		if (f->kind != Entity_Variable || (f->flags & EntityFlag_Field) == 0) {
+			continue;
+		}
+		record_field_index_add(fi, record, f->token.string);
+
+		if (f->flags & EntityFlag_Anonymous) {
+			Type *ft = base_type(type_deref(f->type));
+			if (ft->kind == Type_Record) {
+				RecordFieldIndex *inner = cast(RecordFieldIndex *)gb_atomic_ptr_load(&ft->Record.field_index);
+				if (inner != NULL) {
+					for_array(j, inner->lookups.entries) {
+						record_field_index_add(fi, record, inner->lookups.entries.e[j].key.string);
+					}
+				}
+			}
+		}
+	}
+
+	gb_atomic_ptr_store(&record->Record.field_index, fi);
+}
+
 
 Selection lookup_field(gbAllocator a, Type *type_, String field_name, bool is_type) {
 	return lookup_field_with_selection(a, type_, field_name, is_type, empty_selection);
@@ -1192,10 +1553,9 @@ Selection lookup_field_from_index(gbAllocator a, Type *type, i64 index) {
 			Entity *f = type->Record.fields[i];
 			if (f->kind == Entity_Variable) {
 				if (f->Variable.field_src_index == index) {
-					Array_i32 sel_array = {0};
-					array_init_count(&sel_array, a, 1);
-					sel_array.e[0] = i;
-					return make_selection(f, sel_array, false);
+					Selection sel = make_selection(f, false);
+					selection_add_index(&sel, i);
+					return sel;
 				}
 			}
 		}
@@ -1204,10 +1564,9 @@ Selection lookup_field_from_index(gbAllocator a, Type *type, i64 index) {
 		for (isize i = 0; i < max_count; i++) {
 			Entity *f = type->Tuple.variables[i];
 			if (i == index) {
-				Array_i32 sel_array = {0};
-				array_init_count(&sel_array, a, 1);
-				sel_array.e[0] = i;
-				return make_selection(f, sel_array, false);
+				Selection sel = make_selection(f, false);
+				selection_add_index(&sel, i);
+				return sel;
 			}
 		}
 		break;
@@ -1238,6 +1597,8 @@ Selection lookup_field_with_selection(gbAllocator a, Type *type_, String field_n
 			// `Raw_Any` type?
 			String type_info_str = str_lit("type_info");
 			String data_str = str_lit("data");
+			// NOTE: `init_preload` makes these before any procedure body is checked, which may be
+			// on worker threads, so they are only made here for a global declaration before that
 			if (entity__any_type_info == NULL) {
 				entity__any_type_info = make_entity_field(a, NULL, make_token_ident(type_info_str), t_type_info_ptr, false, 0);
 			}
@@ -1473,13 +1834,45 @@ Selection lookup_field_with_selection(gbAllocator a, Type *type_, String field_n
 			}
 		}
 	} else if (type->kind == Type_Record) {
+		// NOTE: `is_type` lookups are rare and can find different things so only values are remembered
+		RecordFieldLookup lookup = {0};
+		if (!is_type && record_field_index_get(type, field_name, &lookup)) {
+			for (isize i = 0; i < lookup.index_count; i++) {
+				selection_add_index(&sel, lookup.index[i]);
+			}
+			sel.entity   = lookup.entity;
+			sel.indirect = sel.indirect || lookup.indirect;
+			return sel;
+		}
+
+		Selection rel = lookup_record_field(a, type, field_name, is_type);
+		if (rel.entity != NULL) {
+			for_array(i, rel.index) {
+				selection_add_index(&sel, selection_index(&rel, i));
+			}
+			sel.entity = rel.entity;
+		}
+		sel.indirect = sel.indirect || rel.indirect;
+		selection_destroy(&rel);
+	}
+
+	return sel;
+}
+
+Selection lookup_record_field(gbAllocator a, Type *type, String field_name, bool is_type) {
+	Selection sel = empty_selection;
+	GB_ASSERT(type->kind == Type_Record);
+	{
+		// NOTE: Entity names are always interned so if `field_name` is too, the names
+		// are only equal if they are the same memory
+		bool name_is_interned = interned_string_of(field_name) != NULL;
 		for (isize i = 0; i < type->Record.field_count; i++) {
 			Entity *f = type->Record.fields[i];
 			if (f->kind != Entity_Variable || (f->flags & EntityFlag_Field) == 0) {
 				continue;
 			}
 			String str = f->token.string;
-			if (str_eq(field_name, str)) {
+			if (name_is_interned ? str.text == field_name.text : str_eq(field_name, str)) {
 				selection_add_index(&sel, i);  // HACK(bill): Leaky memory
 				sel.entity = f;
 				return sel;
@@ -1512,8 +1905,11 @@ typedef struct TypePath {
 } TypePath;
 
 void type_path_init(TypePath *tp) {
-	// TODO(bill): Use an allocator that uses a backing array if it can and then use alternative allocator when exhausted
-	array_init(&tp->path, heap_allocator());
+	// NOTE: Nothing is allocated until the first push as most types never need a path
+	tp->path.allocator = heap_allocator();
+	tp->path.e         = NULL;
+	tp->path.count     = 0;
+	tp->path.capacity  = 0;
 }
 
 void type_path_free(TypePath *tp) {
@@ -1575,10 +1971,45 @@ i64 align_formula(i64 size, i64 align) {
 	return size;
 }
 
+// NOTE: Named types may still be incomplete whilst they are being checked, so the
+// layout of a type is only memoized once the checker has set `type_layouts_are_final`
+//
+// The cache is filled without a lock. That is only safe while a single thread fills it,
+// so `ir_print_procs_parallel` fills it for every type its workers will need first and
+// sets `type_layouts_are_frozen` whilst they run, during which nothing may be added
+gb_global bool type_layouts_are_final  = false;
+gb_global bool type_layouts_are_frozen = false;
+
+bool type_cache_layout(gbAllocator allocator, Type *t) {
+	if (t->layout_cached) {
+		return true;
+	}
+	if (!type_layouts_are_final || t->failure) {
+		return false;
+	}
+	TypePath path = {0};
+	type_path_init(&path);
+	i64 size  = type_size_of_internal(allocator, t, &path);
+	i64 align = type_align_of_internal(allocator, t, &path);
+	bool ok = !path.failure;
+	type_path_free(&path);
+	if (!ok || t->failure) {
+		return false;
+	}
+	GB_ASSERT_MSG(!type_layouts_are_frozen, "The layout of %s was not cached before the workers started", type_to_string(t));
+	t->cached_size   = size;
+	t->cached_align  = align;
+	t->layout_cached = true;
+	return true;
+}
+
 i64 type_size_of(gbAllocator allocator, Type *t) {
 	if (t == NULL) {
 		return 0;
 	}
+	if (type_cache_layout(allocator, t)) {
+		return t->cached_size;
+	}
 	i64 size;
 	TypePath path = {0};
 	type_path_init(&path);
@@ -1591,6 +2022,9 @@ i64 type_align_of(gbAllocator allocator, Type *t) {
 	if (t == NULL) {
 		return 1;
 	}
+	if (type_cache_layout(allocator, t)) {
+		return t->cached_align;
+	}
 	i64 align;
 	TypePath path = {0};
 	type_path_init(&path);
@@ -1604,6 +2038,9 @@ i64 type_align_of_internal(gbAllocator allocator, Type *t, TypePath *path) {
 	if (t->failure) {
 		return FAILURE_ALIGNMENT;
 	}
+	if (t->layout_cached) {
+		return t->cached_align;
+	}
 	t = base_type(t);
 
 	switch (t->kind) {
@@ -1798,6 +2235,9 @@ i64 type_size_of_internal(gbAllocator allocator, Type *t, TypePath *path) {
 	if (t->failure) {
 		return FAILURE_SIZE;
 	}
+	if (t->layout_cached) {
+		return t->cached_size;
+	}
 	t = base_type(t);
 	switch (t->kind) {
 	case Type_Basic: {
@@ -2001,7 +2441,7 @@ i64 type_offset_of_from_selection(gbAllocator allocator, Type *type, Selection s
 	Type *t = type;
 	i64 offset = 0;
 	for_array(i, sel.index) {
-		isize index = sel.index.e[i];
+		isize index = selection_index(&sel, i);
 		t = base_type(t);
 		offset += type_offset_of(allocator, t, index);
 		if (t->kind == Type_Record && t->Record.kind == TypeRecord_Struct) {